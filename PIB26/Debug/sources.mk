@@ -28,6 +28,9 @@ src/bignum/bigfloat \
 src/bignum/bigint \
 src/bignum/multiplication \
 src/bignum/multiplication/FFT/complex \
+src/bignum/multiplication/FFT/complex/avx2 \
+src/bignum/multiplication/FFT/complex/avx512 \
+src/bignum/multiplication/FFT/modular \
 src/bignum/newton \
 src/bignum/primitives \
 src/pi/bsp \
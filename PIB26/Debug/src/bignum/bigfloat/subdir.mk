@@ -10,6 +10,7 @@ CPP_SRCS += \
 ../src/bignum/bigfloat/divsm.cpp \
 ../src/bignum/bigfloat/mul.cpp \
 ../src/bignum/bigfloat/mulsm.cpp \
+../src/bignum/bigfloat/residual.cpp \
 ../src/bignum/bigfloat/sub.cpp \
 ../src/bignum/bigfloat/uadd.cpp \
 ../src/bignum/bigfloat/uassign.cpp \
@@ -26,6 +27,7 @@ OBJS += \
 ./src/bignum/bigfloat/divsm.o \
 ./src/bignum/bigfloat/mul.o \
 ./src/bignum/bigfloat/mulsm.o \
+./src/bignum/bigfloat/residual.o \
 ./src/bignum/bigfloat/sub.o \
 ./src/bignum/bigfloat/uadd.o \
 ./src/bignum/bigfloat/uassign.o \
@@ -42,6 +44,7 @@ CPP_DEPS += \
 ./src/bignum/bigfloat/divsm.d \
 ./src/bignum/bigfloat/mul.d \
 ./src/bignum/bigfloat/mulsm.d \
+./src/bignum/bigfloat/residual.d \
 ./src/bignum/bigfloat/sub.d \
 ./src/bignum/bigfloat/uadd.d \
 ./src/bignum/bigfloat/uassign.d \
@@ -0,0 +1,24 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/bignum/multiplication/FFT/complex/avx512/avx512Butterflies.cpp 
+
+OBJS += \
+./src/bignum/multiplication/FFT/complex/avx512/avx512Butterflies.o 
+
+CPP_DEPS += \
+./src/bignum/multiplication/FFT/complex/avx512/avx512Butterflies.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/bignum/multiplication/FFT/complex/avx512/%.o: ../src/bignum/multiplication/FFT/complex/avx512/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -O0 -g3 -Wall -c -fmessage-length=0 -mavx512f -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -5,30 +5,42 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../src/bignum/multiplication/FFT/complex/ComplexFft.cpp \
-../src/bignum/multiplication/FFT/complex/genOmegaTable.cpp \
+../src/bignum/multiplication/FFT/complex/FftPlanner.cpp \
+../src/bignum/multiplication/FFT/complex/TwiddleTable.cpp \
+../src/bignum/multiplication/FFT/complex/butterflies.cpp \
+../src/bignum/multiplication/FFT/complex/fourStep.cpp \
 ../src/bignum/multiplication/FFT/complex/rad2Itr.cpp \
 ../src/bignum/multiplication/FFT/complex/rad2Rec.cpp \
 ../src/bignum/multiplication/FFT/complex/rad3Rec.cpp \
 ../src/bignum/multiplication/FFT/complex/rad4Itr.cpp \
-../src/bignum/multiplication/FFT/complex/rad4Rec.cpp 
+../src/bignum/multiplication/FFT/complex/rad4Rec.cpp \
+../src/bignum/multiplication/FFT/complex/rad5Rec.cpp 
 
 OBJS += \
 ./src/bignum/multiplication/FFT/complex/ComplexFft.o \
-./src/bignum/multiplication/FFT/complex/genOmegaTable.o \
+./src/bignum/multiplication/FFT/complex/FftPlanner.o \
+./src/bignum/multiplication/FFT/complex/TwiddleTable.o \
+./src/bignum/multiplication/FFT/complex/butterflies.o \
+./src/bignum/multiplication/FFT/complex/fourStep.o \
 ./src/bignum/multiplication/FFT/complex/rad2Itr.o \
 ./src/bignum/multiplication/FFT/complex/rad2Rec.o \
 ./src/bignum/multiplication/FFT/complex/rad3Rec.o \
 ./src/bignum/multiplication/FFT/complex/rad4Itr.o \
-./src/bignum/multiplication/FFT/complex/rad4Rec.o 
+./src/bignum/multiplication/FFT/complex/rad4Rec.o \
+./src/bignum/multiplication/FFT/complex/rad5Rec.o 
 
 CPP_DEPS += \
 ./src/bignum/multiplication/FFT/complex/ComplexFft.d \
-./src/bignum/multiplication/FFT/complex/genOmegaTable.d \
+./src/bignum/multiplication/FFT/complex/FftPlanner.d \
+./src/bignum/multiplication/FFT/complex/TwiddleTable.d \
+./src/bignum/multiplication/FFT/complex/butterflies.d \
+./src/bignum/multiplication/FFT/complex/fourStep.d \
 ./src/bignum/multiplication/FFT/complex/rad2Itr.d \
 ./src/bignum/multiplication/FFT/complex/rad2Rec.d \
 ./src/bignum/multiplication/FFT/complex/rad3Rec.d \
 ./src/bignum/multiplication/FFT/complex/rad4Itr.d \
-./src/bignum/multiplication/FFT/complex/rad4Rec.d 
+./src/bignum/multiplication/FFT/complex/rad4Rec.d \
+./src/bignum/multiplication/FFT/complex/rad5Rec.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
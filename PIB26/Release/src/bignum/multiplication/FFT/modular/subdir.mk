@@ -0,0 +1,30 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/bignum/multiplication/FFT/modular/ModularFft.cpp \
+../src/bignum/multiplication/FFT/modular/genRootTable.cpp \
+../src/bignum/multiplication/FFT/modular/nttItr.cpp 
+
+OBJS += \
+./src/bignum/multiplication/FFT/modular/ModularFft.o \
+./src/bignum/multiplication/FFT/modular/genRootTable.o \
+./src/bignum/multiplication/FFT/modular/nttItr.o 
+
+CPP_DEPS += \
+./src/bignum/multiplication/FFT/modular/ModularFft.d \
+./src/bignum/multiplication/FFT/modular/genRootTable.d \
+./src/bignum/multiplication/FFT/modular/nttItr.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/bignum/multiplication/FFT/modular/%.o: ../src/bignum/multiplication/FFT/modular/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -DNDEBUG -O3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
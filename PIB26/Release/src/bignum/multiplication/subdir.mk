@@ -8,21 +8,36 @@ CPP_SRCS += \
 ../src/bignum/multiplication/FFT.cpp \
 ../src/bignum/multiplication/FlexMul2.cpp \
 ../src/bignum/multiplication/FlexMul3.cpp \
-../src/bignum/multiplication/SmallKaratsuba.cpp 
+../src/bignum/multiplication/FlexMulN.cpp \
+../src/bignum/multiplication/FlexTuner.cpp \
+../src/bignum/multiplication/NTT.cpp \
+../src/bignum/multiplication/SSA.cpp \
+../src/bignum/multiplication/SmallKaratsuba.cpp \
+../src/bignum/multiplication/ToomCook.cpp 
 
 OBJS += \
 ./src/bignum/multiplication/ClassicalSmallMul.o \
 ./src/bignum/multiplication/FFT.o \
 ./src/bignum/multiplication/FlexMul2.o \
 ./src/bignum/multiplication/FlexMul3.o \
-./src/bignum/multiplication/SmallKaratsuba.o 
+./src/bignum/multiplication/FlexMulN.o \
+./src/bignum/multiplication/FlexTuner.o \
+./src/bignum/multiplication/NTT.o \
+./src/bignum/multiplication/SSA.o \
+./src/bignum/multiplication/SmallKaratsuba.o \
+./src/bignum/multiplication/ToomCook.o 
 
 CPP_DEPS += \
 ./src/bignum/multiplication/ClassicalSmallMul.d \
 ./src/bignum/multiplication/FFT.d \
 ./src/bignum/multiplication/FlexMul2.d \
 ./src/bignum/multiplication/FlexMul3.d \
-./src/bignum/multiplication/SmallKaratsuba.d 
+./src/bignum/multiplication/FlexMulN.d \
+./src/bignum/multiplication/FlexTuner.d \
+./src/bignum/multiplication/NTT.d \
+./src/bignum/multiplication/SSA.d \
+./src/bignum/multiplication/SmallKaratsuba.d \
+./src/bignum/multiplication/ToomCook.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
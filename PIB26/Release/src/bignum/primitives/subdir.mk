@@ -7,6 +7,7 @@ CPP_SRCS += \
 ../src/bignum/primitives/add.cpp \
 ../src/bignum/primitives/addsm.cpp \
 ../src/bignum/primitives/assign.cpp \
+../src/bignum/primitives/comba.cpp \
 ../src/bignum/primitives/compare.cpp \
 ../src/bignum/primitives/divsm.cpp \
 ../src/bignum/primitives/muladd.cpp \
@@ -18,6 +19,7 @@ OBJS += \
 ./src/bignum/primitives/add.o \
 ./src/bignum/primitives/addsm.o \
 ./src/bignum/primitives/assign.o \
+./src/bignum/primitives/comba.o \
 ./src/bignum/primitives/compare.o \
 ./src/bignum/primitives/divsm.o \
 ./src/bignum/primitives/muladd.o \
@@ -29,6 +31,7 @@ CPP_DEPS += \
 ./src/bignum/primitives/add.d \
 ./src/bignum/primitives/addsm.d \
 ./src/bignum/primitives/assign.d \
+./src/bignum/primitives/comba.d \
 ./src/bignum/primitives/compare.d \
 ./src/bignum/primitives/divsm.d \
 ./src/bignum/primitives/muladd.d \
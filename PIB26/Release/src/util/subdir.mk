@@ -6,6 +6,8 @@
 CPP_SRCS += \
 ../src/util/DotsTicker.cpp \
 ../src/util/LabelTicker.cpp \
+../src/util/ThreadPool.cpp \
+../src/util/cacheInfo.cpp \
 ../src/util/printB26.cpp \
 ../src/util/timer.cpp \
 ../src/util/userInput.cpp 
@@ -13,6 +15,8 @@ CPP_SRCS += \
 OBJS += \
 ./src/util/DotsTicker.o \
 ./src/util/LabelTicker.o \
+./src/util/ThreadPool.o \
+./src/util/cacheInfo.o \
 ./src/util/printB26.o \
 ./src/util/timer.o \
 ./src/util/userInput.o 
@@ -20,6 +24,8 @@ OBJS += \
 CPP_DEPS += \
 ./src/util/DotsTicker.d \
 ./src/util/LabelTicker.d \
+./src/util/ThreadPool.d \
+./src/util/cacheInfo.d \
 ./src/util/printB26.d \
 ./src/util/timer.d \
 ./src/util/userInput.d 
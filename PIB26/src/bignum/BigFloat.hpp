@@ -33,6 +33,7 @@
 #include "../util/ITicker.hpp"
 
 #include <cstddef>
+#include <functional>
 #include <string>
 #include <memory>
 
@@ -50,6 +51,7 @@ namespace SDF::Newton
 namespace SDF::Bignum
 {
 	class IMultiplicationStrategy;
+	class PreparedOperand;
 	class BigInt;
 
 	// Class:      BigFloat
@@ -173,7 +175,8 @@ namespace SDF::Bignum
 			void mul(const BigFloat &num1, const BigFloat &num2, IMultiplicationStrategy &strategy);
 
 			// Function:   sqr
-			// Purpose:    Squares a BigFloat.
+			// Purpose:    Squares a BigFloat, which takes less work than multiplying it by another.
+			//             mul does this itself when its operands are the same number.
 			// Parameters: num - The operand to square.
 			//             strategy - THe multiplication strategy to use.
 			// Returns:    None.
@@ -188,6 +191,29 @@ namespace SDF::Bignum
 			// Returns:    None.
 			void mul(const BigFloat &num1, const BigInt &num2, IMultiplicationStrategy &strategy);
 
+			// Function:   mul
+			// Purpose:    Multiplies a BigFloat by a BigInt, one of which has been prepared with
+			//             prepare. Note: this also works in-place, but the prepared operand must not
+			//             be used again once it has been overwritten.
+			// Parameters: num1 - The first operand to mul.
+			//             num2 - The BigInt to multiply by.
+			//             prepared - The prepared version of one of the operands. If it is of
+			//                        neither, the operands are multiplied the ordinary way.
+			//             strategy - The multiplication strategy (algorithm) it was prepared with.
+			// Returns:    None.
+			void mul(const BigFloat &num1, const BigInt &num2, PreparedOperand &prepared,
+				IMultiplicationStrategy &strategy);
+
+			// Function:   prepare
+			// Purpose:    Get this BigFloat ready to be multiplied by several others, so that the
+			//             multiplication strategy need only do the work common to them, like
+			//             transforming it, once. It must not be changed while it is prepared.
+			// Parameters: strategy - The multiplication strategy (algorithm) to use.
+			//             maxOtherLen - The most digits any of the others will have.
+			// Returns:    The prepared operand, for mul. It must not outlive the strategy.
+			std::unique_ptr<PreparedOperand> prepare(IMultiplicationStrategy &strategy,
+				std::size_t maxOtherLen) const;
+
 			// Function:   mul
 			// Purpose:    Multiplies a BigFloat by a small number.
 			// Parameters: num1 - The BigFloat to mul.
@@ -250,6 +276,10 @@ namespace SDF::Bignum
 			// Declares how much extra "slop" precision to keep around to buffer rounding errors.
 			static const std::size_t GUARD_PREC = 1;
 
+			// Declares how many digits below the bottom of a product's fraction to keep of each
+			// factor; the rest are dropped before multiplying, as they hardly touch it.
+			static const std::size_t MUL_GUARD_DIGITS = 2;
+
 			Sign m_sign;
 			std::ptrdiff_t m_exp;
 
@@ -298,8 +328,60 @@ namespace SDF::Bignum
 			void umul(const BigFloat &num1, const BigFloat &num2, IMultiplicationStrategy &strategy);
 			void usqr(const BigFloat &num, IMultiplicationStrategy &strategy);
 			void umul(const BigFloat &num1, const BigInt &num2, IMultiplicationStrategy &strategy);
+			void umul(const BigFloat &num1, const BigInt &num2, PreparedOperand &prepared,
+				IMultiplicationStrategy &strategy);
 			void umul(const BigFloat &num1, unsigned int smallNum);
 
+			// Function:   residual
+			// Purpose:    Compute 1 - num1 * num2, where the product is positive and known to agree
+			//             with 1 to within knownLen digits, i.e. to be within BASE^-knownLen of it, as
+			//             in Newton iterations. Only the part of the product below those digits is
+			//             worked out, with a wrapped multiply. Should they not agree after all, the
+			//             full product is worked out instead. The result is correct to the last digit
+			//             this BigFloat has for a number of the bound's size.
+			// Parameters: num1 - The first operand.
+			//             num2 - The second operand.
+			//             knownLen - How many digits the product is known to agree with 1 to.
+			//             strategy - The multiplication strategy (algorithm) to use.
+			// Returns:    None.
+			void residual(const BigFloat &num1, const BigFloat &num2, std::size_t knownLen,
+				IMultiplicationStrategy &strategy);
+
+			// Function:   mulProduct
+			// Purpose:    Multiply two digit buffer segments, taking the product as the fraction of
+			//             this BigFloat as takeProduct does. The exponent must already be set for
+			//             a product whose top digit is zero. Only the top of the product is
+			//             worked out (see IMultiplicationStrategy::mulDigitsHighInto), from the
+			//             top MUL_GUARD_DIGITS more digits of each segment than the fraction has.
+			//             The digits dropped and the short product may each take one off the
+			//             fraction, so it may come out up to two short in its lowest digit.
+			// Parameters: a, aLen - The first segment and its length.
+			//             b, bLen - The second segment and its length.
+			//             strategy - The multiplication strategy to use.
+			// Returns:    None.
+			void mulProduct(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen, IMultiplicationStrategy &strategy);
+
+			// Function:   overlaps
+			// Purpose:    Check whether the fraction of this BigFloat overlaps a digit buffer
+			//             segment, so that a product of it cannot be put straight into place.
+			// Parameters: digits, len - The segment and its length.
+			// Returns:    Whether it does.
+			bool overlaps(Memory::SafePtr<Digit> digits, std::size_t len) const;
+
+			// Function:   takeProduct
+			// Purpose:    Take the top of a product as the fraction of this BigFloat, keeping as
+			//             much of it as fits, and adjust the exponent.
+			// Parameters: overlap - Whether this overlaps a factor, so that the product must go
+			//                       through a buffer of its own first.
+			//             fullLen - The length of the product were its top digit nonzero.
+			//             mul - Called as mul(dst) to put the product into the m_totalLen digits at
+			//                   dst as a strategy's mulDigitsInto does with keepTop set, returning
+			//                   its length.
+			// Returns:    None.
+			void takeProduct(bool overlap, std::size_t fullLen,
+				const std::function<std::size_t(Memory::SafePtr<Digit>)> &mul);
+
 			void umulIp(unsigned int smallNum);
 
 			void udiv(const BigFloat &num1, unsigned int smallNum);
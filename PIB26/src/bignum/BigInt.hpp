@@ -36,6 +36,7 @@
 namespace SDF::Bignum
 {
 	class IMultiplicationStrategy;
+	class PreparedOperand;
 	class BigFloat;
 
 	// Class:      BigInt
@@ -149,6 +150,37 @@ namespace SDF::Bignum
 			// Returns:    None.
 			void mul(const BigInt &num1, const BigInt &num2, IMultiplicationStrategy &strategy);
 
+			// Function:   sqr
+			// Purpose:    Squares a BigInt, which takes less work than multiplying it by another.
+			//             mul does this itself when its operands are the same number.
+			// Parameters: num - The operand to square.
+			//             strategy - The multiplication strategy (algorithm) to use.
+			// Returns:    None.
+			void sqr(const BigInt &num, IMultiplicationStrategy &strategy);
+
+			// Function:   mul
+			// Purpose:    Multiplies two BigInts together, one of which has been prepared with
+			//             prepare. Note: this also works in-place, but the prepared operand must not
+			//             be used again once it has been overwritten.
+			// Parameters: num1 - The first operand to mul.
+			//             num2 - The second operand to mul.
+			//             prepared - The prepared version of one of the operands. If it is of
+			//                        neither, the operands are multiplied the ordinary way.
+			//             strategy - The multiplication strategy (algorithm) it was prepared with.
+			// Returns:    None.
+			void mul(const BigInt &num1, const BigInt &num2, PreparedOperand &prepared,
+				IMultiplicationStrategy &strategy);
+
+			// Function:   prepare
+			// Purpose:    Get this BigInt ready to be multiplied by several others, so that the
+			//             multiplication strategy need only do the work common to them, like
+			//             transforming it, once. It must not be changed while it is prepared.
+			// Parameters: strategy - The multiplication strategy (algorithm) to use.
+			//             maxOtherLen - The most digits any of the others will have.
+			// Returns:    The prepared operand, for mul. It must not outlive the strategy.
+			std::unique_ptr<PreparedOperand> prepare(IMultiplicationStrategy &strategy,
+				std::size_t maxOtherLen) const;
+
 			// Function:   mul
 			// Purpose:    Multiplies a BigInt by a small number.
 			// Parameters: num1 - The BigInt to mul.
@@ -204,8 +236,25 @@ namespace SDF::Bignum
 			void usubIp(const BigInt &num);
 
 			void umul(const BigInt &num1, const BigInt &num2, IMultiplicationStrategy &strategy);
+			void usqr(const BigInt &num, IMultiplicationStrategy &strategy);
+			void umul(const BigInt &num1, const BigInt &num2, PreparedOperand &prepared,
+				IMultiplicationStrategy &strategy);
 			void umul(const BigInt &num1, unsigned int smallNum);
 
+			// Function:   overlapsFactor
+			// Purpose:    Check whether the buffer of this BigInt overlaps either factor of a
+			//             product, so that the product cannot be put straight into it.
+			// Parameters: num1, num2 - The factors.
+			// Returns:    Whether it does.
+			bool overlapsFactor(const BigInt &num1, const BigInt &num2) const;
+
+			// Function:   settleProduct
+			// Purpose:    Set the length and sign of this BigInt for a product a multiplication
+			//             strategy has just put into its buffer.
+			// Parameters: prodLen - The length of the product, as the strategy gave it.
+			// Returns:    None.
+			void settleProduct(std::size_t prodLen);
+
 			void umulIp(unsigned int smallNum);
 
 			void udiv(const BigInt &num1, unsigned int smallNum);
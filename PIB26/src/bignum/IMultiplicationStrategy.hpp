@@ -26,54 +26,235 @@
 #define SRC_BIGNUM_IMULTIPLICATIONSTRATEGY_HPP_
 
 #include "defs.hpp"
+#include "PreparedOperand.hpp"
 
 #include "../memory/SafePtr.hpp"
+#include "../memory/buffers/local/ScratchPool.hpp"
 
 #include <cstddef>
+#include <memory>
 
 namespace SDF::Bignum
 {
 	// Class:      IMultiplicationStrategy
 	// Purpose:    Defines an interface for multiplication strategies - different multiplication
-	//             algorithm implementations.
+	//             algorithm implementations. A strategy keeps nothing between calls but what does
+	//             not change, like tables of roots of unity, and takes its scratch space for each
+	//             call from a pool, so it may be used from several threads at once.
 	// Parameters: None.
 	class IMultiplicationStrategy
 	{
 		public:
 			virtual ~IMultiplicationStrategy() = default;
 
-			// Function:   mulDigits
-			// Purpose:    Multiply two digit buffer segments.
-			// Parameters: a - The pointer to the beginning of the first digit segment.
+			// Function:   mulDigitsInto
+			// Purpose:    Multiply two digit buffer segments, putting the product into a buffer.
+			//             The buffer need not hold the whole product: if it is too short, only the
+			//             bottom dstLen digits of the product are put in it, as for an integer that
+			//             overflows, or, if keepTop is set, the top dstLen, as for a floating-point
+			//             fraction. If it is longer, the product goes at the bottom, or with keepTop,
+			//             at the top with zeroes below it; without keepTop, all aLen + bLen digits
+			//             at the bottom are set, the top one to zero if the product is a digit
+			//             shorter, and those past them are left as they were. The buffer must not
+			//             overlap either segment.
+			// Parameters: dst - The pointer to the beginning of the buffer to put the product in.
+			//             dstLen - The length of the buffer in digits.
+			//             keepTop - Whether to keep the top of the product rather than the bottom.
+			//             a - The pointer to the beginning of the first digit segment.
 			//             aLen - The length of the first segment in digits.
 			//             b - The pointer to the beginning of the second digit segment.
 			//             bLen - The length of the second segment in digits.
-			// Returns:    None.
-			virtual void mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen,
-				Memory::SafePtr<Digit> b, std::size_t bLen) = 0;
-
-			// Function:   squareDigits
-			// Purpose:    Square a digit buffer segment. Squaring can often be done more quickly than
-			//             general multiplication.
-			// Parameters: a - The pointer to the digit segment to square.
+			// Returns:    The length of the product in digits: aLen + bLen, or one less if the top
+			//             digit would be zero.
+			virtual std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen) = 0;
+
+			// Function:   squareDigitsInto
+			// Purpose:    Square a digit buffer segment, putting the square into a buffer as
+			//             mulDigitsInto does. Squaring can often be done more quickly than general
+			//             multiplication.
+			// Parameters: dst, dstLen, keepTop - As for mulDigitsInto.
+			//             a - The pointer to the digit segment to square.
+			//             aLen - The length of the segment in digits.
+			// Returns:    The length of the square in digits.
+			virtual std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen) = 0;
+
+			// Function:   mulDigitsHighInto
+			// Purpose:    Multiply two digit buffer segments, putting the top of the product into a
+			//             buffer as mulDigitsInto with keepTop does, but allowing the digits kept to
+			//             come out one less, in the lowest of them, than the true product's. A
+			//             strategy may then leave out the partial products that land far enough
+			//             below the digits kept (a "short product"), which when the buffer is about
+			//             as long as the factors, as for a floating-point product, saves a good part
+			//             of the work. By default the full product is worked out.
+			// Parameters: dst - The pointer to the beginning of the buffer to put the product in.
+			//             dstLen - The length of the buffer in digits.
+			//             a - The pointer to the beginning of the first digit segment.
+			//             aLen - The length of the first segment in digits.
+			//             b - The pointer to the beginning of the second digit segment.
+			//             bLen - The length of the second segment in digits.
+			// Returns:    The length of the product in digits, as for mulDigitsInto.
+			virtual std::size_t mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen)
+			{
+				return mulDigitsInto(dst, dstLen, true, a, aLen, b, bLen);
+			}
+
+			// Function:   mulDigitsWrappedInto
+			// Purpose:    Multiply two digit buffer segments, letting the top of the product wrap
+			//             around onto the bottom, as though modulo BASE^wrapLen + 1 (or any larger
+			//             modulus of that form). This only gets the middle of the product: the
+			//             digits from (aLen + bLen - wrapLen + 1) up to wrapLen are those of the
+			//             full product, less perhaps a borrow into the lowest of them, and the rest
+			//             are not to be relied on. When what the top of the product is is already
+			//             known, as in Newton iterations, this is all that is needed, and it takes a
+			//             shorter transform than the full product. By default the full product is
+			//             worked out. The bottom of the result is put into the buffer as by
+			//             mulDigitsInto without keepTop.
+			// Parameters: dst - The pointer to the beginning of the buffer to put the result in.
+			//             dstLen - The length of the buffer in digits.
+			//             a - The pointer to the beginning of the first digit segment.
+			//             aLen - The length of the first segment in digits.
+			//             b - The pointer to the beginning of the second digit segment.
+			//             bLen - The length of the second segment in digits.
+			//             wrapLen - The length in digits to wrap the product at.
+			// Returns:    The length of the result in digits: at least wrapLen, or the full
+			//             product's length if that is less.
+			virtual std::size_t mulDigitsWrappedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen, std::size_t wrapLen)
+			{
+				return mulDigitsInto(dst, dstLen, false, a, aLen, b, bLen);
+			}
+
+			// Function:   prepareOperand
+			// Purpose:    Get a digit buffer segment ready to be multiplied by several others, so
+			//             that work on it common to all the products, like transforming it, is only
+			//             done once. By default there is nothing to prepare.
+			// Parameters: a - The pointer to the beginning of the digit segment.
 			//             aLen - The length of the segment in digits.
-			// Returns:    None.
-			virtual void squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen) = 0;
-
-			// Function:   getProductLength
-			// Purpose:    Get the length of a computed product in digits.
-			// Parameters: None.
-			// Returns:    The length.
-			virtual std::size_t getProductLength() const = 0;
-
-			// Function:   getProductDigits
-			// Purpose:    Extract the digits of a computed product.
-			// Parameters: dst - Pointer into the destination buffer.
-			//             origin - The index of the least-significant digit to extract.
-			//             length - The number of digits to extract.
-			// Returns:    None.
-			virtual void getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin,
-				std::size_t length) = 0;
+			//             maxOtherLen - The length of the longest segment it will be multiplied by.
+			// Returns:    The prepared operand. It must not outlive this strategy.
+			virtual std::unique_ptr<PreparedOperand> prepareOperand(Memory::SafePtr<Digit> a,
+				std::size_t aLen, std::size_t maxOtherLen)
+			{
+				return std::make_unique<PreparedOperand>(a, aLen);
+			}
+
+			// Function:   mulPreparedInto
+			// Purpose:    Multiply a prepared operand by a digit buffer segment, putting the product
+			//             into a buffer as mulDigitsInto does. If the operand was not prepared by
+			//             this strategy, or not for a segment this long, it is multiplied the
+			//             ordinary way. The operand is only read, so it may be used by several
+			//             threads at once.
+			// Parameters: dst, dstLen, keepTop - As for mulDigitsInto.
+			//             a - The prepared operand.
+			//             b - The pointer to the beginning of the other digit segment.
+			//             bLen - The length of the other segment in digits.
+			// Returns:    The length of the product in digits.
+			virtual std::size_t mulPreparedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, const PreparedOperand &a, Memory::SafePtr<Digit> b, std::size_t bLen)
+			{
+				return mulDigitsInto(dst, dstLen, keepTop, a.getDigits(), a.getLength(), b, bLen);
+			}
+		protected:
+			// The number of columns of partial products below the lowest digit a short product
+			// might keep that it still sums, so that, as long as neither factor is BASE digits
+			// long, what it leaves out comes to less than one in that digit.
+			static constexpr std::size_t SHORT_GUARD_COLUMNS = 2;
+
+			// Function:   shortProductCut
+			// Purpose:    Find the lowest column of partial products a short product must sum.
+			// Parameters: dstLen - The length of the buffer it goes in.
+			//             fullLen - The length of the product were its top digit nonzero. It must
+			//                       be more than dstLen.
+			// Returns:    The column, or zero for all of them.
+			static std::size_t shortProductCut(std::size_t dstLen, std::size_t fullLen)
+			{
+				// The lowest digit kept is at fullLen - dstLen - 1 if the top digit is zero.
+				std::size_t lowest(fullLen - dstLen - 1);
+				return (lowest > SHORT_GUARD_COLUMNS) ? lowest - SHORT_GUARD_COLUMNS : 0;
+			}
+
+			// Function:   placeProduct
+			// Purpose:    Settle a product worked out straight into a buffer that holds it whole,
+			//             as mulDigitsInto puts it. It must have been put at the bottom of the
+			//             buffer, or with keepTop, at the top; if its top digit is zero, it is moved
+			//             up one for keepTop, and the digits below it are zeroed.
+			// Parameters: dst, dstLen, keepTop - As for mulDigitsInto.
+			//             fullLen - The length of the product were its top digit nonzero. It must
+			//                       be no more than dstLen.
+			// Returns:    The length of the product.
+			static std::size_t placeProduct(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, std::size_t fullLen)
+			{
+				Memory::SafePtr<Digit> prod(keepTop ? dst + (dstLen - fullLen) : dst);
+				std::size_t prodLen(((fullLen > 0) && (prod[fullLen - 1] == 0)) ? fullLen - 1 :
+					fullLen);
+
+				if (keepTop) {
+					if (prodLen < fullLen) {
+						for (std::size_t i(prodLen); i > 0; --i) {
+							prod[i] = prod[i - 1];
+						}
+					}
+
+					for (std::size_t i(0); i < dstLen - prodLen; ++i) {
+						dst[i] = 0;
+					}
+				}
+
+				return prodLen;
+			}
+
+			// Function:   cropProduct
+			// Purpose:    Copy the part of a product worked out elsewhere that a buffer too short
+			//             for it takes, as mulDigitsInto puts it.
+			// Parameters: dst, dstLen, keepTop - As for mulDigitsInto.
+			//             prod - The pointer to the beginning of the product.
+			//             fullLen - The length of the product were its top digit nonzero. It must
+			//                       be more than dstLen.
+			// Returns:    The length of the product.
+			static std::size_t cropProduct(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<const Digit> prod, std::size_t fullLen)
+			{
+				std::size_t prodLen((prod[fullLen - 1] == 0) ? fullLen - 1 : fullLen);
+				std::size_t origin(keepTop ? prodLen - dstLen : 0);
+				for (std::size_t i(0); i < dstLen; ++i) {
+					dst[i] = prod[origin + i];
+				}
+
+				return prodLen;
+			}
+
+			// Function:   putProduct
+			// Purpose:    Work out a product and put it into a buffer as mulDigitsInto puts it:
+			//             straight into the buffer if it holds the whole product, or else into
+			//             scratch borrowed from a pool, from which the part wanted is copied.
+			// Parameters: pool - The pool to borrow the scratch from.
+			//             dst, dstLen, keepTop - As for mulDigitsInto.
+			//             fullLen - The length of the product were its top digit nonzero.
+			//             work - Called as work(prod) to work out the product into the fullLen
+			//                    digits at prod.
+			// Returns:    The length of the product.
+			template<class Work>
+			static std::size_t putProduct(Memory::Buffers::Local::ScratchPool &pool,
+				Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				std::size_t fullLen, Work work)
+			{
+				if (fullLen <= dstLen) {
+					work(keepTop ? dst + (dstLen - fullLen) : dst);
+					return placeProduct(dst, dstLen, keepTop, fullLen);
+				}
+
+				auto prod(pool.borrow<Digit>(fullLen));
+				work(prod.accessData(0));
+
+				return cropProduct(dst, dstLen, keepTop, prod.accessData(0), fullLen);
+			}
 	};
 }
 
@@ -0,0 +1,92 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      PreparedOperand.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_PREPAREDOPERAND_HPP_
+#define SRC_BIGNUM_PREPAREDOPERAND_HPP_
+
+#include "defs.hpp"
+
+#include "../memory/SafePtr.hpp"
+
+#include <cstddef>
+
+namespace SDF::Bignum
+{
+	// Class:      PreparedOperand
+	// Purpose:    A handle to an operand a multiplication strategy has got ready to be multiplied by
+	//             several others, e.g. by transforming it once instead of for every product. This
+	//             base just keeps the digits, which is all a strategy with nothing to prepare needs,
+	//             and lets any strategy fall back to an ordinary multiply; strategies that can do
+	//             better derive from it. The digits must not change while the handle is in use.
+	// Parameters: None.
+	class PreparedOperand
+	{
+		public:
+			// Function:   PreparedOperand
+			// Purpose:    Construct a handle to a digit buffer segment.
+			// Parameters: digits - The pointer to the beginning of the digit segment.
+			//             len - The length of the segment in digits.
+			PreparedOperand(Memory::SafePtr<Digit> digits, std::size_t len)
+				: m_digits(digits), m_len(len)
+			{
+			}
+
+			virtual ~PreparedOperand() = default;
+
+			// Function:   getDigits
+			// Purpose:    Get the digits of the operand.
+			// Parameters: None.
+			// Returns:    The pointer to the beginning of the digit segment.
+			Memory::SafePtr<Digit> getDigits() const
+			{
+				return m_digits;
+			}
+
+			// Function:   getLength
+			// Purpose:    Get the length of the operand.
+			// Parameters: None.
+			// Returns:    The length of the segment in digits.
+			std::size_t getLength() const
+			{
+				return m_len;
+			}
+
+			// Function:   isOf
+			// Purpose:    Check whether this is a handle to a given digit buffer segment.
+			// Parameters: digits - The pointer to the beginning of the digit segment.
+			//             len - The length of the segment in digits.
+			// Returns:    Whether it is.
+			bool isOf(Memory::SafePtr<Digit> digits, std::size_t len) const
+			{
+				// Compare the addresses, not the pointers, as these may well be into different
+				// buffers.
+				return (len == m_len) && (&*digits == &*m_digits);
+			}
+		private:
+			Memory::SafePtr<Digit> m_digits;
+			std::size_t m_len;
+	};
+}
+
+#endif /* SRC_BIGNUM_PREPAREDOPERAND_HPP_ */
@@ -26,6 +26,8 @@
 
 #include "../BigInt.hpp"
 
+#include "../IMultiplicationStrategy.hpp"
+
 namespace SDF::Bignum
 {
 	void BigFloat::mul(const BigFloat &num1, const BigFloat &num2, IMultiplicationStrategy &strategy)
@@ -45,4 +47,18 @@ namespace SDF::Bignum
 		umul(num1, num2, strategy);
 		m_sign = static_cast<Sign>(n1Sign * n2Sign);
 	}
+
+	void BigFloat::mul(const BigFloat &num1, const BigInt &num2, PreparedOperand &prepared,
+		IMultiplicationStrategy &strategy)
+	{
+		Sign n1Sign(num1.m_sign), n2Sign(num2.m_sign);
+		umul(num1, num2, prepared, strategy);
+		m_sign = static_cast<Sign>(n1Sign * n2Sign);
+	}
+
+	std::unique_ptr<PreparedOperand> BigFloat::prepare(IMultiplicationStrategy &strategy,
+		std::size_t maxOtherLen) const
+	{
+		return strategy.prepareOperand(m_digits, m_totalLen, maxOtherLen);
+	}
 }
@@ -0,0 +1,131 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      residual.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "../BigFloat.hpp"
+
+#include "../IMultiplicationStrategy.hpp"
+
+#include "../primitives/assign.hpp"
+#include "../primitives/compare.hpp"
+#include "../primitives/sub.hpp"
+
+#include "../../exceptions/exceptions.hpp"
+
+#include "../../memory/buffers/local/RAMOnly.hpp"
+
+#include <algorithm>
+
+namespace SDF::Bignum
+{
+	void BigFloat::residual(const BigFloat &num1, const BigFloat &num2, std::size_t knownLen,
+		IMultiplicationStrategy &strategy)
+	{
+		// How many digits past the bound on the residual to work out, so that its sign shows and we
+		// can check the bound holds.
+		static const std::size_t c_guardLen = 2;
+
+		// Treat the operands as integers. Their product is worth BASE^lowExp per unit, so 1 is
+		// BASE^onePos and the residual is BASE^onePos - product, less than BASE^(onePos - knownLen)
+		// in size.
+		std::size_t fullLen(num1.m_totalLen + num2.m_totalLen);
+		std::ptrdiff_t lowExp((num1.m_exp - static_cast<std::ptrdiff_t>(num1.m_totalLen - 1)) +
+			(num2.m_exp - static_cast<std::ptrdiff_t>(num2.m_totalLen - 1)));
+		if ((-lowExp < 0) || (-lowExp > static_cast<std::ptrdiff_t>(fullLen))) {
+			throw SDF::Exceptions::Exception("Residual taken of a product not near one!");
+		}
+
+		std::size_t onePos(-lowExp);
+		if (knownLen > onePos) {
+			knownLen = onePos;
+		}
+
+		// Only the digits from the bound down by our own length are needed. Wrap the product just
+		// above the bound, leaving those clear of the wrapped-around top.
+		std::size_t boundPos(onePos - knownLen);
+		std::size_t first((boundPos > m_totalLen) ? boundPos - m_totalLen : 0);
+		std::size_t wrapLen(std::max(boundPos + c_guardLen, fullLen + 1 - first));
+
+		Memory::Buffers::Local::RAMOnly<Digit> productBuffer(wrapLen);
+		Memory::SafePtr<Digit> product(productBuffer.accessData(0));
+		std::size_t prodLen(0);
+		if (wrapLen < fullLen) {
+			prodLen = strategy.mulDigitsWrappedInto(product, wrapLen, num1.m_digits,
+				num1.m_totalLen, num2.m_digits, num2.m_totalLen, wrapLen);
+		} else {
+			prodLen = strategy.mulDigitsInto(product, wrapLen, false, num1.m_digits,
+				num1.m_totalLen, num2.m_digits, num2.m_totalLen);
+		}
+
+		// Take the digits from first up to the wrap point, less 1 at onePos if it lies below it.
+		// Mod BASE^wrapLen, this leaves minus the residual.
+		std::size_t windowLen(wrapLen - first);
+		Memory::SafePtr<Digit> window(product + first);
+
+		std::size_t have(std::min(prodLen, wrapLen));
+		have = (have > first) ? have - first : 0;
+		Primitives::zeroize(window + have, windowLen - have);
+
+		if (onePos < wrapLen) {
+			Primitives::propagateBorrow(window + (onePos - first), window + (onePos - first), 1,
+				wrapLen - onePos);
+		}
+
+		// The guard digits are all zeroes if the residual is negative and all BASE-1s if positive.
+		// Anything else means the product did not agree with 1 as far as we were told.
+		Digit guard(window[windowLen - 1]);
+		for (std::size_t i(windowLen - c_guardLen); i < windowLen; ++i) {
+			if (((window[i] != 0) && (window[i] != BASE - 1)) || (window[i] != guard)) {
+				if (knownLen == 0) {
+					throw SDF::Exceptions::Exception("Residual taken of a product not near one!");
+				}
+
+				residual(num1, num2, 0, strategy);
+				return;
+			}
+		}
+
+		if (guard == 0) {
+			m_sign = SIGN_NEGATIVE;
+		} else {
+			Primitives::neg(window, window, 0, windowLen);
+			m_sign = SIGN_POSITIVE;
+		}
+
+		// Keep as much of the top as fits.
+		std::size_t signif(Primitives::countSignifDigits(window, windowLen));
+		if (signif == 0) {
+			assign(0);
+			return;
+		}
+
+		if (signif >= m_totalLen) {
+			Primitives::copy(m_digits, window + (signif - m_totalLen), m_totalLen);
+		} else {
+			Primitives::copy(m_digits + (m_totalLen - signif), window, signif);
+			Primitives::zeroize(m_digits, m_totalLen - signif);
+		}
+
+		m_exp = lowExp + static_cast<std::ptrdiff_t>(first + signif - 1);
+	}
+}
@@ -29,52 +29,57 @@
 #include "../IMultiplicationStrategy.hpp"
 
 #include "../primitives/assign.hpp"
+#include "../primitives/compare.hpp"
+
+#include "../../memory/buffers/local/RAMOnly.hpp"
+
+#include <algorithm>
 
 namespace SDF::Bignum
 {
 	void BigFloat::umul(const BigFloat &num1, const BigFloat &num2,
 		IMultiplicationStrategy &strategy)
 	{
+		if (Primitives::sameDigits(num1.m_digits, num1.m_totalLen, num2.m_digits,
+			num2.m_totalLen))
+		{
+			usqr(num1, strategy);
+			return;
+		}
+
 		m_sign = SIGN_POSITIVE;
 		m_exp = num1.m_exp + num2.m_exp;
 
-		strategy.mulDigits(num1.m_digits, num1.m_totalLen, num2.m_digits, num2.m_totalLen);
-		std::size_t prodLen(strategy.getProductLength());
-		if (prodLen <= m_totalLen) {
-			// We can store the whole product.
-			strategy.getProductDigits(m_digits + (m_totalLen - prodLen), 0, prodLen);
-			Primitives::zeroize(m_digits, m_totalLen - prodLen);
-		} else {
-			// We can only store the upper part of the product.
-			strategy.getProductDigits(m_digits, prodLen - m_totalLen, m_totalLen);
-		}
-
-		if (prodLen == num1.m_totalLen + num2.m_totalLen) {
-			++m_exp;
-		}
+		mulProduct(num1.m_digits, num1.m_totalLen, num2.m_digits, num2.m_totalLen, strategy);
 	}
 
 	void BigFloat::usqr(const BigFloat &num, IMultiplicationStrategy &strategy) {
 		m_sign = SIGN_POSITIVE;
 		m_exp = num.m_exp << 1;
 
-		strategy.squareDigits(num.m_digits, num.m_totalLen);
-		std::size_t prodLen(strategy.getProductLength());
-		if (prodLen <= m_totalLen) {
-			// We can store the whole product.
-			strategy.getProductDigits(m_digits + (m_totalLen - prodLen), 0, prodLen);
-			Primitives::zeroize(m_digits, m_totalLen - prodLen);
+		// As in mulProduct, the bottom of the operand hardly touches the square's fraction.
+		std::size_t len(std::min(num.m_totalLen, m_totalLen + MUL_GUARD_DIGITS));
+		Memory::SafePtr<Digit> digits(num.m_digits + (num.m_totalLen - len));
+		takeProduct(overlaps(digits, len), len << 1,
+			[&](Memory::SafePtr<Digit> dst) {
+				return strategy.squareDigitsInto(dst, m_totalLen, true, digits, len);
+			});
+	}
+
+	void BigFloat::umul(const BigFloat &num1, const BigInt &num2, IMultiplicationStrategy &strategy)
+	{
+		m_sign = SIGN_POSITIVE;
+		if (num2.m_digitsUsed == 0) {
+			uassign(0);
 		} else {
-			// We can only store the upper part of the product.
-			strategy.getProductDigits(m_digits, prodLen - m_totalLen, m_totalLen);
-		}
+			m_exp = num1.m_exp + (num2.m_digitsUsed - 1);
 
-		if (prodLen == (num.m_totalLen << 1)) {
-			++m_exp;
+			mulProduct(num1.m_digits, num1.m_totalLen, num2.m_digits, num2.m_digitsUsed, strategy);
 		}
 	}
 
-	void BigFloat::umul(const BigFloat &num1, const BigInt &num2, IMultiplicationStrategy &strategy)
+	void BigFloat::umul(const BigFloat &num1, const BigInt &num2, PreparedOperand &prepared,
+		IMultiplicationStrategy &strategy)
 	{
 		m_sign = SIGN_POSITIVE;
 		if (num2.m_digitsUsed == 0) {
@@ -82,20 +87,67 @@ namespace SDF::Bignum
 		} else {
 			m_exp = num1.m_exp + (num2.m_digitsUsed - 1);
 
-			strategy.mulDigits(num1.m_digits, num1.m_totalLen, num2.m_digits, num2.m_digitsUsed);
-			std::size_t prodLen(strategy.getProductLength());
-			if (prodLen <= m_totalLen) {
-				// We can store the whole product.
-				strategy.getProductDigits(m_digits + (m_totalLen - prodLen), 0, prodLen);
-				Primitives::zeroize(m_digits, m_totalLen - prodLen);
-			} else {
-				// We can only store the upper part of the product.
-				strategy.getProductDigits(m_digits, prodLen - m_totalLen, m_totalLen);
-			}
-
-			if (prodLen == num1.m_totalLen + num2.m_digitsUsed) {
-				++m_exp;
-			}
+			takeProduct(overlaps(num1.m_digits, num1.m_totalLen) ||
+				overlaps(num2.m_digits, num2.m_digitsUsed), num1.m_totalLen + num2.m_digitsUsed,
+				[&](Memory::SafePtr<Digit> dst) {
+					if (prepared.isOf(num1.m_digits, num1.m_totalLen)) {
+						return strategy.mulPreparedInto(dst, m_totalLen, true, prepared,
+							num2.m_digits, num2.m_digitsUsed);
+					} else if (prepared.isOf(num2.m_digits, num2.m_digitsUsed)) {
+						return strategy.mulPreparedInto(dst, m_totalLen, true, prepared,
+							num1.m_digits, num1.m_totalLen);
+					} else {
+						return strategy.mulDigitsInto(dst, m_totalLen, true, num1.m_digits,
+							num1.m_totalLen, num2.m_digits, num2.m_digitsUsed);
+					}
+				});
+		}
+	}
+
+	void BigFloat::mulProduct(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+		std::size_t bLen, IMultiplicationStrategy &strategy)
+	{
+		// The digits of a factor from MUL_GUARD_DIGITS below the bottom of the fraction down add
+		// less than one part in BASE of the fraction's lowest digit to the product, so they are
+		// dropped. That can carry into it, though, and the short product can lose one more.
+		std::size_t keepLen(m_totalLen + MUL_GUARD_DIGITS);
+		if (aLen > keepLen) {
+			a += aLen - keepLen;
+			aLen = keepLen;
+		}
+
+		if (bLen > keepLen) {
+			b += bLen - keepLen;
+			bLen = keepLen;
+		}
+
+		takeProduct(overlaps(a, aLen) || overlaps(b, bLen), aLen + bLen,
+			[&](Memory::SafePtr<Digit> dst) {
+				return strategy.mulDigitsHighInto(dst, m_totalLen, a, aLen, b, bLen);
+			});
+	}
+
+	bool BigFloat::overlaps(Memory::SafePtr<Digit> digits, std::size_t len) const
+	{
+		return Primitives::overlaps(m_digits, m_totalLen, digits, len);
+	}
+
+	void BigFloat::takeProduct(bool overlap, std::size_t fullLen,
+		const std::function<std::size_t(Memory::SafePtr<Digit>)> &mul)
+	{
+		// Unless this shares digits with a factor, as an alias of it may, the top of the product
+		// can go straight into place.
+		std::size_t prodLen(0);
+		if (overlap) {
+			Memory::Buffers::Local::RAMOnly<Digit> fraction(m_totalLen);
+			prodLen = mul(fraction.accessData(0));
+			Primitives::copy(m_digits, fraction.accessData(0), m_totalLen);
+		} else {
+			prodLen = mul(m_digits);
+		}
+
+		if (prodLen == fullLen) {
+			++m_exp;
 		}
 	}
 }
@@ -28,25 +28,81 @@
 
 #include "../IMultiplicationStrategy.hpp"
 
+#include <algorithm>
+
 namespace SDF::Bignum
 {
 	void BigInt::umul(const BigInt &num1, const BigInt &num2, IMultiplicationStrategy &strategy)
 	{
-		// The multiplication strategy algorithm takes care of all length cases.
-		strategy.mulDigits(num1.m_digits, num1.m_digitsUsed, num2.m_digits, num2.m_digitsUsed);
-
-		// Check if we have enough room to hold the full product. If not, crop it (wraparound
-		// overflow).
-		if (strategy.getProductLength() <= m_digitsAlloc) {
-			m_digitsUsed = strategy.getProductLength();
-			strategy.getProductDigits(m_digits, 0, m_digitsUsed);
+		if (Primitives::sameDigits(num1.m_digits, num1.m_digitsUsed, num2.m_digits,
+			num2.m_digitsUsed))
+		{
+			usqr(num1, strategy);
+			return;
+		}
+
+		// The multiplication strategy algorithm takes care of all length cases. Unless this is one
+		// of the factors, the product can go straight into place, cropped if it overflows.
+		if (overlapsFactor(num1, num2)) {
+			BigInt product(m_digitsAlloc);
+			product.umul(num1, num2, strategy);
+			assign(product);
+			return;
+		}
+
+		settleProduct(strategy.mulDigitsInto(m_digits, m_digitsAlloc, false, num1.m_digits,
+			num1.m_digitsUsed, num2.m_digits, num2.m_digitsUsed));
+	}
+
+	void BigInt::usqr(const BigInt &num, IMultiplicationStrategy &strategy)
+	{
+		if (overlapsFactor(num, num)) {
+			BigInt product(m_digitsAlloc);
+			product.usqr(num, strategy);
+			assign(product);
+			return;
+		}
+
+		settleProduct(strategy.squareDigitsInto(m_digits, m_digitsAlloc, false, num.m_digits,
+			num.m_digitsUsed));
+	}
+
+	void BigInt::umul(const BigInt &num1, const BigInt &num2, PreparedOperand &prepared,
+		IMultiplicationStrategy &strategy)
+	{
+		if (overlapsFactor(num1, num2)) {
+			BigInt product(m_digitsAlloc);
+			product.umul(num1, num2, prepared, strategy);
+			assign(product);
+			return;
+		}
+
+		std::size_t prodLen(0);
+		if (prepared.isOf(num1.m_digits, num1.m_digitsUsed)) {
+			prodLen = strategy.mulPreparedInto(m_digits, m_digitsAlloc, false, prepared,
+				num2.m_digits, num2.m_digitsUsed);
+		} else if (prepared.isOf(num2.m_digits, num2.m_digitsUsed)) {
+			prodLen = strategy.mulPreparedInto(m_digits, m_digitsAlloc, false, prepared,
+				num1.m_digits, num1.m_digitsUsed);
 		} else {
-			m_digitsUsed = m_digitsAlloc;
-			strategy.getProductDigits(m_digits, 0, m_digitsAlloc);
+			prodLen = strategy.mulDigitsInto(m_digits, m_digitsAlloc, false, num1.m_digits,
+				num1.m_digitsUsed, num2.m_digits, num2.m_digitsUsed);
 		}
 
-		// Correct for possible cancellation and set sign.
-		m_digitsUsed = Primitives::countSignifDigits(m_digits, m_digitsUsed);
+		settleProduct(prodLen);
+	}
+
+	bool BigInt::overlapsFactor(const BigInt &num1, const BigInt &num2) const
+	{
+		return Primitives::overlaps(m_digits, m_digitsAlloc, num1.m_digits, num1.m_digitsUsed) ||
+			Primitives::overlaps(m_digits, m_digitsAlloc, num2.m_digits, num2.m_digitsUsed);
+	}
+
+	void BigInt::settleProduct(std::size_t prodLen)
+	{
+		// If the product overflowed, only what fit was kept (wraparound overflow). Correct for
+		// possible cancellation and set sign.
+		m_digitsUsed = Primitives::countSignifDigits(m_digits, std::min(prodLen, m_digitsAlloc));
 		m_sign = SIGN_POSITIVE;
 	}
 }
@@ -24,73 +24,63 @@
 
 #include "ClassicalSmallMul.hpp"
 
+#include "../primitives/comba.hpp"
+
+#include <cassert>
+
 namespace SDF::Bignum::Multiplication
 {
-	ClassicalSmallMul::ClassicalSmallMul(std::size_t maxProdSize)
-		: m_lastProductLength(0), m_productBuffer(maxProdSize)
+	ClassicalSmallMul::ClassicalSmallMul(std::size_t maxProdSize,
+		Memory::Buffers::Local::ScratchPool *scratch)
+		: m_maxProdSize(maxProdSize), m_scratch(scratch)
 	{
 	}
 
-	void ClassicalSmallMul::mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen,
-		Memory::SafePtr<Digit> b, std::size_t bLen)
+	std::size_t ClassicalSmallMul::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+		std::size_t bLen)
 	{
-		// Implementation of the classic "grade school" multiplication method.
+		// Implementation of the classic "grade school" multiplication method. The product is done
+		// column by column, so that the carries need only be done once per product digit (see
+		// Primitives::combaMul). Its actual length may be up to 1 digit less than aLen + bLen if
+		// the multiplier is suitably small. (It could also be zero, if a factor was zero, but to
+		// make efficient we don't check this - NOTE! CAVEAT! this is delegated to the bignum type
+		// implementation!)
 		std::size_t prodLen(aLen + bLen);
-		Memory::SafePtr<Digit> prodBufPtr(m_productBuffer.accessData(0));
-
-		// Zeroize the relevant part of the product buffer.
-		for (std::size_t i(0); i < prodLen; ++i) {
-			prodBufPtr[i] = 0;
-		}
-
-		// Do the multiplication.
-		for (std::size_t j(0); j < bLen; ++j) {
-			// Perform a fused multiply and add of a with a digit of b and then adding it to the
-			// product buffer, shifted left by the appropriate amount.
-			TwoDigit carry(0);
-			for (std::size_t i(0); i < aLen; ++i) {
-				TwoDigit tmp(prodBufPtr[j + i] + (static_cast<TwoDigit>(a[i]) * b[j]) + carry);
-				carry = tmp / BASE;
-				tmp -= carry * BASE;
-				prodBufPtr[j + i] = static_cast<Digit>(tmp);
-			}
-
-			// Slop the remaining carry over into the next digit if needed. The largest possible
-			// carry is always, given that in each step we do a proper, canonical addition to the
-			// preceding sum of partial products, ((BASE-1) + (BASE-1)^2)/BASE = BASE-1, so we don't
-			// need to worry about further expansion of the carry than this.
-			prodBufPtr[j + aLen] = carry;
-		}
+		assert(prodLen <= m_maxProdSize);
 
-		// Get the length of the product. The actual length may be up to 1 digit less than the one
-		// given as prodLen above if the multiplier is suitably small. (It could also be zero, if the
-		// a factor was zero, but to make efficient we don't check this - NOTE! CAVEAT! this is
-		// delegated to the bignum type implementation!)
-		if (prodBufPtr[prodLen - 1] != 0) {
-			m_lastProductLength = prodLen;
-		} else {
-			m_lastProductLength = prodLen - 1;
-		}
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodLen,
+			[&](Memory::SafePtr<Digit> prod) { Primitives::combaMul(prod, a, aLen, b, bLen); });
 	}
 
-	void ClassicalSmallMul::squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen)
+	std::size_t ClassicalSmallMul::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
 	{
 		// Like the above, except we can do only half the multiplies.
-		// TBA
-		mulDigits(a, aLen, a, aLen);
-	}
+		std::size_t prodLen(2 * aLen);
+		assert(prodLen <= m_maxProdSize);
 
-	std::size_t ClassicalSmallMul::getProductLength() const
-	{
-		return m_lastProductLength;
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodLen,
+			[&](Memory::SafePtr<Digit> prod) { Primitives::combaSqr(prod, a, aLen); });
 	}
 
-	void ClassicalSmallMul::getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin,
-		std::size_t length)
+	std::size_t ClassicalSmallMul::mulDigitsHighInto(Memory::SafePtr<Digit> dst,
+		std::size_t dstLen, Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+		std::size_t bLen)
 	{
-		Memory::SafePtr<Digit> prodBufPtr(m_productBuffer.accessData(origin));
-		for (std::size_t i(0); i < length; ++i) {
-			dst[i] = prodBufPtr[i];
+		// Only the columns from a little below the lowest digit kept up are summed, which when
+		// the top half of a product of equal factors is kept is about half the multiplies.
+		std::size_t prodLen(aLen + bLen);
+		assert(prodLen <= m_maxProdSize);
+
+		if (prodLen <= dstLen) {
+			return mulDigitsInto(dst, dstLen, true, a, aLen, b, bLen);
 		}
+
+		std::size_t cut(shortProductCut(dstLen, prodLen));
+		return putProduct(*m_scratch, dst, dstLen, true, prodLen,
+			[&](Memory::SafePtr<Digit> prod) {
+				Primitives::combaMulHigh(prod, a, aLen, b, bLen, cut);
+			});
 	}
 }
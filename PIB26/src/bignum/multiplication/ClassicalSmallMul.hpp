@@ -27,7 +27,7 @@
 
 #include "../IMultiplicationStrategy.hpp"
 
-#include "../../memory/buffers/local/RAMOnly.hpp"
+#include "../../memory/buffers/local/ScratchPool.hpp"
 
 namespace SDF::Bignum::Multiplication
 {
@@ -42,18 +42,21 @@ namespace SDF::Bignum::Multiplication
 			// Function:  ClassicalSmallMul
 			// Purpose:   Construct a new strategy object with a given maximum buffer size.
 			// Arguments: maxProdSize - The maximum multiplication size to allow.
-			ClassicalSmallMul(std::size_t maxProdSize);
+			//            scratch - The pool to borrow scratch space from, shared with the other
+			//                      strategies.
+			ClassicalSmallMul(std::size_t maxProdSize, Memory::Buffers::Local::ScratchPool *scratch);
 
-			void mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+			std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+			std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen);
+			std::size_t mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
 				std::size_t bLen);
-			void squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen);
-
-			std::size_t getProductLength() const;
-
-			void getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin, std::size_t length);
 		private:
-			std::size_t m_lastProductLength;
-			Memory::Buffers::Local::RAMOnly<Digit> m_productBuffer;
+			std::size_t m_maxProdSize;
+			Memory::Buffers::Local::ScratchPool *m_scratch;
 	};
 }
 
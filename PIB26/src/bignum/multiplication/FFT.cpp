@@ -26,15 +26,16 @@
 
 #include "../../exceptions/exceptions.hpp"
 
-#include "FFT/complex/genOmegaTable.hpp"
-#include "FFT/complex/rad3Rec.hpp"
-
 #include "../primitives/add.hpp"
-#include "../primitives/addsm.hpp"
-#include "../primitives/muladd.hpp"
+#include "../primitives/assign.hpp"
+
+#include "FFT/FFTTweak.hpp"
+#include "FFT/complex/fourStep.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <vector>
 
 #include <iostream>
 //#include <iomanip>
@@ -42,336 +43,819 @@
 
 namespace SDF::Bignum::Multiplication
 {
-	FFT::FFT(std::size_t maxProdSize)
-		: m_maxProdSize(maxProdSize), m_lastProdLength(0)
+	namespace
 	{
-		std::size_t smallsPerElement(calcSmallsPerElement(m_maxProdSize));
-		std::size_t expandedMaxProdSize((m_maxProdSize * DIGS_PER_DIG) / smallsPerElement);
-		if ((expandedMaxProdSize * DIGS_PER_DIG) % smallsPerElement) {
-			++expandedMaxProdSize; // round up
+		// The right-angle weights for a transform of length N are w_i = e^(+pii i/(2N)), i.e. the
+		// (4N)-th roots of unity. The twiddle table holds e^(-2pii k/W) and N divides W, so it has
+		// the conjugates of every g-th weight, g = 4/gcd(W/N, 4), which is 1, 2 or 4. We get the
+		// rest by multiplying by one of g "fine" weights e^(pii r/(2N)), r < g. This way the
+		// weights cost one table entry and one complex multiply instead of a cos and a sin.
+		struct RightAngleWeights
+		{
+				std::size_t omegaStride; // step through the twiddle table for each coarse weight
+				std::size_t fineShift; // lg g
+				Fft::Complex::Cplex fine[4];
+		};
+
+		// Function:   getRightAngleWeights
+		// Purpose:    Set up the right-angle weights for a transform length.
+		// Parameters: omegaSize - The order of the roots in the twiddle table.
+		//             fftSize - The transform length. It must divide omegaSize.
+		//             inverse - Whether to get the fine weights for removing the weights instead,
+		//                       i.e. conjugated and divided by fftSize, which also undoes the
+		//                       scaling of the reverse transform.
+		// Returns:    The weights.
+		RightAngleWeights getRightAngleWeights(std::size_t omegaSize, std::size_t fftSize,
+			bool inverse)
+		{
+			std::size_t ratio(omegaSize / fftSize);
+			std::size_t g(4);
+			while (ratio % g != 0) {
+				g >>= 1;
+			}
+
+			RightAngleWeights weights;
+			weights.omegaStride = ratio / g;
+			weights.fineShift = 0;
+			std::size_t fineCount(4 / g);
+			while ((std::size_t(1) << weights.fineShift) < fineCount) {
+				++weights.fineShift;
+			}
+
+			for (std::size_t r(0); r < fineCount; ++r) {
+				if (inverse) {
+					weights.fine[r] = { cos(M_PI * r / (2 * fftSize)) / fftSize,
+						-sin(M_PI * r / (2 * fftSize)) / fftSize };
+				} else {
+					weights.fine[r] = { cos(M_PI * r / (2 * fftSize)), sin(M_PI * r / (2 * fftSize)) };
+				}
+			}
+
+			return weights;
 		}
 
-		for (std::size_t i(0); i <= DIGS_PER_DIG; ++i) {
-			m_smallBases[i] = pow(BASE_MINOR, i);
+		// Function:   applyWeightAt
+		// Purpose:    Weight a real input element.
+		// Parameters: omega - The twiddle table.
+		//             weights - The weights, from getRightAngleWeights.
+		//             i - The element index.
+		//             x - The element value.
+		// Returns:    The weighted element.
+		inline Fft::Complex::Cplex applyWeightAt(const Fft::Complex::TwiddleTable &omega,
+			const RightAngleWeights &weights, std::size_t i, double x)
+		{
+			Fft::Complex::Cplex w0(omega[(i >> weights.fineShift) * weights.omegaStride]);
+			const Fft::Complex::Cplex &f(weights.fine[i & ((1 << weights.fineShift) - 1)]);
+
+			// x * conj(w0) * f
+			return { x * (w0.r * f.r + w0.i * f.i), x * (w0.r * f.i - w0.i * f.r) };
 		}
 
-		std::cout << "Preparing Fast Fourier Transform root tables ..." << std::flush;
+		// Function:   applyWeightAt
+		// Purpose:    Weight a complex input element, i.e. one with a folded-over element in its
+		//             imaginary part.
+		// Parameters: omega - The twiddle table.
+		//             weights - The weights, from getRightAngleWeights.
+		//             i - The element index.
+		//             x - The element value.
+		// Returns:    The weighted element.
+		inline Fft::Complex::Cplex applyWeightAt(const Fft::Complex::TwiddleTable &omega,
+			const RightAngleWeights &weights, std::size_t i, const Fft::Complex::Cplex &x)
+		{
+			Fft::Complex::Cplex w(applyWeightAt(omega, weights, i, 1.0));
+
+			return { x.r * w.r - x.i * w.i, x.r * w.i + x.i * w.r };
+		}
+
+		// Function:   removeWeightAt
+		// Purpose:    Remove the weight from an output element.
+		// Parameters: omega - The twiddle table.
+		//             weights - The inverse weights, from getRightAngleWeights.
+		//             i - The element index.
+		//             x - The element.
+		// Returns:    The unweighted element.
+		inline Fft::Complex::Cplex removeWeightAt(const Fft::Complex::TwiddleTable &omega,
+			const RightAngleWeights &weights, std::size_t i, const Fft::Complex::Cplex &x)
+		{
+			Fft::Complex::Cplex w0(omega[(i >> weights.fineShift) * weights.omegaStride]);
+			const Fft::Complex::Cplex &f(weights.fine[i & ((1 << weights.fineShift) - 1)]);
+			Fft::Complex::Cplex w { w0.r * f.r - w0.i * f.i, w0.r * f.i + w0.i * f.r };
+
+			return { x.r * w.r - x.i * w.i, x.r * w.i + x.i * w.r };
+		}
 
-		// The omega table size should always contain 1 factor of 3 for these FFTs.
-		std::size_t omegaTableSize(3);
-		while (omegaTableSize < expandedMaxProdSize) {
-			omegaTableSize <<= 1;
+		// Function:   roundElement
+		// Purpose:    Round an output element to the nearest integer, keeping track of how far off
+		//             an integer the elements have been.
+		// Parameters: x - The element.
+		//             maxError - The largest distance from an integer so far, updated.
+		// Returns:    The rounded element.
+		inline double roundElement(double x, double &maxError)
+		{
+			double rounded(floor(x + 0.5));
+			maxError = std::max(maxError, std::fabs(x - rounded));
+
+			return rounded;
 		}
 
-		// Create the omega table.
-		m_omegaBuffer = Fft::Complex::genOmegaTable(omegaTableSize);
+		// Function:   estimateTransformWork
+		// Purpose:    Give a rough flop count for a transform, for planning.
+		// Parameters: len - The transform length.
+		// Returns:    The estimate.
+		inline double estimateTransformWork(std::size_t len)
+		{
+			return 15.0 * len * (std::log2(static_cast<double>(len)) + 2.0);
+		}
 
-		std::cout << " done!" << std::endl;
+		// Rough work per element, in the same units, of the passes around the transforms: loading
+		// a number into a buffer, unspooling a product and releasing its carries, and adding a
+		// chunk product into the whole one (see mulChunked). Being scalar, these cost several
+		// times as much per element as the transforms do.
+		const double c_loadWork = 600.0;
+		const double c_extractWork = 1800.0;
+		const double c_addWork = 350.0;
+
+		constexpr TwoDigit smallPow(std::size_t n)
+		{
+			return (n == 0) ? 1 : BASE_MINOR * smallPow(n - 1);
+		}
 
-		m_fft = std::make_unique<Fft::Complex::rad3Rec>(m_omegaBuffer->accessData(0), omegaTableSize);
+		// Class:      DigitPacker
+		// Purpose:    Releases the carries from a stream of rounded product elements, each worth
+		//             smalls base-BASE_MINOR digits, and packs them into Digits.
+		// Parameters: smalls - The number of small digits per element.
+		template<std::size_t smalls>
+		class DigitPacker
+		{
+			public:
+				// Function:   DigitPacker
+				// Purpose:    Start packing into a buffer.
+				// Parameters: dst - The buffer to fill.
+				//             len - The number of Digits to fill. Any more are dropped.
+				DigitPacker(Memory::SafePtr<Digit> dst, std::size_t len)
+					: m_dst(dst), m_len(len), m_idx(0), m_carry(0.0), m_buffer(0), m_smallsInBuffer(0)
+				{
+				}
 
-		// Create the FFT buffers.
-		// Halve the size to exploit the so-called *right angle convolution* (see other methods
-		// below).
-		m_fftBufferSize = m_fft->getNearestSafeLengthTo(
-			(expandedMaxProdSize / 2) + (expandedMaxProdSize % 2));
+				bool isFull() const
+				{
+					return m_idx >= m_len;
+				}
 
-		m_num1FFTBuffer = std::make_unique<Memory::Buffers::Local::RAMOnly<Fft::Complex::Cplex>>(
-			m_fftBufferSize);
-		m_num2FFTBuffer = std::make_unique<Memory::Buffers::Local::RAMOnly<Fft::Complex::Cplex>>(
-			m_fftBufferSize);
+				// Function:   push
+				// Purpose:    Add the next element.
+				// Parameters: element - The element, rounded to an integer.
+				// Returns:    None.
+				void push(double element)
+				{
+					// release carries
+					element += m_carry;
+					m_carry = floor(element / c_elementBase);
+					element -= m_carry * c_elementBase;
+
+					// buffer it
+					m_buffer += smallPow(m_smallsInBuffer) * static_cast<TwoDigit>(element);
+					m_smallsInBuffer += smalls;
+
+					if (m_smallsInBuffer >= DIGS_PER_DIG) {
+						if (m_idx < m_len) {
+							m_dst[m_idx] = m_buffer % BASE;
+						}
+						++m_idx;
+						m_buffer /= BASE;
+						m_smallsInBuffer -= DIGS_PER_DIG;
+					}
+				}
+
+				// Function:   finish
+				// Purpose:    Flush what is left in the buffer and zero the rest of the Digits.
+				// Parameters: None.
+				// Returns:    The carry out of the last element.
+				double finish()
+				{
+					for (; m_idx < m_len; ++m_idx) {
+						m_dst[m_idx] = m_buffer;
+						m_buffer = 0;
+					}
+
+					return m_carry;
+				}
+			private:
+				static constexpr double c_elementBase = smallPow(smalls);
+
+				Memory::SafePtr<Digit> m_dst;
+				std::size_t m_len;
+				std::size_t m_idx;
+				double m_carry;
+				TwoDigit m_buffer;
+				std::size_t m_smallsInBuffer;
+		};
+
+		// Class:      ElementReader
+		// Purpose:    Reads the elements of a number packed a given number of base-BASE_MINOR
+		//             digits to an element, starting from any element. Past the end of the number,
+		//             it reads zeroes. The elements are balanced: any element in the top half of
+		//             the range has the element base taken off, and one carried into the next, so
+		//             they run from minus half the base to half the base. This makes the products
+		//             of the elements, and so the round-off error in the transforms, smaller; and
+		//             for most numbers, the terms of the convolution mostly cancel instead of
+		//             adding up, so the error grows much more slowly with the length. Since each
+		//             carry depends only on the element below it, and not on any carry into that,
+		//             the elements can be read starting anywhere. The top element is left as it is,
+		//             so the number does not gain an element.
+		// Parameters: None.
+		class ElementReader
+		{
+			public:
+				// Function:   ElementReader
+				// Purpose:    Start reading a number.
+				// Parameters: smallBases - The powers of BASE_MINOR up to BASE.
+				//             num - The number to read.
+				//             numLen - The length of the number.
+				//             smalls - The number of small digits per element.
+				//             first - The first element to read.
+				ElementReader(const TwoDigit *smallBases, Memory::SafePtr<Digit> num,
+					std::size_t numLen, std::size_t smalls, std::size_t first)
+					: m_smallBases(smallBases), m_num(num), m_numLen(numLen), m_smalls(smalls),
+					  m_elementBase(smallBases[smalls]),
+					  m_numElements(((numLen * DIGS_PER_DIG) + smalls - 1) / smalls),
+					  m_element((first > 0) ? first - 1 : 0), m_carry(0),
+					  m_idx((m_element * smalls) / DIGS_PER_DIG), m_buffer(0), m_smallsInBuffer(0)
+				{
+					// If the first element begins partway into a Digit, preload what is left of it.
+					std::size_t skip((m_element * smalls) % DIGS_PER_DIG);
+					if ((skip != 0) && (m_idx < m_numLen)) {
+						m_buffer = m_num[m_idx++] / m_smallBases[skip];
+						m_smallsInBuffer = DIGS_PER_DIG - skip;
+					}
+
+					// Start from the element before to get the carry into the first.
+					if (first > 0) {
+						next();
+					}
+				}
 
-		m_productDigits = m_num2FFTBuffer->pun<Digit>();
+				// Function:   next
+				// Purpose:    Read the next element.
+				// Parameters: None.
+				// Returns:    The element, balanced.
+				TwoDigit next()
+				{
+					TwoDigit element(nextUnbalanced());
+					if (m_element >= m_numElements) {
+						return 0;
+					}
+
+					TwoDigit carryOut(((++m_element < m_numElements) &&
+						(2 * element >= m_elementBase)) ? 1 : 0);
+					element += m_carry - (carryOut * m_elementBase);
+					m_carry = carryOut;
+
+					return element;
+				}
+			private:
+				const TwoDigit *m_smallBases;
+				Memory::SafePtr<Digit> m_num;
+				std::size_t m_numLen;
+				std::size_t m_smalls;
+				TwoDigit m_elementBase;
+				std::size_t m_numElements;
+				std::size_t m_element;
+				TwoDigit m_carry;
+				std::size_t m_idx;
+				TwoDigit m_buffer;
+				std::size_t m_smallsInBuffer;
+
+				// Function:   nextUnbalanced
+				// Purpose:    Read the next element as it is in the number.
+				// Parameters: None.
+				// Returns:    The element.
+				TwoDigit nextUnbalanced()
+				{
+					if (m_smalls == DIGS_PER_DIG) {
+						return (m_idx < m_numLen) ? m_num[m_idx++] : 0;
+					}
+
+					if ((m_smallsInBuffer < m_smalls) && (m_idx < m_numLen)) {
+						// Note we must add new digits to the _left_ of the ones already buffered.
+						m_buffer += m_smallBases[m_smallsInBuffer] * m_num[m_idx++];
+						m_smallsInBuffer += DIGS_PER_DIG;
+					}
+
+					// past the end of the number this finishes off any remainder, then gives zeroes
+					TwoDigit element(m_buffer % m_smallBases[m_smalls]);
+					m_buffer /= m_smallBases[m_smalls];
+					m_smallsInBuffer = (m_smallsInBuffer > m_smalls) ? m_smallsInBuffer - m_smalls : 0;
+
+					return element;
+				}
+		};
 	}
 
-	void FFT::mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
-		std::size_t bLen)
+	FFT::FFT(std::size_t maxProdSize, Util::ThreadPool *threadPool,
+		Memory::Buffers::Local::ScratchPool *scratch)
+		: m_threadPool(threadPool), m_maxProdSize(maxProdSize), m_scratch(scratch),
+		  m_roundOffStats(NUM_SIZE_CLASSES, RoundOffStats { {}, 0, {} })
 	{
-		if (aLen + bLen > m_maxProdSize) {
-			throw SDF::Exceptions::Exception("Requested FFT multiply of numbers that were too big :(");
-		}
-
-		// Because the FFT does not permit arbitrary lengths without padding, performance
-		// "thresholding" may be a problem, particularly when dealing with multiplies that, by some
-		// other effect, are coincident with the size steps - most notably, in the Newton routines. To
-		// deal with this, if we get a request to multiply two numbers very close to, but above, a
-		// size threshold, we'd like to use the next smaller transform and then finish out the job
-		// with a few classical multiply passes.
-		std::size_t prodSize(aLen + bLen);
-		std::size_t pow2Size(1);
+		// The transforms must hold the largest product at the density safe for any numbers, which
+		// is the lowest we would ever fall back to.
+		std::size_t smallsPerElement(calcWorstCaseSmallsPerElement(m_maxProdSize));
+		std::size_t expandedMaxProdSize(calcElementCount(m_maxProdSize, smallsPerElement));
 
-		while ((pow2Size << 1) < prodSize) {
-			pow2Size <<= 1;
+		for (std::size_t i(0); i <= DIGS_PER_DIG; ++i) {
+			m_smallBases[i] = pow(BASE_MINOR, i);
 		}
 
-		if (prodSize - pow2Size < 2 * THRESHOLD_SMOOTHING) {
-			Memory::SafePtr<Digit> prodPtr(m_productDigits.accessData(0));
-
-			// "Smooth" the performance by multiplying THRESHOLD_SMOOTHING fewer digits using the FFT.
-			std::size_t aTrunc(aLen - THRESHOLD_SMOOTHING);
-			std::size_t bTrunc(bLen - THRESHOLD_SMOOTHING);
-			mulCore(a, aTrunc, b, bTrunc);
+		std::cout << "Preparing Fast Fourier Transform root tables ..." << std::flush;
 
-			for (std::size_t i(aTrunc + bTrunc); i < prodSize; ++i) {
-				prodPtr[i] = 0;
+		// The transform lengths we can use are those of the forms 2^n, 3 * 2^n, 5 * 2^n and
+		// 15 * 2^n that divide the twiddle table order. Of the sizes up to 4 times the product, take
+		// the one giving the shortest transform for the largest product, preferring on a tie the
+		// one that leaves the most lengths open for smaller products, then the smaller table.
+		static const std::size_t c_oddFactors[] = { 15, 3, 5, 1 };
+
+		std::size_t maxFftLength((expandedMaxProdSize / 2) + (expandedMaxProdSize % 2));
+		std::size_t omegaTableSize(0);
+		std::size_t bestFftLength(0);
+		for (std::size_t oddFactor : c_oddFactors) {
+			std::size_t size(oddFactor);
+			while (size < expandedMaxProdSize) {
+				size <<= 1;
 			}
 
-			// Now fill in for it with a few classical mul passes.
-			// We use the formula
-			// (d_1 B^n + X)(d_2 B^m + Y) = d_1 d_2 B^(n + m) + d_1 Y B^n + d_2 X B^m + XY
-			// where X and Y are the truncated factors, and d_1 and d_2 are the missing digits.
-			//for (std::size_t i(prodSize); i > 0; --i) {
-			//std::cout << std::setw(4) << std::setfill('0') << prodPtr[i-1];
-			//}
-			//std::cout << std::endl;
-
-			for (std::size_t i(THRESHOLD_SMOOTHING); i > 0; --i) {
-				aTrunc = aLen - i;
-				bTrunc = bLen - i;
-
-				TwoDigit bigCarry(0);
-				bigCarry = Primitives::mulAdd(prodPtr + aTrunc, prodPtr + aTrunc, b, a[aTrunc], bTrunc);
-				Primitives::addSmall(prodPtr + aTrunc + bTrunc, prodPtr + aTrunc + bTrunc, bigCarry,
-					prodSize - (aTrunc + bTrunc));
-
-				bigCarry = Primitives::mulAdd(prodPtr + bTrunc, prodPtr + bTrunc, a, b[bTrunc], aTrunc);
-				Primitives::addSmall(prodPtr + bTrunc + aTrunc, prodPtr + bTrunc + aTrunc, bigCarry,
-					prodSize - (bTrunc + aTrunc));
-
-				bigCarry = static_cast<TwoDigit>(a[aTrunc]) * b[bTrunc];
-				Primitives::addSmall(prodPtr + aTrunc + bTrunc, prodPtr + aTrunc + bTrunc, bigCarry,
-					prodSize - (aTrunc + bTrunc));
+			for (; size <= 4 * expandedMaxProdSize; size <<= 1) {
+				std::size_t fftLength(Fft::Complex::rad5Rec::getNearestSafeLength(maxFftLength, size));
+				if ((fftLength != 0) && ((bestFftLength == 0) || (fftLength < bestFftLength))) {
+					bestFftLength = fftLength;
+					omegaTableSize = size;
+				}
 			}
-		} else {
-			mulCore(a, aLen, b, bLen);
 		}
 
-		// Report the product size.
-		m_lastProdLength = prodSize;
-		if (*m_productDigits.accessData(m_lastProdLength - 1) == 0) {
-			--m_lastProdLength;
-		}
+		// Create the twiddle table. Its direct tables need to cover the transforms done without
+		// blocking, and the rows and columns of the blocked ones.
+		m_twiddles = std::make_unique<Fft::Complex::TwiddleTable>(omegaTableSize,
+			Fft::getIterativeCacheSize() / sizeof(Fft::Complex::Cplex), m_threadPool);
+
+		std::cout << " done! (" << (m_twiddles->getMemoryUse() + 1023) / 1024 << " KB)" << std::endl;
+
+		// Plan the transforms, or load the plans made by an earlier run on this machine. The
+		// layouts of the long transforms are only planned as they come up.
+		std::cout << "Planning Fast Fourier Transforms ..." << std::flush;
+		m_planner = std::make_unique<Fft::Complex::FftPlanner>(WISDOM_FILE, omegaTableSize,
+			m_threadPool->getNumThreads());
+		m_fft = std::make_unique<Fft::Complex::fourStep>(*m_twiddles, m_threadPool,
+			m_planner.get(), m_scratch);
+		std::cout << " done!" << std::endl;
+
+		// Halve the size to exploit the so-called *right angle convolution* (see other methods
+		// below).
+		m_maxFftSize = m_fft->getNearestSafeLengthTo(maxFftLength);
 	}
 
-	void FFT::squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen)
+	std::size_t FFT::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		// If the product fits, it is unspooled straight where it goes.
+		return putProduct(*m_scratch, dst, dstLen, keepTop, aLen + bLen,
+			[&](Memory::SafePtr<Digit> prod) { mulInto(prod, a, aLen, b, bLen); });
+	}
+
+	std::size_t FFT::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
 	{
-		// We can save an FFT in this case.
 		if ((aLen << 1) > m_maxProdSize) {
 			throw SDF::Exceptions::Exception("Requested FFT multiply of numbers that were too big :(");
 		}
 
-		std::size_t prodSize(aLen << 1);
-		std::size_t pow2Size(1);
+		return putProduct(*m_scratch, dst, dstLen, keepTop, aLen << 1,
+			[&](Memory::SafePtr<Digit> prod) { sqrInto(prod, a, aLen); });
+	}
 
-		while ((pow2Size << 1) < prodSize) {
-			pow2Size <<= 1;
+	std::size_t FFT::mulDigitsWrappedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen,
+		std::size_t wrapLen)
+	{
+		std::size_t prodSize(aLen + bLen);
+		if ((wrapLen >= prodSize) || (aLen > wrapLen) || (bLen > wrapLen)) {
+			return mulDigitsInto(dst, dstLen, false, a, aLen, b, bLen);
 		}
 
-		if (prodSize - pow2Size < 2 * THRESHOLD_SMOOTHING) {
-			Memory::SafePtr<Digit> prodPtr(m_productDigits.accessData(0));
+		// Pack as for the full product, as the elements of the wrapped one are no bigger. The
+		// transform must hold at least wrapLen digits, and then the product wraps around onto
+		// itself, negated, with nothing worked out to add back in.
+		std::size_t smallsPerElement(calcSmallsPerElement(prodSize));
+		std::size_t aElements(calcElementCount(aLen, smallsPerElement));
+		std::size_t bElements(calcElementCount(bLen, smallsPerElement));
+		std::size_t wrapElements(calcElementCount(wrapLen, smallsPerElement));
+		std::size_t fftSize(m_fft->getNearestSafeLengthTo((wrapElements / 2) + (wrapElements % 2)));
+		if (2 * fftSize >= aElements + bElements - 1) {
+			return mulDigitsInto(dst, dstLen, false, a, aLen, b, bLen);
+		}
 
-			// "Smooth" the performance by multiplying THRESHOLD_SMOOTHING fewer digits using the FFT.
-			std::size_t aTrunc(aLen - THRESHOLD_SMOOTHING);
-			sqrCore(a, aTrunc);
+		auto num1Buf(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		auto num2Buf(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		Memory::SafePtr<Fft::Complex::Cplex> num1BufPtr(num1Buf.accessData(0));
 
-			for (std::size_t i(aTrunc << 1); i < prodSize; ++i) {
-				prodPtr[i] = 0;
-			}
+		wrappedProduct(num1BufPtr, num2Buf.accessData(0), fftSize, a, aLen, 0, b, bLen, 0,
+			smallsPerElement, false);
 
-			for (std::size_t i(THRESHOLD_SMOOTHING); i > 0; --i) {
-				aTrunc = aLen - i;
+		// Only the digits below the wrap point mean anything.
+		std::size_t resultLen(((2 * fftSize) * smallsPerElement) / DIGS_PER_DIG);
+		if (!checkRoundOff(prodSize, smallsPerElement, extractUnweighted(dst,
+			std::min(resultLen, dstLen), num1BufPtr, fftSize, smallsPerElement,
+			std::vector<double>())))
+		{
+			return mulDigitsWrappedInto(dst, dstLen, a, aLen, b, bLen, wrapLen);
+		}
 
-				TwoDigit bigCarry(0);
-				bigCarry = Primitives::mulAdd(prodPtr + aTrunc, prodPtr + aTrunc, a, 2 * a[aTrunc],
-					aTrunc);
-				Primitives::addSmall(prodPtr + aTrunc + aTrunc, prodPtr + aTrunc + aTrunc, bigCarry,
-					prodSize - (aTrunc + aTrunc));
+		return resultLen;
+	}
 
-				bigCarry = static_cast<TwoDigit>(a[aTrunc]) * a[aTrunc];
-				Primitives::addSmall(prodPtr + aTrunc + aTrunc, prodPtr + aTrunc + aTrunc, bigCarry,
-					prodSize - (aTrunc + aTrunc));
+	class FFT::PreparedFft : public PreparedOperand
+	{
+		public:
+			PreparedFft(const FFT *owner, Memory::SafePtr<Digit> digits, std::size_t len,
+				std::size_t maxOtherLen, std::size_t smallsPerElement, std::size_t fftSize)
+				: PreparedOperand(digits, len), owner(owner), maxOtherLen(maxOtherLen),
+				  smallsPerElement(smallsPerElement), fftSize(fftSize), transform(fftSize)
+			{
 			}
-		} else {
-			sqrCore(a, aLen);
-		}
 
-		// Report the product size.
-		m_lastProdLength = prodSize;
-		if (*m_productDigits.accessData(m_lastProdLength - 1) == 0) {
-			--m_lastProdLength;
-		}
-	}
+			const FFT *owner;
+			std::size_t maxOtherLen;
+			std::size_t smallsPerElement;
+			std::size_t fftSize;
+			Memory::Buffers::Local::RAMOnly<Fft::Complex::Cplex> transform;
+	};
 
-	std::size_t FFT::getProductLength() const
+	std::unique_ptr<PreparedOperand> FFT::prepareOperand(Memory::SafePtr<Digit> a,
+		std::size_t aLen, std::size_t maxOtherLen)
 	{
-		return m_lastProdLength;
+		if ((aLen == 0) || (maxOtherLen == 0) || (aLen + maxOtherLen > m_maxProdSize)) {
+			return IMultiplicationStrategy::prepareOperand(a, aLen, maxOtherLen);
+		}
+
+		// Plan for the longest product. Shorter ones fit in the same transform length with the
+		// same packing, so long as the packing for them comes out the same too.
+		std::size_t prodSize(aLen + maxOtherLen);
+		std::size_t smallsPerElement(calcSmallsPerElement(prodSize));
+		std::size_t aElements(calcElementCount(aLen, smallsPerElement));
+		std::size_t otherElements(calcElementCount(maxOtherLen, smallsPerElement));
+		std::size_t fftSize(planTruncation(aElements + otherElements - 1,
+			std::max(aElements, otherElements), mayTruncate(prodSize, smallsPerElement)));
+
+		std::unique_ptr<PreparedFft> prepared(std::make_unique<PreparedFft>(this, a, aLen,
+			maxOtherLen, smallsPerElement, fftSize));
+		Memory::SafePtr<Fft::Complex::Cplex> transformPtr(prepared->transform.accessData(0));
+		loadWeighted(transformPtr, fftSize, a, aLen, 0, smallsPerElement);
+		m_fft->doFwdTransform(transformPtr, fftSize);
+
+		return prepared;
 	}
 
-	void FFT::getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin, std::size_t length)
+	std::size_t FFT::mulPreparedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, const PreparedOperand &a, Memory::SafePtr<Digit> b, std::size_t bLen)
 	{
-		Memory::SafePtr<Digit> digitPtr(m_productDigits.accessData(origin));
-
-		for (std::size_t i(0); i < length; ++i) {
-			dst[i] = digitPtr[i];
+		const PreparedFft *prepared(dynamic_cast<const PreparedFft *>(&a));
+		if ((prepared == nullptr) || (prepared->owner != this) || (bLen == 0) ||
+			(bLen > prepared->maxOtherLen))
+		{
+			return mulDigitsInto(dst, dstLen, keepTop, a.getDigits(), a.getLength(), b, bLen);
 		}
-	}
 
-	// Private members.
-	void FFT::loadBuffer(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t bufferLen,
-		Memory::SafePtr<Digit> num, std::size_t numLen, std::size_t smallsPerFftElement)
-	{
-		// The parameters fftBase and smallsPerFftElement allow us to stretch the FFT multiplication
-		// to larger lengths than would otherwise be permitted by rounding error by packing fewer
-		// small digits (i.e. base-BASE_MINOR) per element than the input, fed in base-BASE, has
-		// directly. One should pass fftBase == BASE_MINOR^smallsPerFftElement; both are calculated by
-		// getFFTBase.
-		if (smallsPerFftElement == DIGS_PER_DIG) {
-			// When loading the FFT buffer, we use the so-called "right-angle" convolution, which
-			// means we premultiply all inputs by powers of i^(1/N) (i is the unit imaginary number).
-			// This, in effect, is a type of discrete weighted transform (DWT), which we can use to
-			// cause the elements of the FFT output to "fold over" so that the first half of the
-			// product sequence is in the real part of the output, and the second half in the imaginary
-			// part. This allows us to save a factor of 2 on transform size, thus both memory and
-			// time. While this doesn't affect this part of the multiply (we factor this step out into
-			// another method below), it does mean we have to take care when extracting the product.
-			for (std::size_t i(0); i < numLen; ++i) {
-				fftBuffer[i] = { num[i], 0.0 };
-			}
+		// The kept transform is only good if this product packs the same way, and only worth it
+		// if the product is not so much shorter that a fresh pair of transforms would be cheaper.
+		std::size_t prodSize(a.getLength() + bLen);
+		std::size_t smallsPerElement(prepared->smallsPerElement);
+		std::size_t aElements(calcElementCount(a.getLength(), smallsPerElement));
+		std::size_t bElements(calcElementCount(bLen, smallsPerElement));
+		std::size_t prodElements(aElements + bElements - 1);
+		std::size_t fftSize(prepared->fftSize);
+		if ((calcSmallsPerElement(prodSize) != smallsPerElement) ||
+			(3 * planTruncation(prodElements, std::max(aElements, bElements),
+				mayTruncate(prodSize, smallsPerElement)) < 2 * fftSize))
+		{
+			return mulDigitsInto(dst, dstLen, keepTop, a.getDigits(), a.getLength(), b, bLen);
+		}
 
-			for (std::size_t i(numLen); i < bufferLen; ++i) {
-				fftBuffer[i] = { 0.0, 0.0 };
-			}
-		} else {
-			// Pack fewer digits per element. We do this by in effect creating a "stream buffer" for
-			// small digits, withdrawing smallsPerFftElement worth and loading it up again with new
-			// digits when it gets low.
-			TwoDigit smallDigitBuffer(0);
-			std::size_t smallsInBuffer(0);
-			std::size_t outBufIdx(0);
-
-			for (std::size_t i(0); (i < numLen) && (outBufIdx < bufferLen); ++outBufIdx) {
-				if (smallsInBuffer < smallsPerFftElement) {
-					// "buffer" some new digits. Note we must add these to the _left_ of the ones
-					// already in the buffer.
-					smallDigitBuffer += m_smallBases[smallsInBuffer] * num[i];
-					smallsInBuffer += DIGS_PER_DIG;
-					++i;
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodSize,
+			[&](Memory::SafePtr<Digit> prod) {
+				if (!mulPreparedCore(prod, *prepared, b, bLen)) {
+					// The packing is too dense after all; the kept transform is no good for this.
+					mulInto(prod, a.getDigits(), a.getLength(), b, bLen);
 				}
+			});
+	}
 
-				// drain buffer
-				fftBuffer[outBufIdx] = { (smallDigitBuffer % m_smallBases[smallsPerFftElement]), 0.0 };
-				smallDigitBuffer /= m_smallBases[smallsPerFftElement];
-				smallsInBuffer -= smallsPerFftElement;
-			}
-
-			// Finish off any remainder.
-			for (; outBufIdx < bufferLen; ++outBufIdx) {
-				fftBuffer[outBufIdx] = { smallDigitBuffer, 0.0 };
-				smallDigitBuffer = 0;
-			}
-		}
+	FFT::RoundOffStats FFT::getRoundOffStats(std::size_t sizeClass) const
+	{
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		return m_roundOffStats.at(sizeClass);
 	}
 
-	void FFT::applyWeight(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize)
+	// Private members.
+	void FFT::loadWeighted(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t bufferLen,
+		Memory::SafePtr<Digit> num, std::size_t numLen, std::size_t firstElement,
+		std::size_t smallsPerFftElement)
 	{
-		// Apply the right-angle weight to the input buffer sequence.
-		for (std::size_t i(0); i < fftSize; ++i) {
-			// Assumes the input sequence is purely real-valued.
-			// NB: it might help tp precompute these weights
-			Fft::Complex::Cplex t { fftBuffer[i].r * cos(M_PI * i / (2 * fftSize)), fftBuffer[i].r
-				* sin(M_PI * i / (2 * fftSize)) };
+		// When loading the FFT buffer, we use the so-called "right-angle" convolution, which
+		// means we premultiply all inputs by powers of i^(1/N) (i is the unit imaginary number).
+		// This, in effect, is a type of discrete weighted transform (DWT), which we can use to
+		// cause the elements of the FFT output to "fold over" so that the first half of the
+		// product sequence is in the real part of the output, and the second half in the imaginary
+		// part. This allows us to save a factor of 2 on transform size, thus both memory and
+		// time. It does mean we have to take care when extracting the product. We apply the
+		// weights as we load so the buffer is only written once.
+		const Fft::Complex::TwiddleTable &omega(*m_twiddles);
+		RightAngleWeights weights(getRightAngleWeights(m_twiddles->getSize(), bufferLen, false));
+
+		// The parameter smallsPerFftElement allows us to stretch the FFT multiplication to larger
+		// lengths than would otherwise be permitted by rounding error by packing fewer small digits
+		// (i.e. base-BASE_MINOR) per element than the input, fed in base-BASE, has directly; it is
+		// calculated by calcSmallsPerElement.
+		//
+		// The same folding works on the inputs: as x^N = i, any elements of a truncated transform
+		// past the transform length N go in the imaginary parts of the first ones.
+		std::size_t numElements(calcElementCount(numLen, smallsPerFftElement) - firstElement);
+		std::size_t foldLen((numElements > bufferLen) ? numElements - bufferLen : 0);
+
+		m_threadPool->parallelForRange(bufferLen, PARALLEL_GRAIN,
+			[&](std::size_t begin, std::size_t end, std::size_t) {
+				std::size_t foldEnd(std::min(end, std::max(begin, foldLen)));
+				std::size_t loadEnd(std::min(end, std::max(begin, numElements)));
+				ElementReader low(m_smallBases, num, numLen, smallsPerFftElement,
+					firstElement + begin);
+
+				if (foldEnd > begin) {
+					ElementReader high(m_smallBases, num, numLen, smallsPerFftElement,
+						firstElement + bufferLen + begin);
+					for (std::size_t i(begin); i < foldEnd; ++i) {
+						Fft::Complex::Cplex x { static_cast<double>(low.next()),
+							static_cast<double>(high.next()) };
+						fftBuffer[i] = applyWeightAt(omega, weights, i, x);
+					}
+				}
 
-			fftBuffer[i] = t;
-		}
+				for (std::size_t i(foldEnd); i < loadEnd; ++i) {
+					fftBuffer[i] = applyWeightAt(omega, weights, i, static_cast<double>(low.next()));
+				}
+
+				for (std::size_t i(loadEnd); i < end; ++i) {
+					fftBuffer[i] = { 0.0, 0.0 };
+				}
+			});
 	}
 
 	void FFT::convolute(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer1,
-		Memory::SafePtr<Fft::Complex::Cplex> fftBuffer2, std::size_t bufferLen)
+		Memory::SafePtr<const Fft::Complex::Cplex> fftBuffer2, std::size_t bufferLen)
 	{
-		for (std::size_t i(0); i < bufferLen; ++i) {
-			double tmpR = fftBuffer1[i].r * fftBuffer2[i].r - fftBuffer1[i].i * fftBuffer2[i].i;
-			double tmpI = fftBuffer1[i].r * fftBuffer2[i].i + fftBuffer1[i].i * fftBuffer2[i].r;
-
-			fftBuffer1[i].r = tmpR;
-			fftBuffer1[i].i = tmpI;
-		}
+		m_threadPool->parallelForRange(bufferLen, PARALLEL_GRAIN,
+			[&](std::size_t begin, std::size_t end, std::size_t) {
+				for (std::size_t i(begin); i < end; ++i) {
+					double tmpR = fftBuffer1[i].r * fftBuffer2[i].r - fftBuffer1[i].i * fftBuffer2[i].i;
+					double tmpI = fftBuffer1[i].r * fftBuffer2[i].i + fftBuffer1[i].i * fftBuffer2[i].r;
+
+					fftBuffer1[i].r = tmpR;
+					fftBuffer1[i].i = tmpI;
+				}
+			});
 	}
 
-	void FFT::removeWeight(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize)
+	double FFT::extractUnweighted(Memory::SafePtr<Digit> digitBuffer, std::size_t digitsToGet,
+		Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize,
+		std::size_t smallsPerFftElement, const std::vector<double> &top)
 	{
-		for (std::size_t i(0); i < fftSize; ++i) {
-			// now can no longer assume real-valued
-			Fft::Complex::Cplex w { cos(-M_PI * i / (2 * fftSize)), sin(-M_PI * i / (2 * fftSize)) };
-			Fft::Complex::Cplex t { fftBuffer[i].r * w.r - fftBuffer[i].i * w.i, fftBuffer[i].r * w.i
-				+ fftBuffer[i].i * w.r };
-
-			fftBuffer[i] = t;
+		switch (smallsPerFftElement) {
+			case 2:
+				return extractUnweighted<2>(digitBuffer, digitsToGet, fftBuffer, fftSize, top);
+			case 3:
+				return extractUnweighted<3>(digitBuffer, digitsToGet, fftBuffer, fftSize, top);
+			case 4:
+				return extractUnweighted<4>(digitBuffer, digitsToGet, fftBuffer, fftSize, top);
+			default:
+				throw SDF::Exceptions::Exception("ERROR: Unsupported FFT element packing!");
 		}
 	}
 
-	void FFT::extractProduct(Memory::SafePtr<Digit> digitBuffer, std::size_t digitsToGet,
+	template<std::size_t smalls>
+	double FFT::extractUnweighted(Memory::SafePtr<Digit> digitBuffer, std::size_t digitsToGet,
 		Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize,
-		std::size_t smallsPerFftElement)
+		const std::vector<double> &top)
 	{
-		if (smallsPerFftElement == DIGS_PER_DIG) {
-			double carry(0);
-			for (std::size_t i(0); i < digitsToGet; ++i) {
-				// divide by the FFT size; the FFT leaves the product terms multiplied by it
-				double tmp(0.0);
-				if (i < fftSize) { // unwrap the right-angle convolution
-					tmp = floor((fftBuffer[i].r / fftSize) + 0.5);
-				} else {
-					tmp = floor((fftBuffer[i - fftSize].i / fftSize) + 0.5);
+		// The inverse weights also divide by the FFT size; the FFT leaves the product terms
+		// multiplied by it.
+		const Fft::Complex::TwiddleTable &omega(*m_twiddles);
+		RightAngleWeights weights(getRightAngleWeights(m_twiddles->getSize(), fftSize, true));
+
+		// Unwrapping the right-angle convolution, the real parts of the elements are the low half of
+		// the product and the imaginary parts the high half. If the transform was truncated, the
+		// top of the product wrapped around (negated, as x^(2N) = -1) onto the bottom, and follows
+		// as a third section; we add it back in as we go. If the sections meet on Digit
+		// boundaries, we cut the elements into stretches that also begin on Digit boundaries, and
+		// release the carries in each section of each stretch independently, in parallel. A fix-up
+		// pass then carries the top of each stretch into the next, in order, and the top of each
+		// section into the next. These carries almost always die out within a Digit or two. If the
+		// sections don't meet on boundaries, we must go through the elements in order.
+		static const std::size_t c_numSections = 3;
+
+		std::size_t split((fftSize * smalls) / DIGS_PER_DIG);
+		std::size_t topLen(top.size());
+		double maxError(0.0);
+
+		if ((fftSize * smalls) % DIGS_PER_DIG == 0) {
+			std::size_t sectionLen[c_numSections];
+			for (std::size_t s(0); s < c_numSections; ++s) {
+				std::size_t sectionBegin(s * split);
+				sectionLen[s] = (digitsToGet > sectionBegin) ? digitsToGet - sectionBegin : 0;
+				if ((s + 1 < c_numSections) && (sectionLen[s] > split)) {
+					sectionLen[s] = split;
 				}
+			}
 
-				// release carries
-				tmp += carry;
-				carry = floor(tmp / BASE);
-				tmp -= carry * BASE;
-
-				digitBuffer[i] = tmp;
+			// The Digits each stretch covers in each section, and the carries out of them, indexed
+			// by the stretch's first element over PARALLEL_GRAIN.
+			struct Stretch {
+				bool used;
+				std::size_t begin[c_numSections], end[c_numSections];
+				TwoDigit carry[c_numSections];
+				double maxError;
+			};
+
+			std::vector<Stretch> stretches((fftSize + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN,
+				Stretch { false, {}, {}, {}, 0.0 });
+
+			m_threadPool->parallelForRange(fftSize, PARALLEL_GRAIN,
+				[&](std::size_t begin, std::size_t end, std::size_t) {
+					Stretch &stretch(stretches[begin / PARALLEL_GRAIN]);
+					std::size_t digBegin((begin * smalls) / DIGS_PER_DIG);
+					// The last stretch also takes any Digits past the last element, for the carries.
+					std::size_t digEnd((end == fftSize) ? digitsToGet : (end * smalls) / DIGS_PER_DIG);
+
+					stretch.used = true;
+					for (std::size_t s(0); s < c_numSections; ++s) {
+						stretch.begin[s] = (s * split) + std::min(digBegin, sectionLen[s]);
+						stretch.end[s] = (s * split) + std::min(digEnd, sectionLen[s]);
+					}
+
+					if (digBegin >= sectionLen[0]) {
+						return; // all of it is beyond what was asked for
+					}
+
+					DigitPacker<smalls> low(digitBuffer + stretch.begin[0],
+						stretch.end[0] - stretch.begin[0]);
+					if (sectionLen[1] > digBegin) {
+						DigitPacker<smalls> high(digitBuffer + stretch.begin[1],
+							stretch.end[1] - stretch.begin[1]);
+
+						for (std::size_t i(begin); i < end; ++i) {
+							Fft::Complex::Cplex x(removeWeightAt(omega, weights, i, fftBuffer[i]));
+							low.push(roundElement(x.r, stretch.maxError) +
+								((i < topLen) ? top[i] : 0.0));
+							high.push(roundElement(x.i, stretch.maxError) +
+								((fftSize + i < topLen) ? top[fftSize + i] : 0.0));
+						}
+
+						stretch.carry[1] = high.finish();
+					} else {
+						for (std::size_t i(begin); i < end; ++i) {
+							low.push(roundElement(removeWeightAt(omega, weights, i, fftBuffer[i]).r,
+								stretch.maxError) + ((i < topLen) ? top[i] : 0.0));
+						}
+					}
+
+					stretch.carry[0] = low.finish();
+
+					if (sectionLen[2] > digBegin) {
+						DigitPacker<smalls> wrapped(digitBuffer + stretch.begin[2],
+							stretch.end[2] - stretch.begin[2]);
+
+						// Past the last element, push zeroes to flush out the carries.
+						for (std::size_t i(begin); !wrapped.isFull(); ++i) {
+							wrapped.push((i < topLen) ? top[i] : 0.0);
+						}
+
+						stretch.carry[2] = wrapped.finish();
+					}
+				});
+
+			// Fix up: carry into each stretch of each section in turn.
+			TwoDigit carry(0);
+			for (std::size_t s(0); s < c_numSections; ++s) {
+				for (const Stretch &stretch : stretches) {
+					if (!stretch.used) {
+						continue;
+					}
+
+					maxError = std::max(maxError, stretch.maxError);
+
+					// The carries may be negative if the product wrapped around with nothing
+					// added back in.
+					std::size_t i(stretch.begin[s]);
+					for (; (carry != 0) && (i < stretch.end[s]); ++i) {
+						carry += digitBuffer[i];
+						TwoDigit digit(carry % static_cast<TwoDigit>(BASE));
+						if (digit < 0) {
+							digit += BASE;
+						}
+
+						digitBuffer[i] = digit;
+						carry = (carry - digit) / static_cast<TwoDigit>(BASE);
+					}
+
+					carry += stretch.carry[s];
+				}
 			}
 		} else {
-			// Repack the elements while extracting.
-			double carry(0);
-			TwoDigit smallDigitBuffer(0);
-			std::size_t smallsInBuffer(0);
-			std::size_t outBufIdx(0);
-			for (std::size_t i(0); (i < (2 * fftSize)) && (outBufIdx < digitsToGet); ++i) {
-				// divide by the FFT size; the FFT leaves the product terms multiplied by it
-				double tmp(0.0);
-				if (i < fftSize) { // unwrap the right-angle convolution
-					tmp = floor((fftBuffer[i].r / fftSize) + 0.5);
-				} else {
-					tmp = floor((fftBuffer[i - fftSize].i / fftSize) + 0.5);
-				}
+			DigitPacker<smalls> all(digitBuffer, digitsToGet);
 
-				// release carries
-				tmp += carry;
-				carry = floor(tmp / m_smallBases[smallsPerFftElement]);
-				tmp -= carry * m_smallBases[smallsPerFftElement];
+			for (std::size_t i(0); (i < fftSize) && !all.isFull(); ++i) {
+				all.push(roundElement(removeWeightAt(omega, weights, i, fftBuffer[i]).r, maxError) +
+					((i < topLen) ? top[i] : 0.0));
+			}
 
-				// buffer it
-				smallDigitBuffer += m_smallBases[smallsInBuffer] * tmp;
-				smallsInBuffer += smallsPerFftElement;
+			for (std::size_t i(0); (i < fftSize) && !all.isFull(); ++i) {
+				all.push(roundElement(removeWeightAt(omega, weights, i, fftBuffer[i]).i, maxError) +
+					((fftSize + i < topLen) ? top[fftSize + i] : 0.0));
+			}
 
-				if (smallsInBuffer >= DIGS_PER_DIG) {
-					digitBuffer[outBufIdx] = smallDigitBuffer % BASE;
-					smallDigitBuffer /= BASE;
-					smallsInBuffer -= DIGS_PER_DIG;
-					++outBufIdx;
-				}
+			for (std::size_t i(0); !all.isFull(); ++i) {
+				all.push((i < topLen) ? top[i] : 0.0);
 			}
 
-			for (; outBufIdx < digitsToGet; ++outBufIdx) {
-				digitBuffer[outBufIdx] = smallDigitBuffer;
-				smallDigitBuffer = 0;
+			all.finish();
+		}
+
+		return maxError;
+	}
+
+	double FFT::extractCoefficients(std::vector<double> &dst, std::size_t first,
+		Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize,
+		const std::vector<double> &top)
+	{
+		const Fft::Complex::TwiddleTable &omega(*m_twiddles);
+		RightAngleWeights weights(getRightAngleWeights(m_twiddles->getSize(), fftSize, true));
+		std::size_t last(first + dst.size());
+		std::size_t topLen(top.size());
+
+		// As in extractUnweighted, the real parts are the low half of the product, the imaginary
+		// parts the high half, and the wrapped-around top has to be added back in. The largest
+		// round-off error is kept for each stretch, by its first element over PARALLEL_GRAIN.
+		std::vector<double> maxErrors((fftSize + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN, 0.0);
+		auto put = [&](std::size_t t, double x, double &maxError) {
+			if ((t >= first) && (t < last)) {
+				dst[t - first] = roundElement(x, maxError) + ((t < topLen) ? top[t] : 0.0);
 			}
+		};
+
+		std::size_t skip((first > fftSize) ? first - fftSize : 0);
+		m_threadPool->parallelForRange(fftSize, PARALLEL_GRAIN,
+			[&](std::size_t begin, std::size_t end, std::size_t) {
+				double &maxError(maxErrors[begin / PARALLEL_GRAIN]);
+				for (std::size_t i(std::max(begin, skip)); i < end; ++i) {
+					Fft::Complex::Cplex x(removeWeightAt(omega, weights, i, fftBuffer[i]));
+					put(i, x.r, maxError);
+					put(fftSize + i, x.i, maxError);
+				}
+			});
+
+		for (std::size_t t(std::max(first, 2 * fftSize)); t < last; ++t) {
+			dst[t - first] = top[t - (2 * fftSize)];
 		}
+
+		return *std::max_element(maxErrors.begin(), maxErrors.end());
 	}
 
 // Private helper members.
 	std::size_t FFT::calcSmallsPerElement(std::size_t prodSize)
+	{
+		// Pack as densely as the round-off error seen so far allows, so long as the product would
+		// still fit in the buffers at the next density down, should it have to be redone there.
+		for (std::size_t smalls(MAX_SMALLS); smalls > MIN_SMALLS; --smalls) {
+			if (calcElementCount(prodSize, smalls - 1) > 2 * m_maxFftSize) {
+				return smalls;
+			}
+
+			if (isDensitySafe(prodSize, smalls)) {
+				return smalls;
+			}
+		}
+
+		return MIN_SMALLS;
+	}
+
+	bool FFT::isDensitySafe(std::size_t prodSize, std::size_t smallsPerElement) const
+	{
+		// Until there is something to go by, only pack as densely as is safe for any numbers.
+		double predicted(predictRoundOff(prodSize, smallsPerElement));
+		if (predicted < 0.0) {
+			return calcWorstCaseSmallsPerElement(prodSize) >= smallsPerElement;
+		}
+
+		return predicted < ROUNDOFF_TARGET;
+	}
+
+	std::size_t FFT::calcWorstCaseSmallsPerElement(std::size_t prodSize)
 	{
 		// This is based on the observation that the size of the largest element in the multiplication
 		// pyramid is given by:
@@ -383,83 +867,448 @@ namespace SDF::Bignum::Multiplication
 		//    Max Factor Size = 2^(53 - 2 lg(BASE-1))
 		//
 		// and we use hand tweaked factors so we can adjust for the possibility of any extra
-		// rounding error in the FFT math itself.
+		// rounding error in the FFT math itself. As the elements are balanced (see ElementReader),
+		// BASE-1 above is really BASE/2, which buys 2 bits. For most numbers the error grows only
+		// like the square root of the length, but these factors are set so that even numbers
+		// whose elements are all just under half the element base, the worst case for balanced
+		// elements, round off by under a third.
 
 		// Note: if BASE is changed, one will need to recalculate these factors. These assume
 		//       BASE == 456976. If we want to change BASE frequently, we might want to automate this.
 		std::size_t factorSize((prodSize / 2) + (prodSize % 2));
-		if (factorSize <= 4096) {
+		if (factorSize <= 8192) {
 			return 4;
-		} else if (factorSize <= 2097152) {
+		} else if (factorSize <= 3145728) {
 			return 3;
 		} else {
 			return 2;
 		}
 	}
 
+	std::size_t FFT::calcElementCount(std::size_t numLen, std::size_t smallsPerElement)
+	{
+		std::size_t elementCount((numLen * DIGS_PER_DIG) / smallsPerElement);
+		if ((numLen * DIGS_PER_DIG) % smallsPerElement) {
+			++elementCount; // round up
+		}
+
+		return elementCount;
+	}
+
+	std::size_t FFT::calcSizeClass(std::size_t prodSize)
+	{
+		std::size_t sizeClass(0);
+		while ((prodSize >> (sizeClass + 1)) != 0) {
+			++sizeClass;
+		}
+
+		return sizeClass;
+	}
+
+	double FFT::predictRoundOff(std::size_t prodSize, std::size_t smallsPerElement) const
+	{
+		// The error goes as the square of the largest element, which is half the element base as
+		// they are balanced, so what was seen at one density scales to the others. For most
+		// numbers it grows by about one and a half times each time the product doubles; allow
+		// for twice, going from the nearest size class below that has been seen.
+		double halfBase(0.5 * m_smallBases[smallsPerElement]);
+		double growth(1.0);
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		for (std::size_t sizeClass(calcSizeClass(prodSize) + 1); sizeClass-- > 0; growth *= 2.0) {
+			const RoundOffStats &stats(m_roundOffStats[sizeClass]);
+			double worst(-1.0);
+			for (std::size_t smalls(MIN_SMALLS); smalls <= MAX_SMALLS; ++smalls) {
+				if (stats.products[smalls] != 0) {
+					double statsHalfBase(0.5 * m_smallBases[smalls]);
+					worst = std::max(worst, stats.maxError[smalls] / (statsHalfBase * statsHalfBase));
+				}
+			}
+
+			if (worst >= 0.0) {
+				return worst * halfBase * halfBase * growth;
+			}
+		}
+
+		return -1.0;
+	}
+
+	bool FFT::checkRoundOff(std::size_t prodSize, std::size_t smallsPerElement, double roundOff)
+	{
+		// The lock is let go while calcSmallsPerElement reads the telemetry back.
+		std::size_t sizeClass(calcSizeClass(prodSize));
+		{
+			std::lock_guard<std::mutex> lock(m_statsMutex);
+			RoundOffStats &stats(m_roundOffStats[sizeClass]);
+			++stats.products[smallsPerElement];
+			stats.maxError[smallsPerElement] = std::max(stats.maxError[smallsPerElement], roundOff);
+		}
+
+		if (roundOff < ROUNDOFF_RETRY) {
+			return true;
+		}
+
+		// Having seen this, calcSmallsPerElement will go for a lower density, unless there is none.
+		if (calcSmallsPerElement(prodSize) >= smallsPerElement) {
+			throw SDF::Exceptions::Exception("FFT round-off error too large to multiply reliably");
+		}
+
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		++m_roundOffStats[sizeClass].retries;
+		return false;
+	}
+
+	bool FFT::mayTruncate(std::size_t prodSize, std::size_t smallsPerElement)
+	{
+		// With their inputs folded over, truncated transforms come out with up to half as much
+		// round-off error again as full ones. Only truncate where the packing would still do for a
+		// product twice as long.
+		return isDensitySafe(2 * prodSize, smallsPerElement);
+	}
+
+	std::size_t FFT::planTruncation(std::size_t prodElements, std::size_t largerElements,
+		bool allowTruncation) const
+	{
+		// Either transform at the shortest length that holds both factors whole, or at a shorter
+		// one, folding them over and letting the top of the product wrap around to be worked out on
+		// its own. The work estimates are only rough flop counts. For the folding to work, no
+		// factor may be more than twice the length, nor the wrapped-around part longer than the
+		// length. Factors too long for the buffers are folded regardless; the product still fits.
+		std::size_t fullLen(m_fft->getNearestSafeLengthTo(std::max(largerElements,
+			(prodElements / 2) + (prodElements % 2))));
+		fullLen = std::min(fullLen, m_maxFftSize);
+		if (!allowTruncation) {
+			return fullLen;
+		}
+
+		std::size_t bestLen(fullLen);
+		double bestWork(estimateTransformWork(fullLen));
+
+		std::size_t minLen(std::max((largerElements / 2) + (largerElements % 2),
+			(prodElements + 2) / 3));
+		for (std::size_t len(m_fft->getNearestSafeLengthTo(minLen)); len < fullLen;
+			len = m_fft->getNearestSafeLengthTo(len + 1))
+		{
+			std::size_t topLen((prodElements > 2 * len) ? prodElements - (2 * len) : 0);
+			double work(estimateTransformWork(len) + ((topLen <= TOP_CLASSICAL_LIMIT) ?
+				static_cast<double>(topLen * topLen) :
+				estimateTransformWork(m_fft->getNearestSafeLengthTo(topLen))));
+
+			if (work < bestWork) {
+				bestWork = work;
+				bestLen = len;
+			}
+		}
+
+		return bestLen;
+	}
+
+	std::size_t FFT::planChunks(std::size_t longLen, std::size_t shortLen)
+	{
+		// Against the work of the whole product at once - three transforms, two loads and an
+		// unspooling at the length mulCore would use, leaving aside any top worked out separately -
+		// set that of cutting it into k chunks, each taking two transforms at a length N where the
+		// chunk and the short number together fill the 2N elements, a load, an unspooling and an
+		// add, plus a transform and a load for the short number, once. The chunk products are
+		// packed as products of about twice the short number's length would be. Since the passes
+		// besides the transforms cost about the same per element whichever way, chunking only
+		// pays where the short number is short enough that the transforms saved count.
+		if ((shortLen == 0) || (longLen < 2 * shortLen)) {
+			return 0;
+		}
+
+		std::size_t prodSize(longLen + shortLen);
+		std::size_t fullSmalls(calcSmallsPerElement(prodSize));
+		std::size_t longElements(calcElementCount(longLen, fullSmalls));
+		std::size_t fullLen(planTruncation(longElements + calcElementCount(shortLen, fullSmalls) - 1,
+			longElements, mayTruncate(prodSize, fullSmalls)));
+		double bestWork((3.0 * estimateTransformWork(fullLen)) +
+			(((2.0 * c_loadWork) + c_extractWork) * fullLen));
+
+		std::size_t smallsPerElement(calcSmallsPerElement(2 * shortLen));
+		std::size_t shortElements(calcElementCount(shortLen, smallsPerElement));
+		std::size_t bestChunkLen(0);
+		for (std::size_t len(m_fft->getNearestSafeLengthTo(std::max(MIN_CHUNK_FFT_SIZE,
+			(shortElements / 2) + 1))); len < fullLen; len = m_fft->getNearestSafeLengthTo(len + 1))
+		{
+			std::size_t chunkLen((((2 * len) - shortElements + 1) * smallsPerElement) /
+				DIGS_PER_DIG);
+			if (chunkLen >= longLen) {
+				break;
+			}
+
+			double chunks(static_cast<double>((longLen + chunkLen - 1) / chunkLen));
+			double work(((1.0 + (2.0 * chunks)) * estimateTransformWork(len)) +
+				((1.0 + chunks) * c_loadWork * len) +
+				(chunks * (c_extractWork + c_addWork) * len));
+			if (work < bestWork) {
+				bestWork = work;
+				bestChunkLen = chunkLen;
+			}
+		}
+
+		return bestChunkLen;
+	}
+
+	void FFT::wrappedProduct(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer1,
+		Memory::SafePtr<Fft::Complex::Cplex> fftBuffer2, std::size_t fftSize,
+		Memory::SafePtr<Digit> a, std::size_t aLen, std::size_t aFirst, Memory::SafePtr<Digit> b,
+		std::size_t bLen, std::size_t bFirst, std::size_t smallsPerElement, bool square)
+	{
+		if (square) {
+			loadWeighted(fftBuffer1, fftSize, a, aLen, aFirst, smallsPerElement);
+			m_fft->doFwdTransform(fftBuffer1, fftSize);
+			convolute(fftBuffer1, fftBuffer1, fftSize);
+		} else {
+			// Load and transform the two numbers side by side. The passes inside each are parallel
+			// too, so any threads left idle by one of them help out with the other.
+			m_threadPool->parallelFor(2, [&](std::size_t which, std::size_t) {
+				if (which == 0) {
+					loadWeighted(fftBuffer1, fftSize, a, aLen, aFirst, smallsPerElement);
+					m_fft->doFwdTransform(fftBuffer1, fftSize);
+				} else {
+					loadWeighted(fftBuffer2, fftSize, b, bLen, bFirst, smallsPerElement);
+					m_fft->doFwdTransform(fftBuffer2, fftSize);
+				}
+			});
+
+			convolute(fftBuffer1, fftBuffer2, fftSize);
+		}
+
+		m_fft->doRevTransform(fftBuffer1, fftSize);
+	}
+
+	double FFT::productTop(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+		std::size_t bLen, std::size_t smallsPerElement, std::size_t count, bool square,
+		std::vector<double> &dst)
+	{
+		// The top count coefficients of a product only involve the top count elements of each
+		// factor, so this is the top half of a product of those.
+		std::size_t aFirst(calcElementCount(aLen, smallsPerElement) - count);
+		std::size_t bFirst(calcElementCount(bLen, smallsPerElement) - count);
+
+		dst.assign(count, 0.0);
+
+		if (count <= TOP_CLASSICAL_LIMIT) {
+			// Few enough to just multiply out. The sums are small enough to be exact.
+			std::vector<double> aTop(count), bTop(count);
+			ElementReader aReader(m_smallBases, a, aLen, smallsPerElement, aFirst);
+			ElementReader bReader(m_smallBases, b, bLen, smallsPerElement, bFirst);
+			for (std::size_t i(0); i < count; ++i) {
+				aTop[i] = aReader.next();
+				bTop[i] = bReader.next();
+			}
+
+			for (std::size_t t(0); t < count; ++t) {
+				for (std::size_t i(t); i < count; ++i) {
+					dst[t] += aTop[i] * bTop[count - 1 + t - i];
+				}
+			}
+
+			return 0.0;
+		}
+
+		// Otherwise this is itself a product we can truncate.
+		std::size_t prodElements((2 * count) - 1);
+		std::size_t fftSize(planTruncation(prodElements, count, true));
+
+		std::vector<double> top;
+		double roundOff(0.0);
+		if (prodElements > 2 * fftSize) {
+			roundOff = productTop(a, aLen, b, bLen, smallsPerElement, prodElements - (2 * fftSize),
+				square, top);
+		}
+
+		auto buffer1(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		auto buffer2(m_scratch->borrow<Fft::Complex::Cplex>(square ? 0 : fftSize));
+
+		wrappedProduct(buffer1.accessData(0), square ? buffer1.accessData(0) : buffer2.accessData(0),
+			fftSize, a, aLen, aFirst, b, bLen, bFirst, smallsPerElement, square);
+		return std::max(roundOff, extractCoefficients(dst, count - 1, buffer1.accessData(0), fftSize,
+			top));
+	}
+
 // Private member.
-	void FFT::mulCore(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
-		std::size_t bLen)
+	bool FFT::mulPreparedCore(Memory::SafePtr<Digit> result, const PreparedFft &prepared,
+		Memory::SafePtr<Digit> b, std::size_t bLen)
 	{
-		// Load the numbers into the buffers. Because we are using the right-angle convolution,
-		// we should use the larger factor as the buffer size.
-		std::size_t prodSize(aLen + bLen);
-		std::size_t largerSize(std::max(aLen, bLen));
-		std::size_t smallsPerElement(calcSmallsPerElement(prodSize));
-		std::size_t expandedLargerSize = (largerSize * DIGS_PER_DIG) / smallsPerElement;
-		if ((largerSize * DIGS_PER_DIG) % smallsPerElement) {
-			++expandedLargerSize; // round up
+		std::size_t prodSize(prepared.getLength() + bLen);
+		std::size_t smallsPerElement(prepared.smallsPerElement);
+		std::size_t prodElements(calcElementCount(prepared.getLength(), smallsPerElement) +
+			calcElementCount(bLen, smallsPerElement) - 1);
+		std::size_t fftSize(prepared.fftSize);
+
+		std::vector<double> top;
+		double roundOff(0.0);
+		if (prodElements > 2 * fftSize) {
+			roundOff = productTop(prepared.getDigits(), prepared.getLength(), b, bLen,
+				smallsPerElement, prodElements - (2 * fftSize), false, top);
 		}
-		std::size_t safeSize(m_fft->getNearestSafeLengthTo(expandedLargerSize));
 
-		Memory::SafePtr<Fft::Complex::Cplex> num1BufPtr(m_num1FFTBuffer->accessData(0));
-		Memory::SafePtr<Fft::Complex::Cplex> num2BufPtr(m_num2FFTBuffer->accessData(0));
+		auto num1Buf(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		Memory::SafePtr<Fft::Complex::Cplex> num1BufPtr(num1Buf.accessData(0));
+		loadWeighted(num1BufPtr, fftSize, b, bLen, 0, smallsPerElement);
+		m_fft->doFwdTransform(num1BufPtr, fftSize);
+		convolute(num1BufPtr, prepared.transform.accessData(0), fftSize);
+		m_fft->doRevTransform(num1BufPtr, fftSize);
 
-		loadBuffer(num1BufPtr, safeSize, a, aLen, smallsPerElement);
-		loadBuffer(num2BufPtr, safeSize, b, bLen, smallsPerElement);
+		roundOff = std::max(roundOff, extractUnweighted(result, prodSize, num1BufPtr, fftSize,
+			smallsPerElement, top));
+		return checkRoundOff(prodSize, smallsPerElement, roundOff);
+	}
 
-		applyWeight(num1BufPtr, safeSize);
-		applyWeight(num2BufPtr, safeSize);
+	std::size_t FFT::mulInto(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a,
+		std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		if (aLen + bLen > m_maxProdSize) {
+			throw SDF::Exceptions::Exception("Requested FFT multiply of numbers that were too big :(");
+		}
 
-		// Do the FFT multiplication itself.
-		m_fft->doFwdTransform(num1BufPtr, safeSize);
-		m_fft->doFwdTransform(num2BufPtr, safeSize);
+		// Put the longer number first, for the chunked product.
+		if (aLen < bLen) {
+			std::swap(a, b);
+			std::swap(aLen, bLen);
+		}
 
-		convolute(num1BufPtr, num2BufPtr, safeSize);
+		// There is no need to smooth the performance around the transform size steps: mulCore
+		// truncates the transforms so their cost follows the product length.
+		std::size_t prodSize(aLen + bLen);
+		std::size_t chunkLen(planChunks(aLen, bLen));
+		if (chunkLen != 0) {
+			// The round-off goes with the size of the chunk products, not the whole one.
+			std::size_t chunkProdSize(chunkLen + bLen);
+			std::size_t smallsPerElement(calcSmallsPerElement(chunkProdSize));
+			while (!checkRoundOff(chunkProdSize, smallsPerElement,
+				mulChunked(result, a, aLen, b, bLen, chunkLen, smallsPerElement)))
+			{
+				smallsPerElement = calcSmallsPerElement(chunkProdSize);
+			}
+		} else {
+			std::size_t smallsPerElement(calcSmallsPerElement(prodSize));
+			while (!checkRoundOff(prodSize, smallsPerElement,
+				mulCore(result, a, aLen, b, bLen, smallsPerElement)))
+			{
+				smallsPerElement = calcSmallsPerElement(prodSize);
+			}
+		}
 
-		m_fft->doRevTransform(num1BufPtr, safeSize);
+		// Report the product size.
+		return (result[prodSize - 1] == 0) ? prodSize - 1 : prodSize;
+	}
+
+	double FFT::mulCore(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a,
+		std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen, std::size_t smallsPerElement)
+	{
+		// Because we are using the right-angle convolution, the transform need only be half the
+		// length of the product. Rather than pad up to the next length the transforms allow, we may
+		// truncate to a shorter one and work out the part of the product that wraps around
+		// separately, so the cost tracks the product length smoothly.
+		std::size_t prodSize(aLen + bLen);
+		std::size_t aElements(calcElementCount(aLen, smallsPerElement));
+		std::size_t bElements(calcElementCount(bLen, smallsPerElement));
+		std::size_t prodElements((aElements + bElements > 1) ? aElements + bElements - 1 : 1);
+		std::size_t fftSize(planTruncation(prodElements, std::max(aElements, bElements),
+			mayTruncate(prodSize, smallsPerElement)));
+
+		std::vector<double> top;
+		double roundOff(0.0);
+		if (prodElements > 2 * fftSize) {
+			roundOff = productTop(a, aLen, b, bLen, smallsPerElement, prodElements - (2 * fftSize),
+				false, top);
+		}
+
+		auto num1Buf(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		auto num2Buf(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		Memory::SafePtr<Fft::Complex::Cplex> num1BufPtr(num1Buf.accessData(0));
+
+		wrappedProduct(num1BufPtr, num2Buf.accessData(0), fftSize, a, aLen, 0, b, bLen, 0,
+			smallsPerElement, false);
 
 		// Unspool the result and release the carries.
-		removeWeight(num1BufPtr, safeSize);
+		return std::max(roundOff, extractUnweighted(result, prodSize, num1BufPtr, fftSize,
+			smallsPerElement, top));
+	}
 
-		Memory::SafePtr<Digit> resultPtr(m_productDigits.accessData(0));
-		extractProduct(resultPtr, prodSize, num1BufPtr, safeSize, smallsPerElement);
+	double FFT::mulChunked(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a,
+		std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen, std::size_t chunkLen,
+		std::size_t smallsPerElement)
+	{
+		// Transform b once, at a length that holds its product with a whole chunk, then run
+		// through the chunks of a, multiplying each by it and adding the product in at the
+		// chunk's place. Each chunk is read as a number on its own, so the products are exact and
+		// their sum is the whole product. They overlap by bLen digits.
+		std::size_t prodSize(aLen + bLen);
+		std::size_t bElements(calcElementCount(bLen, smallsPerElement));
+		std::size_t chunkElements(calcElementCount(chunkLen, smallsPerElement));
+		std::size_t fftSize(m_fft->getNearestSafeLengthTo((chunkElements + bElements) / 2));
+		if (fftSize > m_maxFftSize) {
+			throw SDF::Exceptions::Exception("FFT chunk product too long for the transforms");
+		}
+
+		auto bTransform(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		Memory::SafePtr<Fft::Complex::Cplex> bTransformPtr(bTransform.accessData(0));
+		loadWeighted(bTransformPtr, fftSize, b, bLen, 0, smallsPerElement);
+		m_fft->doFwdTransform(bTransformPtr, fftSize);
+
+		auto chunkProduct(m_scratch->borrow<Digit>(chunkLen + bLen));
+		Memory::SafePtr<Digit> chunkProductPtr(chunkProduct.accessData(0));
+		auto num1Buf(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		Memory::SafePtr<Fft::Complex::Cplex> num1BufPtr(num1Buf.accessData(0));
+		Primitives::zeroize(result, prodSize);
+
+		double roundOff(0.0);
+		for (std::size_t origin(0); origin < aLen; origin += chunkLen) {
+			std::size_t len(std::min(chunkLen, aLen - origin));
+
+			loadWeighted(num1BufPtr, fftSize, a + origin, len, 0, smallsPerElement);
+			m_fft->doFwdTransform(num1BufPtr, fftSize);
+			convolute(num1BufPtr, bTransformPtr, fftSize);
+			m_fft->doRevTransform(num1BufPtr, fftSize);
+
+			roundOff = std::max(roundOff, extractUnweighted(chunkProductPtr, len + bLen, num1BufPtr,
+				fftSize, smallsPerElement, std::vector<double>()));
+			Primitives::propagateAdd(result + origin, prodSize - origin, chunkProductPtr,
+				len + bLen);
+		}
+
+		return roundOff;
 	}
 
-	void FFT::sqrCore(Memory::SafePtr<Digit> a, std::size_t aLen)
+	void FFT::sqrInto(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a, std::size_t aLen)
 	{
-		// Can save a transform when squaring
+		// We can save an FFT in this case.
 		std::size_t prodSize(aLen << 1);
 		std::size_t smallsPerElement(calcSmallsPerElement(prodSize));
-		std::size_t expandedASize = (aLen * DIGS_PER_DIG) / smallsPerElement;
-		if ((aLen * DIGS_PER_DIG) % smallsPerElement) {
-			++expandedASize; // round up
+		while (!checkRoundOff(prodSize, smallsPerElement,
+			sqrCore(result, a, aLen, smallsPerElement)))
+		{
+			smallsPerElement = calcSmallsPerElement(prodSize);
 		}
-		std::size_t safeSize(m_fft->getNearestSafeLengthTo(expandedASize));
-
-		Memory::SafePtr<Fft::Complex::Cplex> num1BufPtr(m_num1FFTBuffer->accessData(0));
-
-		loadBuffer(num1BufPtr, safeSize, a, aLen, smallsPerElement);
+	}
 
-		applyWeight(num1BufPtr, safeSize);
+	double FFT::sqrCore(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a,
+		std::size_t aLen, std::size_t smallsPerElement)
+	{
+		// Can save a transform when squaring
+		std::size_t prodSize(aLen << 1);
+		std::size_t aElements(calcElementCount(aLen, smallsPerElement));
+		std::size_t prodElements((aElements > 0) ? (2 * aElements) - 1 : 1);
+		std::size_t fftSize(planTruncation(prodElements, aElements,
+			mayTruncate(prodSize, smallsPerElement)));
+
+		std::vector<double> top;
+		double roundOff(0.0);
+		if (prodElements > 2 * fftSize) {
+			roundOff = productTop(a, aLen, a, aLen, smallsPerElement, prodElements - (2 * fftSize),
+				true, top);
+		}
 
-		m_fft->doFwdTransform(num1BufPtr, safeSize);
-		convolute(num1BufPtr, num1BufPtr, safeSize);
-		m_fft->doRevTransform(num1BufPtr, safeSize);
+		auto num1Buf(m_scratch->borrow<Fft::Complex::Cplex>(fftSize));
+		Memory::SafePtr<Fft::Complex::Cplex> num1BufPtr(num1Buf.accessData(0));
 
-		removeWeight(num1BufPtr, safeSize);
+		wrappedProduct(num1BufPtr, num1BufPtr, fftSize, a, aLen, 0, a, aLen, 0, smallsPerElement,
+			true);
 
-		Memory::SafePtr<Digit> resultPtr(m_productDigits.accessData(0));
-		extractProduct(resultPtr, prodSize, num1BufPtr, safeSize, smallsPerElement);
+		return std::max(roundOff, extractUnweighted(result, prodSize, num1BufPtr, fftSize,
+			smallsPerElement, top));
 	}
 }
@@ -28,14 +28,19 @@
 #include "../IMultiplicationStrategy.hpp"
 
 #include "../../memory/buffers/local/RAMOnly.hpp"
+#include "../../memory/buffers/local/ScratchPool.hpp"
 
-#include "../../memory/buffers/local/Punned.hpp"
+#include "../../util/ThreadPool.hpp"
 
 #include "FFT/complex/Cplex.hpp"
+#include "FFT/complex/FftPlanner.hpp"
+#include "FFT/complex/TwiddleTable.hpp"
 
 #include "FFT/complex/rad2Rec.hpp"
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace SDF::Bignum::Multiplication
 {
@@ -48,26 +53,99 @@ namespace SDF::Bignum::Multiplication
 	//             and the largest elements can overflow the size of the primitive data type
 	//             representing that element. There are a number of algorithms to defeat this, but
 	//             as it has to adapt, it causes the complexity to get worse). This particular method
-	//             performs FFTs on the complex field. TBA: finite field (NTT), rings Z_(2^N+1)
-	//             (aka Schonhage-Strassen method) for extremely huge computations.
+	//             performs FFTs on the complex field; see NTT for finite fields, and SSA for
+	//             the Schonhage-Strassen method for extremely huge computations. Every pass of the
+	//             multiplication - loading, transforming, convolving and releasing carries - is
+	//             spread over a thread pool. Transforms may be truncated short of the product
+	//             length, with the top of the product that wraps around worked out separately, so
+	//             the cost has no big steps between the transform lengths available. How many
+	//             digits go in each transform element is chosen from the round-off error seen in
+	//             earlier products of about the same size, and a product that comes out with too
+	//             much is redone with fewer. A long number times a much shorter one may be done a
+	//             chunk of the long one at a time, so the transforms are sized to the short one.
 	// Parameters: None.
 	class FFT : public IMultiplicationStrategy
 	{
 		public:
+			// Structure: RoundOffStats
+			// Purpose:   Telemetry on the round-off error, i.e. how far the elements of the
+			//            reverse-transformed products were from integers, for the products of one
+			//            size class. Both arrays are indexed by the number of base-BASE_MINOR digits
+			//            packed in each element.
+			struct RoundOffStats
+			{
+					std::size_t products[DIGS_PER_DIG + 1]; // products done at each packing
+					std::size_t retries; // products redone with fewer digits per element
+					double maxError[DIGS_PER_DIG + 1]; // largest error seen at each packing
+			};
+
+			// Number of size classes: products of from 2^k up to 2^(k+1) - 1 Digits are in class k.
+			static const std::size_t NUM_SIZE_CLASSES = 64;
+
 			// Function:  FFT
 			// Purpose:   Construct a new strategy object with a given maximum buffer size.
 			// Arguments: maxProdSize - The maximum multiplication size to allow.
-			FFT(std::size_t maxProdSize);
+			//            threadPool - The pool to run the multiplications on.
+			//            scratch - The pool to borrow scratch space from, shared with the other
+			//                      strategies.
+			FFT(std::size_t maxProdSize, Util::ThreadPool *threadPool,
+				Memory::Buffers::Local::ScratchPool *scratch);
 
-			void mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+			std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
 				std::size_t bLen);
-			void squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen);
+			std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen);
 
-			std::size_t getProductLength() const;
+			// The wrap-around falls out of the right-angle convolution, as x^(2N) = -1, so the
+			// transform need only be half the wrap length rather than half the product length.
+			std::size_t mulDigitsWrappedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen, std::size_t wrapLen);
 
-			void getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin, std::size_t length);
+			// The forward transform of a prepared operand is kept, so each product with it takes
+			// one forward transform instead of two.
+			std::unique_ptr<PreparedOperand> prepareOperand(Memory::SafePtr<Digit> a,
+				std::size_t aLen, std::size_t maxOtherLen);
+			std::size_t mulPreparedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, const PreparedOperand &a, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+
+			// Function:   getRoundOffStats
+			// Purpose:    Get the round-off error telemetry for a size class.
+			// Parameters: sizeClass - The size class, below NUM_SIZE_CLASSES.
+			// Returns:    A copy of the telemetry, as products on other threads may update it.
+			RoundOffStats getRoundOffStats(std::size_t sizeClass) const;
 		private:
-			static const std::size_t THRESHOLD_SMOOTHING = 4;
+			// Fewest and most base-BASE_MINOR digits to pack in each element.
+			static const std::size_t MIN_SMALLS = 2;
+			static const std::size_t MAX_SMALLS = 4;
+
+			// Round-off error to keep products under when choosing how densely to pack them, and
+			// the error past which a product is redone at a lower density, as some element may be
+			// near enough to a half off that it rounded the wrong way.
+			static constexpr double ROUNDOFF_TARGET = 0.2;
+			static constexpr double ROUNDOFF_RETRY = 0.375;
+
+			// Longest wrapped-around top of a truncated product to work out classically rather than
+			// with another transform.
+			static const std::size_t TOP_CLASSICAL_LIMIT = 64;
+
+			// Shortest stretch of elements worth handing to another thread in the loading,
+			// convolution and carry passes. Must be a multiple of DIGS_PER_DIG so that the stretches
+			// begin on Digit boundaries, whatever the packing.
+			static const std::size_t PARALLEL_GRAIN = 4096;
+
+			// Shortest transform to cut the longer number of a lopsided product into chunks for.
+			static constexpr std::size_t MIN_CHUNK_FFT_SIZE = 1024;
+
+			// The file the FFT planner keeps its wisdom in, in the working directory.
+			static constexpr const char *WISDOM_FILE = "PIB26-fft.wisdom";
+
+			// A prepared operand along with its forward transform.
+			class PreparedFft;
+
+			Util::ThreadPool *m_threadPool;
 
 			// Bases for digit conversion.
 			TwoDigit m_smallBases[DIGS_PER_DIG + 1];
@@ -76,32 +154,242 @@ namespace SDF::Bignum::Multiplication
 			std::unique_ptr<Fft::IFft<Fft::Complex::Cplex>> m_fft;
 
 			std::size_t m_maxProdSize;
-			std::size_t m_lastProdLength;
 
-			std::size_t m_fftBufferSize;
+			// The longest transform: the one for the largest product at the density safe for
+			// any numbers.
+			std::size_t m_maxFftSize;
+
+			std::unique_ptr<Fft::Complex::TwiddleTable> m_twiddles; // also supplies the right-angle
+			                                                        // weights
+			std::unique_ptr<Fft::Complex::FftPlanner> m_planner;
 
-			// Use punning to save storage space
-			Memory::Buffers::Local::Punned<Digit> m_productDigits;
+			// The transform buffers and other scratch for each product.
+			Memory::Buffers::Local::ScratchPool *m_scratch;
 
-			std::unique_ptr<Memory::ILocalBuffer<Fft::Complex::Cplex>> m_omegaBuffer;
-			std::unique_ptr<Memory::Buffers::Local::RAMOnly<Fft::Complex::Cplex>> m_num1FFTBuffer;
-			std::unique_ptr<Memory::Buffers::Local::RAMOnly<Fft::Complex::Cplex>> m_num2FFTBuffer;
+			mutable std::mutex m_statsMutex;
+			std::vector<RoundOffStats> m_roundOffStats;
 
+			// Function:   calcSmallsPerElement
+			// Purpose:    Choose how many base-BASE_MINOR digits to pack in each element for a
+			//             product: as many as the round-off error seen so far allows.
+			// Parameters: prodSize - The length of the product.
+			// Returns:    The number of digits per element.
 			std::size_t calcSmallsPerElement(std::size_t prodSize);
 
-			void loadBuffer(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t bufferLen,
-				Memory::SafePtr<Digit> num, std::size_t numLen, std::size_t smallsPerFftElement);
-			void applyWeight(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize);
+			// Function:   calcWorstCaseSmallsPerElement
+			// Purpose:    Get how many base-BASE_MINOR digits may be packed in each element for a
+			//             product whatever the numbers are.
+			// Parameters: prodSize - The length of the product.
+			// Returns:    The number of digits per element.
+			static std::size_t calcWorstCaseSmallsPerElement(std::size_t prodSize);
+
+			// Function:   isDensitySafe
+			// Purpose:    Check whether a product may be packed at a given density.
+			// Parameters: prodSize - The length of the product.
+			//             smallsPerElement - The number of base-BASE_MINOR digits per element.
+			// Returns:    Whether the round-off error is expected to stay under ROUNDOFF_TARGET.
+			bool isDensitySafe(std::size_t prodSize, std::size_t smallsPerElement) const;
+
+			// Function:   calcSizeClass
+			// Purpose:    Get the size class of a product for the round-off telemetry.
+			// Parameters: prodSize - The length of the product.
+			// Returns:    The size class.
+			static std::size_t calcSizeClass(std::size_t prodSize);
+
+			// Function:   predictRoundOff
+			// Purpose:    Estimate the round-off error of a product from the telemetry.
+			// Parameters: prodSize - The length of the product.
+			//             smallsPerElement - The number of base-BASE_MINOR digits per element.
+			// Returns:    The estimate, or a negative number if nothing has been seen to go by.
+			double predictRoundOff(std::size_t prodSize, std::size_t smallsPerElement) const;
+
+			// Function:   checkRoundOff
+			// Purpose:    Record the round-off error of a product and check whether it is small
+			//             enough to trust. If not, the product must be redone, and the telemetry
+			//             now steers calcSmallsPerElement to a lower density.
+			// Parameters: prodSize - The length of the product.
+			//             smallsPerElement - The number of base-BASE_MINOR digits per element.
+			//             roundOff - The largest round-off error in the product.
+			// Returns:    Whether the product is good.
+			bool checkRoundOff(std::size_t prodSize, std::size_t smallsPerElement, double roundOff);
+
+			// Function:   calcElementCount
+			// Purpose:    Get how many transform elements a number takes up.
+			// Parameters: numLen - The length of the number.
+			//             smallsPerElement - How many base-BASE_MINOR digits are packed in each
+			//                                element.
+			// Returns:    The number of elements.
+			static std::size_t calcElementCount(std::size_t numLen, std::size_t smallsPerElement);
+
+			// Function:   mayTruncate
+			// Purpose:    Check whether the round-off error leaves room to truncate the transforms
+			//             for a product.
+			// Parameters: prodSize - The length of the product.
+			//             smallsPerElement - How many base-BASE_MINOR digits are packed in each
+			//                                element for it.
+			// Returns:    Whether its transforms may be truncated.
+			bool mayTruncate(std::size_t prodSize, std::size_t smallsPerElement);
+
+			// Function:   planTruncation
+			// Purpose:    Choose the transform length for a product. This may be too short to hold
+			//             the whole product, in which case the top of it wraps around and must be
+			//             worked out separately with productTop.
+			// Parameters: prodElements - The number of elements in the product.
+			//             largerElements - The number of elements in the larger factor.
+			//             allowTruncation - Whether a length too short for the whole product
+			//                               is allowed.
+			// Returns:    The transform length.
+			std::size_t planTruncation(std::size_t prodElements, std::size_t largerElements,
+				bool allowTruncation) const;
+
+			// Function:   planChunks
+			// Purpose:    Choose whether to multiply a long number by a much shorter one in chunks
+			//             (see mulChunked), and how long to make them.
+			// Parameters: longLen - The length of the longer number.
+			//             shortLen - The length of the shorter number.
+			// Returns:    The chunk length, or 0 to multiply the numbers whole.
+			std::size_t planChunks(std::size_t longLen, std::size_t shortLen);
+
+			// Function:   loadWeighted
+			// Purpose:    Load a number into an FFT buffer, applying the right-angle weights as it
+			//             goes. Any elements past the buffer length are folded over.
+			// Parameters: fftBuffer - The buffer to load.
+			//             bufferLen - The length of the buffer, i.e. the transform length.
+			//             num - The number to load.
+			//             numLen - The length of the number.
+			//             firstElement - The first element of the number to load.
+			//             smallsPerFftElement - How many base-BASE_MINOR digits to pack in each
+			//                                   element.
+			void loadWeighted(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t bufferLen,
+				Memory::SafePtr<Digit> num, std::size_t numLen, std::size_t firstElement,
+				std::size_t smallsPerFftElement);
 			void convolute(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer1,
-				Memory::SafePtr<Fft::Complex::Cplex> fftBuffer2, std::size_t bufferLen);
-			void removeWeight(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize);
-			void extractProduct(Memory::SafePtr<Digit> digitBuffer, std::size_t digitsToGet,
+				Memory::SafePtr<const Fft::Complex::Cplex> fftBuffer2, std::size_t bufferLen);
+
+			// Function:   extractUnweighted
+			// Purpose:    Remove the right-angle weights from a transformed product, round it and
+			//             release the carries, all in one pass.
+			// Parameters: digitBuffer - The buffer to receive the product digits.
+			//             digitsToGet - The number of product digits to get.
+			//             fftBuffer - The buffer holding the reverse-transformed product.
+			//             fftSize - The transform length.
+			//             smallsPerFftElement - How many base-BASE_MINOR digits were packed in
+			//                                   each element.
+			//             top - The top of the product that wrapped around, if the transform was
+			//                   truncated, from productTop; otherwise empty.
+			// Returns:    The largest round-off error, i.e. distance of an element from an integer.
+			double extractUnweighted(Memory::SafePtr<Digit> digitBuffer, std::size_t digitsToGet,
 				Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize,
-				std::size_t smallsPerFftElement);
+				std::size_t smallsPerFftElement, const std::vector<double> &top);
 
-			void mulCore(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
-				std::size_t bLen);
-			void sqrCore(Memory::SafePtr<Digit> a, std::size_t aLen);
+			template<std::size_t smalls>
+			double extractUnweighted(Memory::SafePtr<Digit> digitBuffer, std::size_t digitsToGet,
+				Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize,
+				const std::vector<double> &top);
+
+			// Function:   extractCoefficients
+			// Purpose:    Remove the right-angle weights from a transformed product and round it,
+			//             without releasing the carries.
+			// Parameters: dst - The vector to receive the coefficients, sized to the number wanted.
+			//             first - The first coefficient to get.
+			//             fftBuffer - The buffer holding the reverse-transformed product.
+			//             fftSize - The transform length.
+			//             top - As for extractUnweighted.
+			// Returns:    The largest round-off error.
+			double extractCoefficients(std::vector<double> &dst, std::size_t first,
+				Memory::SafePtr<Fft::Complex::Cplex> fftBuffer, std::size_t fftSize,
+				const std::vector<double> &top);
+
+			// Function:   wrappedProduct
+			// Purpose:    Multiply runs of elements from the tops of two numbers modulo
+			//             x^(2 * fftSize) + 1, leaving the weighted product in the first buffer.
+			// Parameters: fftBuffer1, fftBuffer2 - The buffers to transform in.
+			//             fftSize - The transform length.
+			//             a, aLen, aFirst - The first number, its length and its first element.
+			//             b, bLen, bFirst - The same for the second number.
+			//             smallsPerElement - How many base-BASE_MINOR digits to pack in each
+			//                                element.
+			//             square - Whether the numbers are the same, in which case only the first
+			//                      buffer is used.
+			void wrappedProduct(Memory::SafePtr<Fft::Complex::Cplex> fftBuffer1,
+				Memory::SafePtr<Fft::Complex::Cplex> fftBuffer2, std::size_t fftSize,
+				Memory::SafePtr<Digit> a, std::size_t aLen, std::size_t aFirst,
+				Memory::SafePtr<Digit> b, std::size_t bLen, std::size_t bFirst,
+				std::size_t smallsPerElement, bool square);
+
+			// Function:   productTop
+			// Purpose:    Work out the top coefficients of a product exactly, before carrying.
+			//             This is what wraps around when the transform is truncated.
+			// Parameters: a, aLen - The first number and its length.
+			//             b, bLen - The second number and its length.
+			//             smallsPerElement - How many base-BASE_MINOR digits are packed in each
+			//                                element.
+			//             count - The number of coefficients to get.
+			//             square - Whether the numbers are the same.
+			//             dst - The vector to receive the coefficients.
+			// Returns:    The largest round-off error in working them out.
+			double productTop(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen, std::size_t smallsPerElement, std::size_t count, bool square,
+				std::vector<double> &dst);
+
+			// Function:   mulPreparedCore
+			// Purpose:    Multiply a prepared operand by a number into a buffer, using the kept
+			//             transform.
+			// Parameters: result - The buffer to receive the product, aLen + bLen digits long.
+			//             prepared - The prepared operand.
+			//             b, bLen - The other number and its length.
+			// Returns:    Whether it worked: it does not if the packing of the prepared operand
+			//             turns out too dense for the product.
+			bool mulPreparedCore(Memory::SafePtr<Digit> result, const PreparedFft &prepared,
+				Memory::SafePtr<Digit> b, std::size_t bLen);
+
+			// Function:   mulInto
+			// Purpose:    Multiply two numbers into a buffer, choosing the packing and whether to
+			//             cut the longer one into chunks, and redoing the product if the round-off
+			//             error is too large.
+			// Parameters: result - The buffer to receive the product, aLen + bLen digits long.
+			//             a, aLen - The first number and its length.
+			//             b, bLen - The second number and its length.
+			// Returns:    The length of the product.
+			std::size_t mulInto(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a,
+				std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen);
+
+			// Function:   mulCore
+			// Purpose:    Multiply two numbers into a buffer.
+			// Parameters: result - The buffer to receive the product.
+			//             a, aLen - The first number and its length.
+			//             b, bLen - The second number and its length.
+			//             smallsPerElement - How many base-BASE_MINOR digits to pack in each
+			//                                element.
+			// Returns:    The largest round-off error.
+			double mulCore(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a,
+				std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen,
+				std::size_t smallsPerElement);
+
+			// Function:   mulChunked
+			// Purpose:    Multiply a long number by a much shorter one into a buffer, by cutting the
+			//             long one into chunks and transforming the short one only once, so the
+			//             transforms are sized to the short one.
+			// Parameters: result - The buffer to receive the product.
+			//             a, aLen - The longer number and its length.
+			//             b, bLen - The shorter number and its length.
+			//             chunkLen - The length of the chunks, from planChunks.
+			//             smallsPerElement - How many base-BASE_MINOR digits to pack in each
+			//                                element.
+			// Returns:    The largest round-off error.
+			double mulChunked(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a,
+				std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen, std::size_t chunkLen,
+				std::size_t smallsPerElement);
+
+			// Function:   sqrInto
+			// Purpose:    Square a number into a buffer, choosing the packing and redoing the
+			//             square if the round-off error is too large.
+			// Parameters: result - The buffer to receive the square, 2 * aLen digits long.
+			//             a, aLen - The number and its length.
+			// Returns:    None.
+			void sqrInto(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a, std::size_t aLen);
+			double sqrCore(Memory::SafePtr<Digit> result, Memory::SafePtr<Digit> a,
+				std::size_t aLen, std::size_t smallsPerElement);
 	};
 }
 
@@ -25,12 +25,45 @@
 #ifndef SRC_BIGNUM_MULTIPLICATION_FFT_FFTTWEAK_HPP_
 #define SRC_BIGNUM_MULTIPLICATION_FFT_FFTTWEAK_HPP_
 
+#include "../../../util/cacheInfo.hpp"
+
 #include <cstddef>
 
 namespace SDF::Bignum::Multiplication::Fft {
-	// Defines tweak constants for the FFT. Ideally (TBA!) we should have the program assess these
-	// parameters from the specs of the system we are running on.
-	static const std::size_t g_cacheSize = 262144; // The size of the CPU L1 cache in bytes.
+	// Defines tweak parameters for the FFT. Most are assessed from the cache sizes of the system
+	// we are running on.
+	static const std::size_t g_minParallelFftLength = 32768; // Shortest sub-transform worth
+	                                                         // handing to another thread.
+	static const std::size_t g_minRadix8FftLength = 2048; // Shortest odd power of 2 worth a
+	                                                      // radix-8 pass; below this, the
+	                                                      // radix-2 pass is cheaper.
+
+	// Function:   getIterativeCacheSize
+	// Purpose:    Get the cache budget, in bytes, that an iterative FFT - table and data - should
+	//             fit into.
+	// Parameters: None.
+	// Returns:    The cache budget.
+	inline std::size_t getIterativeCacheSize() {
+		return Util::getCacheSizes().l2;
+	}
+
+	// Function:   getBlockCacheSize
+	// Purpose:    Get the cache budget, in bytes, for one block of a cache-blocked (four-step) FFT,
+	//             i.e. a row, or a group of columns gathered together.
+	// Parameters: None.
+	// Returns:    The cache budget.
+	inline std::size_t getBlockCacheSize() {
+		return Util::getCacheSizes().l2 / 2;
+	}
+
+	// Function:   getTileCacheSize
+	// Purpose:    Get the cache budget, in bytes, for the pair of tiles swapped at a time by a
+	//             blocked transpose.
+	// Parameters: None.
+	// Returns:    The cache budget.
+	inline std::size_t getTileCacheSize() {
+		return Util::getCacheSizes().l1;
+	}
 }
 
 #endif /* SRC_BIGNUM_MULTIPLICATION_FFT_FFTTWEAK_HPP_ */
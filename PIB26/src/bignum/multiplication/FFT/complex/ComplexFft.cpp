@@ -23,10 +23,23 @@
  */
 
 #include "ComplexFft.hpp"
+
+#include "../FFTTweak.hpp"
+
 #include <cmath>
 
 namespace SDF::Bignum::Multiplication::Fft::Complex {
-	ComplexFft::ComplexFft() {}
+	ComplexFft::ComplexFft()
+		: m_kernels(getButterflyKernels()), m_threadPool(nullptr),
+		  m_batchLimit(getIterativeCacheSize() / (2 * sizeof(Cplex)))
+	{
+	}
+
+	ComplexFft::ComplexFft(Util::ThreadPool *threadPool)
+		: m_kernels(getButterflyKernels()), m_threadPool(threadPool),
+		  m_batchLimit(getIterativeCacheSize() / (2 * sizeof(Cplex)))
+	{
+	}
 
 	std::size_t ComplexFft::getMaxNumLengthAtBase(long base) const {
 		// The size of the largest element in the multiplication pyramid, which has the greatest
@@ -51,5 +64,55 @@ namespace SDF::Bignum::Multiplication::Fft::Complex {
 		std::size_t log2Base = ceil(log(base*base-1)/log(2.0));
 		return 1 << (53 - log2Base); // 53 bits per double.
 	}
-}
 
+	bool ComplexFft::useKernels(std::size_t count) const {
+		return (m_kernels != nullptr) && (count % m_kernels->width == 0);
+	}
+
+	Cplex *ComplexFft::rawBlock(Memory::SafePtr<Cplex> ptr, std::size_t len) {
+		ptr[len - 1]; // bounds check only
+		return &ptr[0];
+	}
+
+	std::size_t ComplexFft::getNumThreads() const {
+		return (m_threadPool != nullptr) ? m_threadPool->getNumThreads() : 1;
+	}
+
+	void ComplexFft::runParallel(std::size_t count,
+		const std::function<void(std::size_t, std::size_t)> &task)
+	{
+		if (m_threadPool != nullptr) {
+			m_threadPool->parallelFor(count, task);
+		} else {
+			for (std::size_t idx(0); idx < count; ++idx) {
+				task(idx, 0);
+			}
+		}
+	}
+
+	void ComplexFft::runSubTransforms(std::size_t count, std::size_t subLen,
+		const std::function<void(std::size_t)> &subTransform)
+	{
+		if (subLen >= g_minParallelFftLength) {
+			runParallel(count, [&](std::size_t idx, std::size_t) {
+				subTransform(idx);
+			});
+		} else {
+			for (std::size_t idx(0); idx < count; ++idx) {
+				subTransform(idx);
+			}
+		}
+	}
+
+	void ComplexFft::runBatches(std::size_t len, std::size_t count,
+		const std::function<void(std::size_t, std::size_t)> &batch)
+	{
+		std::size_t perGroup((len < m_batchLimit) ? m_batchLimit / len : 1);
+		std::size_t numGroups((count + perGroup - 1) / perGroup);
+
+		runSubTransforms(numGroups, perGroup * len, [&](std::size_t group) {
+			std::size_t first(group * perGroup);
+			batch(first, (count - first < perGroup) ? count - first : perGroup);
+		});
+	}
+}
@@ -26,7 +26,15 @@
 
 #include "../IFft.hpp"
 
+#include "../../../../memory/SafePtr.hpp"
+
+#include "../../../../util/ThreadPool.hpp"
+
 #include "Cplex.hpp"
+#include "butterflies.hpp"
+
+#include <cstddef>
+#include <functional>
 
 namespace SDF::Bignum::Multiplication::Fft::Complex
 {
@@ -39,7 +47,70 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 		public:
 			ComplexFft();
 
+			// Function:  ComplexFft
+			// Purpose:   Construct an FFT that runs its sub-transforms on a thread pool.
+			// Arguments: threadPool - The pool to use.
+			ComplexFft(Util::ThreadPool *threadPool);
+
 			std::size_t getMaxNumLengthAtBase(long base) const;
+		protected:
+			// Function:   useKernels
+			// Purpose:    Decide whether a butterfly pass with the given count can be done with the
+			//             vector kernels, rather than the scalar loop.
+			// Parameters: count - The number of butterflies in the pass.
+			// Returns:    Whether to use m_kernels.
+			bool useKernels(std::size_t count) const;
+
+			// Function:   rawBlock
+			// Purpose:    Get a raw pointer for the vector kernels, bounds-checking the whole block
+			//             it will be used for in debug mode first.
+			// Parameters: ptr - The start of the block.
+			//             len - The number of elements in the block.
+			// Returns:    The raw pointer.
+			static Cplex *rawBlock(Memory::SafePtr<Cplex> ptr, std::size_t len);
+
+			// Function:   getNumThreads
+			// Purpose:    Get the number of threads work may be spread over.
+			// Parameters: None.
+			// Returns:    The number of threads; 1 if there is no pool.
+			std::size_t getNumThreads() const;
+
+			// Function:   runParallel
+			// Purpose:    Run a task for each index in a range, on the pool if there is one. See
+			//             Util::ThreadPool::parallelFor.
+			// Parameters: count - The number of indices.
+			//             task - The task, receiving the index and the number of the thread.
+			// Returns:    None.
+			void runParallel(std::size_t count,
+				const std::function<void(std::size_t, std::size_t)> &task);
+
+			// Function:   runSubTransforms
+			// Purpose:    Run the independent sub-transforms of a recursive step, in parallel if
+			//             there is a pool and they are long enough to be worth it.
+			// Parameters: count - The number of sub-transforms.
+			//             subLen - The length of each.
+			//             subTransform - Does the sub-transform with the given index.
+			// Returns:    None.
+			void runSubTransforms(std::size_t count, std::size_t subLen,
+				const std::function<void(std::size_t)> &subTransform);
+
+			// Function:   runBatches
+			// Purpose:    Split a batch of count consecutive transforms of length len into groups
+			//             spanning no more than m_batchLimit elements (but at least one transform
+			//             each), and run them as sub-transforms.
+			// Parameters: len - The length of each transform.
+			//             count - The number of transforms.
+			//             batch - Does the transforms first ... first + num - 1.
+			// Returns:    None.
+			void runBatches(std::size_t len, std::size_t count,
+				const std::function<void(std::size_t first, std::size_t num)> &batch);
+
+			const ButterflyKernels *m_kernels; // nullptr if the CPU has no usable vector unit
+			Util::ThreadPool *m_threadPool; // nullptr to run serially
+
+			// The most elements a batch of short transforms is done over breadth-first, pass by
+			// pass; longer batches are split up so each piece stays in cache.
+			std::size_t m_batchLimit;
 	};
 }
 
@@ -0,0 +1,169 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      FftPlanner.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "FftPlanner.hpp"
+
+#include "../../../../util/cacheInfo.hpp"
+
+#include "butterflies.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex {
+	FftPlanner::FftPlanner(const std::string &fileName, std::size_t omegaSize,
+		std::size_t numThreads)
+		: m_fileName(fileName), m_haveCrossovers(false), m_crossovers { 0, 0 }
+	{
+		const ButterflyKernels *kernels(getButterflyKernels());
+		const Util::CacheSizes &caches(Util::getCacheSizes());
+
+		std::ostringstream key;
+		key << ((kernels != nullptr) ? kernels->name : "scalar") << "/L1=" << caches.l1 << "/L2="
+			<< caches.l2 << "/line=" << caches.lineSize << "/threads=" << numThreads << "/W="
+			<< omegaSize;
+		m_key = key.str();
+
+		load();
+	}
+
+	bool FftPlanner::getCrossovers(Crossovers &crossovers) const
+	{
+		if (m_haveCrossovers) {
+			crossovers = m_crossovers;
+		}
+
+		return m_haveCrossovers;
+	}
+
+	void FftPlanner::setCrossovers(const Crossovers &crossovers)
+	{
+		m_crossovers = crossovers;
+		m_haveCrossovers = true;
+		save();
+	}
+
+	bool FftPlanner::getLayout(std::size_t len, Layout &layout) const
+	{
+		auto it(m_layouts.find(len));
+		if (it == m_layouts.end()) {
+			return false;
+		}
+
+		layout = it->second;
+		return true;
+	}
+
+	void FftPlanner::setLayout(std::size_t len, const Layout &layout)
+	{
+		m_layouts[len] = layout;
+		save();
+	}
+
+	double FftPlanner::timeBest(std::size_t runs, const std::function<void()> &task)
+	{
+		double best(0.0);
+		for (std::size_t run(0); run < runs; ++run) {
+			auto start(std::chrono::steady_clock::now());
+			task();
+			std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - start);
+
+			if ((run == 0) || (elapsed.count() < best)) {
+				best = elapsed.count();
+			}
+		}
+
+		return best;
+	}
+
+	// The file holds a version line, then one line of wisdom each:
+	//
+	//    <key> crossovers <iterativeLen> <minRadix8Len>
+	//    <key> layout <len> direct|fourstep|sixstep <cols> <blockCols>
+	void FftPlanner::load()
+	{
+		std::ifstream file(m_fileName);
+		std::string line;
+		if (!std::getline(file, line)) {
+			return;
+		}
+
+		std::istringstream header(line);
+		std::string magic;
+		int version(0);
+		if (!(header >> magic >> version) || (magic != "PIB26-fft-wisdom")
+			|| (version != VERSION)) {
+			return; // from another version; it will be overwritten
+		}
+
+		while (std::getline(file, line)) {
+			std::istringstream fields(line);
+			std::string key, kind;
+			if (!(fields >> key >> kind)) {
+				continue;
+			}
+
+			if (key != m_key) {
+				m_otherLines.push_back(line);
+			} else if (kind == "crossovers") {
+				Crossovers crossovers;
+				if (fields >> crossovers.iterativeLen >> crossovers.minRadix8Len) {
+					m_crossovers = crossovers;
+					m_haveCrossovers = true;
+				}
+			} else if (kind == "layout") {
+				std::size_t len;
+				std::string form;
+				Layout layout;
+				if (fields >> len >> form >> layout.cols >> layout.blockCols) {
+					layout.direct = (form == "direct");
+					layout.sixStep = (form == "sixstep");
+					m_layouts[len] = layout;
+				}
+			}
+		}
+	}
+
+	void FftPlanner::save() const
+	{
+		std::ofstream file(m_fileName);
+		file << "PIB26-fft-wisdom " << VERSION << std::endl;
+		for (const std::string &line : m_otherLines) {
+			file << line << std::endl;
+		}
+
+		if (m_haveCrossovers) {
+			file << m_key << " crossovers " << m_crossovers.iterativeLen << " "
+				<< m_crossovers.minRadix8Len << std::endl;
+		}
+
+		for (const auto &entry : m_layouts) {
+			const Layout &layout(entry.second);
+			file << m_key << " layout " << entry.first << " "
+				<< (layout.direct ? "direct" : (layout.sixStep ? "sixstep" : "fourstep")) << " "
+				<< layout.cols << " " << layout.blockCols << std::endl;
+		}
+	}
+}
@@ -0,0 +1,133 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      FftPlanner.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_FFTPLANNER_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_FFTPLANNER_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex {
+	// Class:      FftPlanner
+	// Purpose:    Keeps the "wisdom" on how best to do the complex transforms on this machine, as
+	//             found by timing the candidates (see fourStep), and stores it in a file so later
+	//             runs need not time them again. There are two kinds: the crossovers between the
+	//             radix-2/radix-8 passes and the recursive/iterative radix-4 transforms, which hold
+	//             for all lengths, and the layout of each transform too long for the cache. The
+	//             wisdom is only good for the same vector kernels, cache sizes, thread count and
+	//             twiddle table order, so it is filed under a key made from those; the wisdom under
+	//             other keys in the file is kept as it is.
+	// Parameters: None.
+	class FftPlanner {
+		public:
+			// Structure: Crossovers
+			// Purpose:   The crossovers for the transforms done in one piece.
+			struct Crossovers
+			{
+					std::size_t iterativeLen; // powers of 4 shorter than this are done iteratively
+					std::size_t minRadix8Len; // shortest odd power of 2 for a radix-8 pass; 0 for
+					                          // none
+			};
+
+			// Structure: Layout
+			// Purpose:   How to do a transform too long for the cache: in one piece, or as a matrix
+			//            of cols columns, gathered blockCols at a time, or transposed (six-step).
+			struct Layout
+			{
+					bool direct;
+					bool sixStep;
+					std::size_t cols;
+					std::size_t blockCols;
+			};
+
+			// Function:  FftPlanner
+			// Purpose:   Construct a planner, loading whatever wisdom there is for this machine.
+			// Arguments: fileName - The wisdom file. It need not exist yet.
+			//            omegaSize - The order of the twiddle table the transforms use.
+			//            numThreads - The number of threads the transforms are spread over.
+			FftPlanner(const std::string &fileName, std::size_t omegaSize, std::size_t numThreads);
+
+			// Function:   getCrossovers
+			// Purpose:    Get the crossovers, if they have been found.
+			// Parameters: crossovers - Receives the crossovers.
+			// Returns:    Whether there were any.
+			bool getCrossovers(Crossovers &crossovers) const;
+
+			// Function:   setCrossovers
+			// Purpose:    Record the crossovers found, and save them.
+			// Parameters: crossovers - The crossovers.
+			// Returns:    None.
+			void setCrossovers(const Crossovers &crossovers);
+
+			// Function:   getLayout
+			// Purpose:    Get the layout for a transform length, if it has been found.
+			// Parameters: len - The transform length.
+			//             layout - Receives the layout.
+			// Returns:    Whether there was one.
+			bool getLayout(std::size_t len, Layout &layout) const;
+
+			// Function:   setLayout
+			// Purpose:    Record the layout found for a transform length, and save it.
+			// Parameters: len - The transform length.
+			//             layout - The layout.
+			// Returns:    None.
+			void setLayout(std::size_t len, const Layout &layout);
+
+			// Function:   timeBest
+			// Purpose:    Time a task, taking the best of a few runs to shake off interruptions.
+			// Parameters: runs - The number of runs.
+			//             task - The task.
+			// Returns:    The shortest run, in seconds.
+			static double timeBest(std::size_t runs, const std::function<void()> &task);
+		private:
+			static constexpr int VERSION = 1;
+
+			std::string m_fileName;
+			std::string m_key;
+
+			bool m_haveCrossovers;
+			Crossovers m_crossovers;
+			std::map<std::size_t, Layout> m_layouts;
+
+			std::vector<std::string> m_otherLines; // wisdom under other keys
+
+			// Function:   load
+			// Purpose:    Read the wisdom file, if there is one and it is of this version.
+			// Parameters: None.
+			// Returns:    None.
+			void load();
+
+			// Function:   save
+			// Purpose:    Write the wisdom file. Failing to is not an error: the wisdom will just
+			//             have to be found again next time.
+			// Parameters: None.
+			// Returns:    None.
+			void save() const;
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_FFTPLANNER_HPP_ */
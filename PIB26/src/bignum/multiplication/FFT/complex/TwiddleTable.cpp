@@ -0,0 +1,148 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      TwiddleTable.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "TwiddleTable.hpp"
+
+#include <cmath>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex {
+	static const long double c_twoPi = 6.283185307179586476925286766559005768L;
+
+	// The number of roots filled per chunk of work.
+	static const std::size_t c_fillGrain = 4096;
+
+	TwiddleTable::TwiddleTable(std::size_t size, std::size_t maxDirectLen,
+		Util::ThreadPool *threadPool)
+		: m_size(size), m_useSymmetry(size % 8 == 0), m_octantLen(size / 8),
+		  m_quadrantLen(size / 4), m_fineShift(0), m_fineMask(0)
+	{
+		// The two levels have to reach every power in the first octant, or around the whole
+		// circle; make S the power of 2 at or above the square root of that.
+		std::size_t span(m_useSymmetry ? m_octantLen + 1 : m_size);
+		while ((std::size_t(1) << (2 * m_fineShift)) < span) {
+			++m_fineShift;
+		}
+
+		std::size_t fineLen(std::size_t(1) << m_fineShift);
+		std::size_t coarseLen(((span - 1) >> m_fineShift) + 1);
+		m_fineMask = fineLen - 1;
+
+		// Work out the roots in long double, so the only error left in them is the final
+		// rounding to double.
+		m_coarseBuffer = std::make_unique<Memory::Buffers::Local::RAMOnly<Cplex>>(coarseLen);
+		m_coarse = m_coarseBuffer->accessData(0);
+		threadPool->parallelForRange(coarseLen, c_fillGrain,
+			[&](std::size_t begin, std::size_t end, std::size_t) {
+				for (std::size_t a(begin); a < end; ++a) {
+					long double theta(c_twoPi * (a << m_fineShift) / m_size);
+					m_coarse[a] = Cplex(cosl(theta), -sinl(theta));
+				}
+			});
+
+		// cos - 1 = -2 sin^2(theta/2) keeps the digits cos loses to the 1.
+		m_fineBuffer = std::make_unique<Memory::Buffers::Local::RAMOnly<Cplex>>(fineLen);
+		m_fine = m_fineBuffer->accessData(0);
+		threadPool->parallelForRange(fineLen, c_fillGrain,
+			[&](std::size_t begin, std::size_t end, std::size_t) {
+				for (std::size_t b(begin); b < end; ++b) {
+					long double theta(c_twoPi * b / m_size);
+					long double halfSin(sinl(theta / 2));
+					m_fine[b] = Cplex(-2 * halfSin * halfSin, -sinl(theta));
+				}
+			});
+
+		// The direct tables, taken from the above so they agree with it exactly. Each root is
+		// one coarse anchor rotated by one fine step, so the chunks can be filled independently
+		// and no error builds up across a table as it would with a running recurrence.
+		std::size_t oddPart(m_size);
+		std::size_t pow2Part(1);
+		while ((oddPart & 1) == 0) {
+			oddPart >>= 1;
+			pow2Part <<= 1;
+		}
+
+		for (std::size_t odd(1); (odd <= oddPart) && (odd <= maxDirectLen); odd += 2) {
+			if (oddPart % odd != 0) {
+				continue;
+			}
+
+			std::size_t directLen(odd);
+			while ((directLen < odd * pow2Part) && (2 * directLen <= maxDirectLen)) {
+				directLen <<= 1;
+			}
+
+			DirectTable table { odd, directLen,
+				std::make_unique<Memory::Buffers::Local::RAMOnly<Cplex>>(directLen) };
+			Memory::SafePtr<Cplex> roots(table.buffer->accessData(0));
+			std::size_t stride(m_size / directLen);
+			threadPool->parallelForRange(directLen, c_fillGrain,
+				[&](std::size_t begin, std::size_t end, std::size_t) {
+					for (std::size_t n(begin); n < end; ++n) {
+						roots[n] = (*this)[n * stride];
+					}
+				});
+
+			m_directTables.push_back(std::move(table));
+		}
+	}
+
+	std::size_t TwiddleTable::getSize() const
+	{
+		return m_size;
+	}
+
+	std::size_t TwiddleTable::getMemoryUse() const
+	{
+		std::size_t entries(m_coarseBuffer->getSize() + m_fineBuffer->getSize());
+		for (const DirectTable &table : m_directTables) {
+			entries += table.size;
+		}
+
+		return entries * sizeof(Cplex);
+	}
+
+	const Cplex *TwiddleTable::getDirect(std::size_t len, std::size_t &step) const
+	{
+		std::size_t oddPart(len);
+		while ((oddPart & 1) == 0) {
+			oddPart >>= 1;
+		}
+
+		for (const DirectTable &table : m_directTables) {
+			if (table.oddFactor == oddPart) {
+				if (table.size % len != 0) {
+					return nullptr;
+				}
+
+				step = table.size / len;
+
+				Memory::SafePtr<const Cplex> roots(table.buffer->accessData(0));
+				roots[table.size - 1]; // bounds check only
+				return &roots[0];
+			}
+		}
+
+		return nullptr;
+	}
+}
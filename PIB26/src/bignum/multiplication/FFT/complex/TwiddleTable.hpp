@@ -0,0 +1,165 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      TwiddleTable.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_TWIDDLETABLE_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_TWIDDLETABLE_HPP_
+
+#include "../../../../memory/SafePtr.hpp"
+#include "../../../../memory/buffers/local/RAMOnly.hpp"
+#include "../../../../util/ThreadPool.hpp"
+
+#include "Cplex.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex {
+	// Class:      TwiddleTable
+	// Purpose:    Supplies the complex roots of unity (omega) e^(-2pii k/W) for the transforms of
+	//             lengths dividing a fixed W, without storing all W of them. By the symmetries of
+	//             the circle, every root is one in the first octant, 0 <= k <= W/8, with its parts
+	//             swapped and/or negated. Those are in turn built from two tables of around
+	//             sqrt(W/8) entries each: for k = aS + b, b < S, the root is the coarse root
+	//             e^(-2pii aS/W) times the fine root e^(-2pii b/W). The fine roots are stored less
+	//             one, which keeps the product about as accurate as a root read from a full table.
+	//
+	//             The vector kernels want a plain table they can step through, so for each odd
+	//             factor d of W there is also a direct table of all the roots of order d * 2^n,
+	//             for the largest such order dividing W that does not exceed the longest transform
+	//             done in cache. That covers every pass not done by the cache-blocked transform,
+	//             as well as the rows and columns of that; only its rare over-long passes have to
+	//             get their roots one at a time.
+	// Parameters: None.
+	class TwiddleTable {
+		public:
+			// Function:  TwiddleTable
+			// Purpose:   Construct the tables for roots of a given order.
+			// Arguments: size - The order W of the roots.
+			//            maxDirectLen - The longest pass the direct tables need to serve.
+			//            threadPool - The thread pool to fill the tables with.
+			TwiddleTable(std::size_t size, std::size_t maxDirectLen, Util::ThreadPool *threadPool);
+
+			// Function:   getSize
+			// Purpose:    Get the order of the roots supplied.
+			// Parameters: None.
+			// Returns:    The order W.
+			std::size_t getSize() const;
+
+			// Function:   getMemoryUse
+			// Purpose:    Get how much memory the tables take up.
+			// Parameters: None.
+			// Returns:    The size of the tables, in bytes.
+			std::size_t getMemoryUse() const;
+
+			// Function:   operator[]
+			// Purpose:    Get a root of unity.
+			// Parameters: k - The power, less than W.
+			// Returns:    e^(-2pii k/W).
+			Cplex operator[](std::size_t k) const;
+
+			// Function:   getDirect
+			// Purpose:    Get the direct table for the twiddles of a pass, if there is one.
+			// Parameters: len - The length of the pass.
+			//             step - Receives the step through the table from one root of order len
+			//                    to the next, i.e. the table holds e^(-2pii n/len) at n * step.
+			// Returns:    The table, or nullptr if len is too long for the direct tables.
+			const Cplex *getDirect(std::size_t len, std::size_t &step) const;
+		private:
+			std::size_t m_size;
+
+			// The octant folding is only done when 8 divides W; otherwise the two levels cover
+			// the whole circle. That is only so for the smallest tables.
+			bool m_useSymmetry;
+			std::size_t m_octantLen; // W/8
+			std::size_t m_quadrantLen; // W/4
+
+			std::unique_ptr<Memory::Buffers::Local::RAMOnly<Cplex>> m_coarseBuffer;
+			std::unique_ptr<Memory::Buffers::Local::RAMOnly<Cplex>> m_fineBuffer;
+			Memory::SafePtr<Cplex> m_coarse; // e^(-2pii aS/W)
+			Memory::SafePtr<Cplex> m_fine; // e^(-2pii b/W) - 1
+			std::size_t m_fineShift; // lg S
+			std::size_t m_fineMask; // S - 1
+
+			struct DirectTable {
+				std::size_t oddFactor;
+				std::size_t size;
+				std::unique_ptr<Memory::Buffers::Local::RAMOnly<Cplex>> buffer;
+			};
+
+			std::vector<DirectTable> m_directTables;
+
+			// Function:   fromLevels
+			// Purpose:    Build a root from the coarse and fine tables.
+			// Parameters: k - The power, no more than W/8 (or less than W, without the symmetry).
+			// Returns:    e^(-2pii k/W).
+			Cplex fromLevels(std::size_t k) const;
+	};
+
+	inline Cplex TwiddleTable::fromLevels(std::size_t k) const
+	{
+		const Cplex &c(m_coarse[k >> m_fineShift]);
+		const Cplex &f(m_fine[k & m_fineMask]);
+
+		// c * (1 + f), adding c last, as f is small.
+		return Cplex(c.r + (c.r * f.r - c.i * f.i), c.i + (c.r * f.i + c.i * f.r));
+	}
+
+	inline Cplex TwiddleTable::operator[](std::size_t k) const
+	{
+		if (!m_useSymmetry) {
+			return fromLevels(k);
+		}
+
+		// Fold into the first quadrant, then the first octant.
+		std::size_t quadrant(0);
+		while (k >= m_quadrantLen) {
+			k -= m_quadrantLen;
+			++quadrant;
+		}
+
+		Cplex w;
+		if (k > m_octantLen) {
+			// e^(-2pii k/W) = -i * conj(e^(-2pii (W/4 - k)/W)).
+			Cplex v(fromLevels(m_quadrantLen - k));
+			w = Cplex(-v.i, -v.r);
+		} else {
+			w = fromLevels(k);
+		}
+
+		// Each quadrant further on is another factor of -i.
+		switch (quadrant) {
+			case 1:
+				return Cplex(w.i, -w.r);
+			case 2:
+				return Cplex(-w.r, -w.i);
+			case 3:
+				return Cplex(-w.i, w.r);
+			default:
+				return w;
+		}
+	}
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_TWIDDLETABLE_HPP_ */
@@ -0,0 +1,107 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      avx2Butterflies.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// NB: this file must be compiled with -mavx2 -mfma, and nothing in it may be called unless the CPU
+// supports those. See getButterflyKernels.
+
+#include "../butterflies.hpp"
+#include "../vecButterflies.hpp"
+
+#include <immintrin.h>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex
+{
+	namespace
+	{
+		// Four doubles per vector. load() splits two registers of interleaved data into real and
+		// imaginary parts with unpacklo/unpackhi, which leaves the elements in the order
+		// 0, 2, 1, 3; store() undoes this, and the strided loads and stores build the same two
+		// registers from 128-bit pieces, so the order never needs fixing up.
+		struct Avx2
+		{
+				typedef __m256d Vec;
+				static const std::size_t WIDTH = 4;
+
+				static inline Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+				static inline Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+				static inline Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+				static inline Vec fmadd(Vec a, Vec b, Vec c) { return _mm256_fmadd_pd(a, b, c); }
+				static inline Vec fmsub(Vec a, Vec b, Vec c) { return _mm256_fmsub_pd(a, b, c); }
+				static inline Vec fnmadd(Vec a, Vec b, Vec c) { return _mm256_fnmadd_pd(a, b, c); }
+				static inline Vec set1(double x) { return _mm256_set1_pd(x); }
+
+				static inline void load(const double *p, Vec &re, Vec &im)
+				{
+					Vec lo(_mm256_loadu_pd(p)), hi(_mm256_loadu_pd(p + 4));
+					re = _mm256_unpacklo_pd(lo, hi);
+					im = _mm256_unpackhi_pd(lo, hi);
+				}
+
+				static inline void store(double *p, Vec re, Vec im)
+				{
+					_mm256_storeu_pd(p, _mm256_unpacklo_pd(re, im));
+					_mm256_storeu_pd(p + 4, _mm256_unpackhi_pd(re, im));
+				}
+
+				static inline void loadStrided(const double *p, std::size_t stride, Vec &re,
+					Vec &im)
+				{
+					std::size_t s(2 * stride);
+					Vec lo(_mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p)),
+						_mm_loadu_pd(p + s), 1));
+					Vec hi(_mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p + 2 * s)),
+						_mm_loadu_pd(p + 3 * s), 1));
+					re = _mm256_unpacklo_pd(lo, hi);
+					im = _mm256_unpackhi_pd(lo, hi);
+				}
+
+				static inline void storeStrided(double *p, std::size_t stride, Vec re, Vec im)
+				{
+					std::size_t s(2 * stride);
+					Vec lo(_mm256_unpacklo_pd(re, im)), hi(_mm256_unpackhi_pd(re, im));
+					_mm_storeu_pd(p, _mm256_castpd256_pd128(lo));
+					_mm_storeu_pd(p + s, _mm256_extractf128_pd(lo, 1));
+					_mm_storeu_pd(p + 2 * s, _mm256_castpd256_pd128(hi));
+					_mm_storeu_pd(p + 3 * s, _mm256_extractf128_pd(hi, 1));
+				}
+
+				static inline void loadTwiddles(const double *omega, std::size_t n, std::size_t step,
+					Vec &re, Vec &im)
+				{
+					if (step == 1) {
+						load(omega + 2 * n, re, im);
+					} else {
+						loadStrided(omega + 2 * n * step, step, re, im);
+					}
+				}
+		};
+	}
+
+	const ButterflyKernels *getAvx2Kernels()
+	{
+		static const ButterflyKernels kernels(VecButterflies::makeKernels<Avx2>("AVX2"));
+
+		return &kernels;
+	}
+}
@@ -0,0 +1,141 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      avx512Butterflies.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// NB: this file must be compiled with -mavx512f, and nothing in it may be called unless the CPU
+// supports it. See getButterflyKernels.
+
+#include "../butterflies.hpp"
+#include "../vecButterflies.hpp"
+
+#include <immintrin.h>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex
+{
+	namespace
+	{
+		// Eight doubles per vector. As in the AVX2 kernels, load() and store() use unpacklo and
+		// unpackhi, here leaving the elements in the order 0, 4, 1, 5, 2, 6, 3, 7, which the
+		// strided loads and stores match. We use the masked forms of unpack, insert and extract
+		// with a full mask, as GCC 12 warns that the undefined source operand of the unmasked forms
+		// may be uninitialized.
+		struct Avx512
+		{
+				typedef __m512d Vec;
+				static const std::size_t WIDTH = 8;
+
+				static inline Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+				static inline Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+				static inline Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+				static inline Vec fmadd(Vec a, Vec b, Vec c) { return _mm512_fmadd_pd(a, b, c); }
+				static inline Vec fmsub(Vec a, Vec b, Vec c) { return _mm512_fmsub_pd(a, b, c); }
+				static inline Vec fnmadd(Vec a, Vec b, Vec c) { return _mm512_fnmadd_pd(a, b, c); }
+				static inline Vec set1(double x) { return _mm512_set1_pd(x); }
+
+				static inline void load(const double *p, Vec &re, Vec &im)
+				{
+					Vec lo(_mm512_loadu_pd(p)), hi(_mm512_loadu_pd(p + 8));
+					re = unpacklo(lo, hi);
+					im = unpackhi(lo, hi);
+				}
+
+				static inline void store(double *p, Vec re, Vec im)
+				{
+					_mm512_storeu_pd(p, unpacklo(re, im));
+					_mm512_storeu_pd(p + 8, unpackhi(re, im));
+				}
+
+				static inline void loadStrided(const double *p, std::size_t stride, Vec &re,
+					Vec &im)
+				{
+					std::size_t s(2 * stride);
+					Vec lo(combine(loadPair(p, s), loadPair(p + 2 * s, s)));
+					Vec hi(combine(loadPair(p + 4 * s, s), loadPair(p + 6 * s, s)));
+					re = unpacklo(lo, hi);
+					im = unpackhi(lo, hi);
+				}
+
+				static inline void storeStrided(double *p, std::size_t stride, Vec re, Vec im)
+				{
+					std::size_t s(2 * stride);
+					Vec lo(unpacklo(re, im)), hi(unpackhi(re, im));
+					storePair(p, s, extract<0>(lo));
+					storePair(p + 2 * s, s, extract<1>(lo));
+					storePair(p + 4 * s, s, extract<0>(hi));
+					storePair(p + 6 * s, s, extract<1>(hi));
+				}
+
+				static inline void loadTwiddles(const double *omega, std::size_t n, std::size_t step,
+					Vec &re, Vec &im)
+				{
+					if (step == 1) {
+						load(omega + 2 * n, re, im);
+					} else {
+						loadStrided(omega + 2 * n * step, step, re, im);
+					}
+				}
+			private:
+				static inline Vec unpacklo(Vec a, Vec b)
+				{
+					return _mm512_mask_unpacklo_pd(_mm512_setzero_pd(), 0xFF, a, b);
+				}
+
+				static inline Vec unpackhi(Vec a, Vec b)
+				{
+					return _mm512_mask_unpackhi_pd(_mm512_setzero_pd(), 0xFF, a, b);
+				}
+
+				static inline Vec combine(__m256d lo, __m256d hi)
+				{
+					return _mm512_mask_insertf64x4(_mm512_setzero_pd(), 0xFF,
+						_mm512_castpd256_pd512(lo), hi, 1);
+				}
+
+				template<int half>
+				static inline __m256d extract(Vec x)
+				{
+					return _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xFF, x, half);
+				}
+
+				// Two complex numbers, s doubles apart, into one 256-bit register, and back.
+				static inline __m256d loadPair(const double *p, std::size_t s)
+				{
+					return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p)),
+						_mm_loadu_pd(p + s), 1);
+				}
+
+				static inline void storePair(double *p, std::size_t s, __m256d x)
+				{
+					_mm_storeu_pd(p, _mm256_castpd256_pd128(x));
+					_mm_storeu_pd(p + s, _mm256_extractf128_pd(x, 1));
+				}
+		};
+	}
+
+	const ButterflyKernels *getAvx512Kernels()
+	{
+		static const ButterflyKernels kernels(VecButterflies::makeKernels<Avx512>("AVX-512"));
+
+		return &kernels;
+	}
+}
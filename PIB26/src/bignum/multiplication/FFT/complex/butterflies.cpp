@@ -2,8 +2,8 @@
  * PIB26 version 0.0.2
  * (C) 2020-2021 Shimrra Shai.
  * 
- * File:      genOmegaTable.cpp
- * Timestamp: Mar 28, 2021
+ * File:      butterflies.cpp
+ * Timestamp: Oct 17, 2026
  *
  */
 
@@ -22,23 +22,24 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-#include "genOmegaTable.hpp"
-
-#include "../../../../memory/buffers/local/RAMOnly.hpp"
-
-#include <cmath>
-
-namespace SDF::Bignum::Multiplication::Fft::Complex {
-	std::unique_ptr<Memory::ILocalBuffer<Cplex>> genOmegaTable(std::size_t length) {
-		std::unique_ptr<Memory::ILocalBuffer<Cplex>> buf(new Memory::Buffers::Local::RAMOnly<Cplex>(length));
-		Memory::SafePtr<Cplex> bufPtr(buf->accessData(0));
-
-		for(std::size_t i(0); i < length; ++i) {
-			bufPtr[i].r = cos(-2.0 * M_PI * i / length);
-			bufPtr[i].i = sin(-2.0 * M_PI * i / length);
-		}
-
-		return buf;
+#include "butterflies.hpp"
+
+namespace SDF::Bignum::Multiplication::Fft::Complex
+{
+	const ButterflyKernels *getButterflyKernels()
+	{
+		// The check is done once; the result cannot change while the program runs.
+		static const ButterflyKernels *kernels = []() -> const ButterflyKernels* {
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f")) {
+				return getAvx512Kernels();
+			} else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+				return getAvx2Kernels();
+			} else {
+				return nullptr;
+			}
+		}();
+
+		return kernels;
 	}
 }
-
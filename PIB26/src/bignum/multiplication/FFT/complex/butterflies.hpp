@@ -0,0 +1,100 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      butterflies.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_BUTTERFLIES_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_BUTTERFLIES_HPP_
+
+#include "Cplex.hpp"
+
+#include <cstddef>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex
+{
+	// Struct:     ButterflyKernels
+	// Purpose:    Holds the butterfly passes the complex FFTs use, written for a particular vector
+	//             instruction set. The data stays in the array-of-structs Cplex layout in memory,
+	//             but the kernels split it into real and imaginary planes in the vector registers,
+	//             so each instruction works on width butterflies at once. Each pass does the same
+	//             work as the scalar loop it replaces in rad2Rec, rad3Rec, rad4Rec, rad5Rec or
+	//             rad4Itr: for a block of radix * count elements, the butterflies for
+	//             n = 0 ... count - 1.
+	//             count must be a multiple of width, and blocks, where given, as well.
+	//
+	//             The passes differ in where they get their twiddles from:
+	//
+	//                Pass       - from one of the direct tables of TwiddleTable,
+	//                             omega[p * n * omegaStep] for the p-th power, as in the
+	//                             recursive FFTs.
+	//                PackedPass - from a small table holding the p-th power for butterfly n at
+	//                             twiddles[(p - 1) * count + n], so it can be loaded contiguously.
+	//                BatchPass  - as PackedPass, but does blocks consecutive blocks at once, each
+	//                             vector taking the same butterfly from width different blocks.
+	//                             This is for blocks too small to fill a vector.
+	//
+	//             The codelets are not passes but whole transforms of a fixed length, which rad4Itr
+	//             uses for its last (forward) or first (inverse) passes. Each does blocks
+	//             consecutive transforms, each vector taking the same element from width of them,
+	//             so blocks must be a multiple of width. They give the same result as the passes.
+	struct ButterflyKernels
+	{
+			typedef void (*Pass)(Cplex *data, std::size_t count, const Cplex *omega,
+				std::size_t omegaStep);
+			typedef void (*PackedPass)(Cplex *data, std::size_t count, const Cplex *twiddles);
+			typedef void (*BatchPass)(Cplex *data, std::size_t count, std::size_t blocks,
+				const Cplex *twiddles);
+			typedef void (*Codelet)(Cplex *data, std::size_t blocks);
+
+			const char *name;
+			std::size_t width;
+
+			Pass rad2Fwd, rad2Rev;
+			Pass rad3Fwd, rad3Rev;
+			Pass rad5Fwd, rad5Rev;
+			Pass rad8Fwd, rad8Rev;
+			Pass rad4Fwd, rad4Rev;
+			PackedPass rad4FwdPacked, rad4RevPacked;
+			BatchPass rad4FwdBatch, rad4RevBatch;
+			Codelet fft4Fwd, fft4Rev;
+			Codelet fft16Fwd, fft16Rev;
+			Codelet fft64Fwd, fft64Rev;
+	};
+
+	// Function:   getButterflyKernels
+	// Purpose:    Get the widest butterfly kernels the running CPU supports.
+	// Parameters: None.
+	// Returns:    The kernels, or nullptr if the CPU supports none of them, in which case the FFTs
+	//             should use their scalar loops.
+	const ButterflyKernels *getButterflyKernels();
+
+	// Function:   getAvx2Kernels, getAvx512Kernels
+	// Purpose:    Get the kernels for a specific instruction set. These are compiled separately
+	//             with the instruction set enabled, so they must only be used when the CPU
+	//             supports it. Use getButterflyKernels instead.
+	// Parameters: None.
+	// Returns:    The kernels.
+	const ButterflyKernels *getAvx2Kernels();
+	const ButterflyKernels *getAvx512Kernels();
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_BUTTERFLIES_HPP_ */
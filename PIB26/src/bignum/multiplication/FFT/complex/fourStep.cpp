@@ -0,0 +1,589 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      fourStep.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "fourStep.hpp"
+
+#include "../FFTTweak.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex
+{
+	// The odd factors of the row and column lengths.
+	static const std::size_t c_bases[] = { 1, 3, 5, 15 };
+
+	fourStep::fourStep(const TwiddleTable &twiddles, Util::ThreadPool *threadPool,
+		FftPlanner *planner, Memory::Buffers::Local::ScratchPool *scratch)
+		: ComplexFft(threadPool), m_twiddles(twiddles), m_omegaSize(twiddles.getSize()),
+		  m_innerFft(twiddles, threadPool), m_planner(planner),
+		  m_directThreshold(getIterativeCacheSize() / sizeof(Cplex)),
+		  m_maxBlockLen(getBlockCacheSize() / sizeof(Cplex)),
+		  m_lineLen(Util::getCacheSizes().lineSize / sizeof(Cplex)),
+		  m_tileLen(1), m_scratch(scratch)
+	{
+		if (m_lineLen == 0) {
+			m_lineLen = 1;
+		}
+
+		// Two tiles have to fit at once.
+		while (2 * (2 * m_tileLen) * (2 * m_tileLen) * sizeof(Cplex) <= getTileCacheSize()) {
+			m_tileLen <<= 1;
+		}
+
+		if (m_planner != nullptr) {
+			FftPlanner::Crossovers crossovers;
+			if (!m_planner->getCrossovers(crossovers)) {
+				crossovers = planCrossovers();
+				m_planner->setCrossovers(crossovers);
+			}
+
+			m_innerFft.setCrossovers(crossovers.iterativeLen, crossovers.minRadix8Len);
+		}
+	}
+
+	std::size_t fourStep::getMaxFftSize() const
+	{
+		return m_innerFft.getMaxFftSize();
+	}
+
+	std::size_t fourStep::getNearestSafeLengthTo(std::size_t length) const
+	{
+		return m_innerFft.getNearestSafeLengthTo(length);
+	}
+
+	void fourStep::doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		if (len <= m_directThreshold) {
+			m_innerFft.doFwdTransform(data, len);
+		} else {
+			runFwd(data, len, getPlan(len));
+		}
+	}
+
+	void fourStep::doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		if (len <= m_directThreshold) {
+			m_innerFft.doRevTransform(data, len);
+		} else {
+			runRev(data, len, getPlan(len));
+		}
+	}
+
+	void fourStep::runFwd(Memory::SafePtr<Cplex> data, std::size_t len, const Plan &plan)
+	{
+		if (plan.direct) {
+			m_innerFft.doFwdTransform(data, len);
+		} else if (plan.sixStep) {
+			fwdSixStep(data, plan);
+		} else {
+			fwdFourStep(data, plan);
+		}
+	}
+
+	void fourStep::runRev(Memory::SafePtr<Cplex> data, std::size_t len, const Plan &plan)
+	{
+		if (plan.direct) {
+			m_innerFft.doRevTransform(data, len);
+		} else if (plan.sixStep) {
+			revSixStep(data, plan);
+		} else {
+			revFourStep(data, plan);
+		}
+	}
+
+	const fourStep::Plan &fourStep::getPlan(std::size_t len)
+	{
+		// Other lengths wait while a new one is timed, so the timings are not thrown off.
+		std::lock_guard<std::mutex> lock(m_planMutex);
+		auto it(m_plans.find(len));
+		if (it != m_plans.end()) {
+			return *it->second;
+		}
+
+		FftPlanner::Layout layout;
+		if (m_planner == nullptr) {
+			layout = getDefaultLayout(len);
+		} else if (!m_planner->getLayout(len, layout) || !isValidLayout(len, layout)) {
+			layout = planLayout(len);
+			m_planner->setLayout(len, layout);
+		}
+
+		std::unique_ptr<const Plan> &plan(m_plans[len]);
+		plan = makePlan(len, layout);
+
+		return *plan;
+	}
+
+	FftPlanner::Crossovers fourStep::planCrossovers()
+	{
+		// Time every length done in one piece, from where the choices start to matter, on zeros:
+		// the time taken does not depend on the values.
+		std::vector<std::size_t> lengths;
+		for (std::size_t base : c_bases) {
+			for (std::size_t len = base * 256; len <= m_directThreshold; len <<= 1) {
+				if (m_omegaSize % len == 0) {
+					lengths.push_back(len);
+				}
+			}
+		}
+
+		Memory::Buffers::Local::RAMOnly<Cplex> buffer(m_directThreshold);
+		Memory::SafePtr<Cplex> data(buffer.accessData(0));
+		for (std::size_t i = 0; i < m_directThreshold; ++i) {
+			data[i] = 0.0;
+		}
+
+		auto timeAll = [&](const FftPlanner::Crossovers &crossovers) {
+			m_innerFft.setCrossovers(crossovers.iterativeLen, crossovers.minRadix8Len);
+
+			double total(0.0);
+			for (std::size_t len : lengths) {
+				total += FftPlanner::timeBest(3, [&]() {
+					m_innerFft.doFwdTransform(data, len);
+					m_innerFft.doRevTransform(data, len);
+				});
+			}
+
+			return total;
+		};
+
+		// The iterative transform is built for up to the length that fits in the cache with its
+		// twiddles, so it can take every length below 4 times that. Find the best crossover
+		// for it with the default radix-8 one, then the best radix-8 one with that.
+		FftPlanner::Crossovers best { getIterativeCacheSize() / (2 * sizeof(Cplex)),
+			g_minRadix8FftLength };
+		double bestTime(timeAll(best));
+		std::size_t maxIterativeLen(4 * best.iterativeLen);
+		for (std::size_t iterativeLen = 1024; iterativeLen <= maxIterativeLen; iterativeLen <<= 2) {
+			FftPlanner::Crossovers candidate { iterativeLen, best.minRadix8Len };
+			double time(timeAll(candidate));
+			if (time < bestTime) {
+				best = candidate;
+				bestTime = time;
+			}
+		}
+
+		static const std::size_t c_radix8Lens[] = { 0, 32, 128, 512, 2048, 8192, 32768 };
+		std::size_t bestIterativeLen(best.iterativeLen);
+		for (std::size_t minRadix8Len : c_radix8Lens) {
+			FftPlanner::Crossovers candidate { bestIterativeLen, minRadix8Len };
+			double time(timeAll(candidate));
+			if (time < bestTime) {
+				best = candidate;
+				bestTime = time;
+			}
+		}
+
+		return best;
+	}
+
+	FftPlanner::Layout fourStep::planLayout(std::size_t len)
+	{
+		// The candidates: the default layout, doing it in one piece, the square six-step form if
+		// it can be done, and the four-step splits with the sides within a factor of 2 of each
+		// other, gathering the default number of columns at once.
+		std::vector<FftPlanner::Layout> candidates;
+		candidates.push_back(getDefaultLayout(len));
+		candidates.push_back(FftPlanner::Layout { true, false, 0, 0 });
+
+		std::size_t side(std::sqrt(static_cast<double>(len)));
+		while (side * side < len) {
+			++side;
+		}
+
+		if ((side * side == len) && (side % m_tileLen == 0)) {
+			candidates.push_back(FftPlanner::Layout { false, true, side, side });
+		}
+
+		for (std::size_t base : c_bases) {
+			for (std::size_t cols = base; (cols <= m_maxBlockLen) && (len % cols == 0); cols <<= 1) {
+				std::size_t rows(len / cols);
+				if ((2 * cols < rows) || (cols > 2 * rows)
+					|| (rad5Rec::getNearestSafeLength(rows, m_omegaSize) != rows))
+				{
+					continue;
+				}
+
+				std::size_t blockCols(getDefaultBlockCols(rows, cols));
+				if (blockCols != 0) {
+					candidates.push_back(FftPlanner::Layout { false, false, cols, blockCols });
+				}
+			}
+		}
+
+		Memory::Buffers::Local::RAMOnly<Cplex> buffer(len);
+		Memory::SafePtr<Cplex> data(buffer.accessData(0));
+		for (std::size_t i = 0; i < len; ++i) {
+			data[i] = 0.0;
+		}
+
+		auto timeLayout = [&](const FftPlanner::Layout &layout) {
+			std::unique_ptr<Plan> plan(makePlan(len, layout));
+			return FftPlanner::timeBest(2, [&]() {
+				runFwd(data, len, *plan);
+				runRev(data, len, *plan);
+			});
+		};
+
+		FftPlanner::Layout best(candidates[0]);
+		double bestTime(timeLayout(best));
+		for (std::size_t i = 1; i < candidates.size(); ++i) {
+			double time(timeLayout(candidates[i]));
+			if (time < bestTime) {
+				best = candidates[i];
+				bestTime = time;
+			}
+		}
+
+		// Then try gathering more and fewer columns at once with the best four-step split.
+		if (!best.direct && !best.sixStep) {
+			std::size_t baseBlockCols(best.blockCols);
+			for (std::size_t blockCols : { (baseBlockCols / 2) / m_lineLen * m_lineLen,
+				2 * baseBlockCols })
+			{
+				FftPlanner::Layout candidate { false, false, best.cols, blockCols };
+				if ((blockCols < m_lineLen) || (blockCols > best.cols)
+					|| (blockCols * (len / best.cols) > 2 * m_maxBlockLen))
+				{
+					continue;
+				}
+
+				double time(timeLayout(candidate));
+				if (time < bestTime) {
+					best = candidate;
+					bestTime = time;
+				}
+			}
+		}
+
+		return best;
+	}
+
+	std::size_t fourStep::getDefaultBlockCols(std::size_t rows, std::size_t cols) const
+	{
+		// Gather as many whole cache lines of each row as will fit.
+		std::size_t blockCols((m_maxBlockLen / rows) / m_lineLen * m_lineLen);
+		if (blockCols < m_lineLen) {
+			return 0;
+		}
+
+		return (blockCols > cols) ? cols : blockCols;
+	}
+
+	FftPlanner::Layout fourStep::getDefaultLayout(std::size_t len) const
+	{
+		// Split as evenly as we can, so that both the row and the column transforms are short
+		// enough to run in cache, taking the longer side as the rows. Both have to be lengths
+		// rad5Rec can do, i.e. 2^n, 3 * 2^n, 5 * 2^n or 15 * 2^n. Failing that, make the rows as
+		// long as will fit.
+		std::size_t cols(0);
+		std::size_t maxCols(1);
+		for (std::size_t base : c_bases) {
+			for (std::size_t c = base; (c <= m_maxBlockLen) && (len % c == 0); c <<= 1) {
+				if (c * c >= len) {
+					if ((cols == 0) || (c < cols)) {
+						cols = c;
+					}
+					break;
+				}
+
+				if (c > maxCols) {
+					maxCols = c;
+				}
+			}
+		}
+
+		if (cols == 0) {
+			cols = maxCols;
+		}
+
+		FftPlanner::Layout layout { false, false, cols, getDefaultBlockCols(len / cols, cols) };
+		if (layout.blockCols == 0) {
+			// The columns are too tall even for one cache line of each row. Go square if we can.
+			std::size_t side(std::sqrt(static_cast<double>(len)));
+			while (side * side < len) {
+				++side;
+			}
+
+			if ((side * side == len) && (side % m_tileLen == 0)) {
+				layout = FftPlanner::Layout { false, true, side, side };
+			} else {
+				layout.blockCols = (m_lineLen < cols) ? m_lineLen : cols;
+			}
+		}
+
+		return layout;
+	}
+
+	bool fourStep::isValidLayout(std::size_t len, const FftPlanner::Layout &layout) const
+	{
+		if (layout.direct) {
+			return true;
+		}
+
+		if ((layout.cols == 0) || (len % layout.cols != 0) || (layout.blockCols == 0)
+			|| (layout.blockCols > layout.cols))
+		{
+			return false;
+		}
+
+		std::size_t rows(len / layout.cols);
+		if ((rad5Rec::getNearestSafeLength(rows, m_omegaSize) != rows)
+			|| (rad5Rec::getNearestSafeLength(layout.cols, m_omegaSize) != layout.cols))
+		{
+			return false;
+		}
+
+		return !layout.sixStep || ((rows == layout.cols) && (rows % m_tileLen == 0));
+	}
+
+	std::unique_ptr<fourStep::Plan> fourStep::makePlan(std::size_t len,
+		const FftPlanner::Layout &layout)
+	{
+		std::unique_ptr<Plan> plan(std::make_unique<Plan>());
+		plan->direct = layout.direct;
+		if (plan->direct) {
+			return plan;
+		}
+
+		plan->rows = len / layout.cols;
+		plan->cols = layout.cols;
+		plan->blockCols = layout.blockCols;
+		plan->sixStep = layout.sixStep;
+
+		// The six-step form twiddles the rows in place, needing no scratch.
+		plan->scratchLen = plan->sixStep ? 0 : plan->blockCols * plan->rows;
+
+		// The column transforms leave their outputs scrambled, but the twiddles depend on the
+		// frequency, so find out which frequency lands where. Transforming an impulse at 1 puts
+		// w^k at the position of frequency k.
+		std::size_t rows(plan->rows);
+		Memory::Buffers::Local::RAMOnly<Cplex> impulse(rows);
+		Memory::SafePtr<Cplex> scratch(impulse.accessData(0));
+		plan->perm = std::make_unique<Memory::Buffers::Local::RAMOnly<std::size_t>>(rows);
+		Memory::SafePtr<std::size_t> perm(plan->perm->accessData(0));
+
+		scratch[1] = 1.0;
+		m_innerFft.doFwdTransform(scratch, rows);
+		for (std::size_t p = 0; p < rows; ++p) {
+			long k(std::lround(-std::atan2(scratch[p].i, scratch[p].r) * rows / (2.0 * M_PI)));
+			perm[p] = (k < 0) ? k + rows : k;
+		}
+
+		// Two-level twiddle tables, both around the square root of the length.
+		plan->twiddleShift = 0;
+		while ((std::size_t(1) << (2 * plan->twiddleShift)) < len) {
+			++plan->twiddleShift;
+		}
+
+		std::size_t loLen(std::size_t(1) << plan->twiddleShift);
+		std::size_t hiLen((len + loLen - 1) >> plan->twiddleShift);
+		std::size_t stride(m_omegaSize / len);
+
+		plan->twiddleLoBuffer = std::make_unique<Memory::Buffers::Local::RAMOnly<Cplex>>(loLen);
+		plan->twiddleHiBuffer = std::make_unique<Memory::Buffers::Local::RAMOnly<Cplex>>(hiLen);
+		Memory::SafePtr<Cplex> twiddleLo(plan->twiddleLoBuffer->accessData(0));
+		Memory::SafePtr<Cplex> twiddleHi(plan->twiddleHiBuffer->accessData(0));
+		for (std::size_t b = 0; b < loLen; ++b) {
+			twiddleLo[b] = m_twiddles[b * stride];
+		}
+
+		for (std::size_t a = 0; a < hiLen; ++a) {
+			twiddleHi[a] = m_twiddles[(a << plan->twiddleShift) * stride];
+		}
+
+		plan->twiddleLo = twiddleLo;
+		plan->twiddleHi = twiddleHi;
+
+		return plan;
+	}
+
+	inline Cplex fourStep::twiddle(const Plan &plan, std::size_t j)
+	{
+		const Cplex &h(plan.twiddleHi[j >> plan.twiddleShift]);
+		const Cplex &l(plan.twiddleLo[j & ((std::size_t(1) << plan.twiddleShift) - 1)]);
+		return Cplex(h.r * l.r - h.i * l.i, h.r * l.i + h.i * l.r);
+	}
+
+	void fourStep::transpose(Memory::SafePtr<Cplex> data, const Plan &plan)
+	{
+		// Each task takes a row of tiles right of the diagonal and the matching column below it,
+		// so no two tasks touch the same tile.
+		std::size_t side(plan.rows);
+		runParallel(side / m_tileLen, [&](std::size_t tileRow, std::size_t) {
+			std::size_t i0(tileRow * m_tileLen);
+			for (std::size_t j0 = i0; j0 < side; j0 += m_tileLen) {
+				for (std::size_t i = i0; i < i0 + m_tileLen; ++i) {
+					for (std::size_t j = (j0 == i0) ? i + 1 : j0; j < j0 + m_tileLen; ++j) {
+						Cplex tmp(data[i * side + j]);
+						data[i * side + j] = data[j * side + i];
+						data[j * side + i] = tmp;
+					}
+				}
+			}
+		});
+	}
+
+	void fourStep::twiddleColumn(Memory::SafePtr<Cplex> col, std::size_t c, bool conjugate,
+		const Plan &plan)
+	{
+		Memory::SafePtr<const std::size_t> perm(plan.perm->accessData(0));
+		double sign(conjugate ? -1.0 : 1.0);
+
+		for (std::size_t p = 0; p < plan.rows; ++p) {
+			Cplex w(twiddle(plan, perm[p] * c));
+			w.i *= sign;
+
+			Cplex x(col[p]);
+			col[p].r = x.r * w.r - x.i * w.i;
+			col[p].i = x.r * w.i + x.i * w.r;
+		}
+	}
+
+	void fourStep::gatherColumns(Memory::SafePtr<Cplex> data, Memory::SafePtr<Cplex> scratch,
+		std::size_t c0, std::size_t width, const Plan &plan)
+	{
+		for (std::size_t r = 0; r < plan.rows; ++r) {
+			for (std::size_t b = 0; b < width; ++b) {
+				scratch[b * plan.rows + r] = data[r * plan.cols + c0 + b];
+			}
+		}
+	}
+
+	void fourStep::scatterColumns(Memory::SafePtr<Cplex> data, Memory::SafePtr<Cplex> scratch,
+		std::size_t c0, std::size_t width, const Plan &plan)
+	{
+		for (std::size_t r = 0; r < plan.rows; ++r) {
+			for (std::size_t b = 0; b < width; ++b) {
+				data[r * plan.cols + c0 + b] = scratch[b * plan.rows + r];
+			}
+		}
+	}
+
+	void fourStep::runRowGroups(std::size_t numRows, std::size_t rowLen,
+		const std::function<void(std::size_t, std::size_t)> &task)
+	{
+		std::size_t perGroup((rowLen < m_maxBlockLen) ? m_maxBlockLen / rowLen : 1);
+		std::size_t numGroups((numRows + perGroup - 1) / perGroup);
+
+		runParallel(numGroups, [&](std::size_t group, std::size_t) {
+			std::size_t first(group * perGroup);
+			task(first, (numRows - first < perGroup) ? numRows - first : perGroup);
+		});
+	}
+
+	void fourStep::fwdFourStep(Memory::SafePtr<Cplex> data, const Plan &plan)
+	{
+		std::size_t rows(plan.rows);
+		std::size_t cols(plan.cols);
+		std::size_t blockCols(plan.blockCols);
+
+		// Columns, a block at a time, each thread gathering into its own slot of the scratch.
+		auto scratchLease(m_scratch->borrow<Cplex>(getNumThreads() * plan.scratchLen));
+		std::size_t numBlocks((cols + blockCols - 1) / blockCols);
+		runParallel(numBlocks, [&](std::size_t block, std::size_t thread) {
+			Memory::SafePtr<Cplex> scratch(scratchLease.accessData(thread * plan.scratchLen));
+			std::size_t c0(block * blockCols);
+			std::size_t width((cols - c0 < blockCols) ? cols - c0 : blockCols);
+
+			gatherColumns(data, scratch, c0, width, plan);
+			m_innerFft.doFwdTransforms(scratch, rows, width);
+			for (std::size_t b = 0; b < width; ++b) {
+				twiddleColumn(scratch + b * rows, c0 + b, false, plan);
+			}
+			scatterColumns(data, scratch, c0, width, plan);
+		});
+
+		// Rows.
+		runRowGroups(rows, cols, [&](std::size_t first, std::size_t num) {
+			m_innerFft.doFwdTransforms(data + first * cols, cols, num);
+		});
+	}
+
+	void fourStep::revFourStep(Memory::SafePtr<Cplex> data, const Plan &plan)
+	{
+		std::size_t rows(plan.rows);
+		std::size_t cols(plan.cols);
+		std::size_t blockCols(plan.blockCols);
+
+		// Exactly the forward steps undone, in the opposite order.
+		runRowGroups(rows, cols, [&](std::size_t first, std::size_t num) {
+			m_innerFft.doRevTransforms(data + first * cols, cols, num);
+		});
+
+		auto scratchLease(m_scratch->borrow<Cplex>(getNumThreads() * plan.scratchLen));
+		std::size_t numBlocks((cols + blockCols - 1) / blockCols);
+		runParallel(numBlocks, [&](std::size_t block, std::size_t thread) {
+			Memory::SafePtr<Cplex> scratch(scratchLease.accessData(thread * plan.scratchLen));
+			std::size_t c0(block * blockCols);
+			std::size_t width((cols - c0 < blockCols) ? cols - c0 : blockCols);
+
+			gatherColumns(data, scratch, c0, width, plan);
+			for (std::size_t b = 0; b < width; ++b) {
+				twiddleColumn(scratch + b * rows, c0 + b, true, plan);
+			}
+			m_innerFft.doRevTransforms(scratch, rows, width);
+			scatterColumns(data, scratch, c0, width, plan);
+		});
+	}
+
+	void fourStep::fwdSixStep(Memory::SafePtr<Cplex> data, const Plan &plan)
+	{
+		std::size_t side(plan.rows);
+
+		// The columns become rows, which get transformed and twiddled while in cache.
+		transpose(data, plan);
+		runRowGroups(side, side, [&](std::size_t first, std::size_t num) {
+			m_innerFft.doFwdTransforms(data + first * side, side, num);
+			for (std::size_t c = first; c < first + num; ++c) {
+				twiddleColumn(data + c * side, c, false, plan);
+			}
+		});
+
+		transpose(data, plan);
+		runRowGroups(side, side, [&](std::size_t first, std::size_t num) {
+			m_innerFft.doFwdTransforms(data + first * side, side, num);
+		});
+	}
+
+	void fourStep::revSixStep(Memory::SafePtr<Cplex> data, const Plan &plan)
+	{
+		std::size_t side(plan.rows);
+
+		runRowGroups(side, side, [&](std::size_t first, std::size_t num) {
+			m_innerFft.doRevTransforms(data + first * side, side, num);
+		});
+
+		transpose(data, plan);
+		runRowGroups(side, side, [&](std::size_t first, std::size_t num) {
+			for (std::size_t c = first; c < first + num; ++c) {
+				twiddleColumn(data + c * side, c, true, plan);
+			}
+			m_innerFft.doRevTransforms(data + first * side, side, num);
+		});
+
+		transpose(data, plan);
+	}
+}
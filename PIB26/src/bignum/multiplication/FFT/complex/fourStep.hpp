@@ -0,0 +1,245 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      fourStep.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_FOURSTEP_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_FOURSTEP_HPP_
+
+#include "ComplexFft.hpp"
+
+#include "../../../../memory/SafePtr.hpp"
+#include "../../../../memory/buffers/local/RAMOnly.hpp"
+#include "../../../../memory/buffers/local/ScratchPool.hpp"
+
+#include "Cplex.hpp"
+#include "FftPlanner.hpp"
+#include "TwiddleTable.hpp"
+
+#include "rad5Rec.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex {
+	// Class:      fourStep
+	// Purpose:    Wraps Bailey's cache-blocked complex FFT. A transform too big for the cache is
+	//             viewed as a matrix with rows that fit in it. The columns are transformed a block
+	//             at a time, gathered into a small scratch buffer, then twiddled, then the rows are
+	//             transformed. That is two passes over memory, where the recursive transforms
+	//             make one per level. When even a narrow block of columns would not fit, and the
+	//             matrix can be square, it instead uses the six-step form with explicit blocked
+	//             transposes, so that all the transforms are on contiguous rows. The final
+	//             transpose is left out, as the output order of these transforms is scrambled
+	//             anyway; the reverse transform undoes this same order. The row and column
+	//             transforms are done by rad5Rec, which also does all transforms that fit in the
+	//             cache already. The blocks, rows and transposes are spread over the thread
+	//             pool, if there is one.
+	//
+	//             Given a planner, the shape of the matrix, the width of the column blocks, and
+	//             whether to block at all are chosen per length by timing the likely candidates
+	//             the first time the length is used, as are the crossovers of the transforms
+	//             underneath on construction, unless the planner already has them from an earlier
+	//             run. Without one, they are worked out from the cache sizes. The plan for each
+	//             length is kept, and not changed once made, so transforms of any lengths may run
+	//             at once; the column blocks are gathered into scratch borrowed for each transform.
+	// Parameters: None.
+	class fourStep : public ComplexFft {
+		public:
+			// Function:  fourStep
+			// Purpose:   Construct the transform.
+			// Arguments: twiddles - The twiddle table.
+			//            threadPool - The pool to run on.
+			//            planner - The planner to plan the transforms with, or nullptr to use
+			//                      the defaults.
+			//            scratch - The pool to borrow the column block scratch from.
+			fourStep(const TwiddleTable &twiddles, Util::ThreadPool *threadPool,
+				FftPlanner *planner, Memory::Buffers::Local::ScratchPool *scratch);
+
+			std::size_t getMaxFftSize() const;
+			std::size_t getNearestSafeLengthTo(std::size_t length) const;
+
+			void doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len);
+			void doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len);
+		private:
+			const TwiddleTable &m_twiddles;
+			std::size_t m_omegaSize;
+
+			rad5Rec m_innerFft;
+
+			FftPlanner *m_planner;
+
+			std::size_t m_directThreshold; // longer transforms than this are blocked
+			std::size_t m_maxBlockLen; // elements in a row or a column block
+			std::size_t m_lineLen; // elements per cache line
+			std::size_t m_tileLen; // side of the transpose tiles
+
+			// Structure: Plan
+			// Purpose:   The layout of a blocked transform of one length, with the permutation
+			//            and twiddles for it.
+			struct Plan
+			{
+					bool direct; // done in one piece after all
+					bool sixStep;
+					std::size_t rows;
+					std::size_t cols;
+					std::size_t blockCols; // columns gathered into scratch at once
+					std::size_t scratchLen; // scratch for a block of columns, per thread
+
+					// The frequency each output position of a column transform holds.
+					std::unique_ptr<Memory::Buffers::Local::RAMOnly<std::size_t>> perm;
+
+					// The twiddles w^j are built as twiddleHi[j >> twiddleShift] *
+					// twiddleLo[j & mask], two tables small enough to stay in cache.
+					std::unique_ptr<Memory::Buffers::Local::RAMOnly<Cplex>> twiddleHiBuffer;
+					std::unique_ptr<Memory::Buffers::Local::RAMOnly<Cplex>> twiddleLoBuffer;
+					Memory::SafePtr<const Cplex> twiddleHi;
+					Memory::SafePtr<const Cplex> twiddleLo;
+					std::size_t twiddleShift;
+			};
+
+			Memory::Buffers::Local::ScratchPool *m_scratch;
+
+			// The plans made so far, by length.
+			std::mutex m_planMutex;
+			std::map<std::size_t, std::unique_ptr<const Plan>> m_plans;
+
+			// Function:   getPlan
+			// Purpose:    Get the plan for a blocked transform of a given length, making it first
+			//             if need be, planning the layout too if the planner has none. This is
+			//             thread-safe.
+			// Parameters: len - The transform length.
+			// Returns:    The plan. It lasts as long as the transform.
+			const Plan &getPlan(std::size_t len);
+
+			// Function:   planCrossovers
+			// Purpose:    Find the fastest crossovers for the transforms done in one piece, by
+			//             timing each candidate on all the lengths they are done for.
+			// Parameters: None.
+			// Returns:    The crossovers.
+			FftPlanner::Crossovers planCrossovers();
+
+			// Function:   planLayout
+			// Purpose:    Find the fastest layout for a transform length, by timing the default
+			//             one and the others near it.
+			// Parameters: len - The transform length.
+			// Returns:    The layout.
+			FftPlanner::Layout planLayout(std::size_t len);
+
+			// Function:   getDefaultLayout
+			// Purpose:    Work out the layout for a transform length from the cache sizes.
+			// Parameters: len - The transform length.
+			// Returns:    The layout.
+			FftPlanner::Layout getDefaultLayout(std::size_t len) const;
+
+			// Function:   getDefaultBlockCols
+			// Purpose:    Work out how many columns to gather at once from the cache sizes.
+			// Parameters: rows - The number of rows, i.e. the length of each column.
+			//             cols - The number of columns.
+			// Returns:    The number of columns, or 0 if even one cache line of each row will
+			//             not fit.
+			std::size_t getDefaultBlockCols(std::size_t rows, std::size_t cols) const;
+
+			// Function:   isValidLayout
+			// Purpose:    Check that a layout can be used for a transform length, e.g. one read
+			//             from a wisdom file.
+			// Parameters: len - The transform length.
+			//             layout - The layout.
+			// Returns:    Whether it can be.
+			bool isValidLayout(std::size_t len, const FftPlanner::Layout &layout) const;
+
+			// Function:   makePlan
+			// Purpose:    Set up the permutation, twiddles and scratch size for a layout.
+			// Parameters: len - The transform length.
+			//             layout - The layout.
+			// Returns:    The plan.
+			std::unique_ptr<Plan> makePlan(std::size_t len, const FftPlanner::Layout &layout);
+
+			// Function:   runFwd/runRev
+			// Purpose:    Do a long transform in a given layout.
+			// Parameters: data - The data.
+			//             len - The transform length.
+			//             plan - The plan for the length.
+			// Returns:    None.
+			void runFwd(Memory::SafePtr<Cplex> data, std::size_t len, const Plan &plan);
+			void runRev(Memory::SafePtr<Cplex> data, std::size_t len, const Plan &plan);
+
+			// Function:   twiddle
+			// Purpose:    Get the twiddle factor w^j for a transform length.
+			// Parameters: plan - The plan for the length.
+			//             j - The power, less than the transform length.
+			// Returns:    The twiddle factor.
+			static Cplex twiddle(const Plan &plan, std::size_t j);
+
+			// Function:   transpose
+			// Purpose:    Transpose the square matrix of a six-step plan in place, a pair of tiles
+			//             at a time.
+			// Parameters: data - The matrix.
+			//             plan - The plan.
+			// Returns:    None.
+			void transpose(Memory::SafePtr<Cplex> data, const Plan &plan);
+
+			// Function:   twiddleColumn
+			// Purpose:    Multiply a transformed column by its twiddles, or their conjugates.
+			// Parameters: col - The column.
+			//             c - The column number.
+			//             conjugate - Whether to conjugate the twiddles, for the reverse.
+			//             plan - The plan.
+			// Returns:    None.
+			static void twiddleColumn(Memory::SafePtr<Cplex> col, std::size_t c, bool conjugate,
+				const Plan &plan);
+
+			// Function:   gatherColumns/scatterColumns
+			// Purpose:    Copy a block of columns to/from a thread's scratch slot.
+			// Parameters: data - The matrix.
+			//             scratch - The slot.
+			//             c0 - The first column of the block.
+			//             width - The number of columns in the block.
+			//             plan - The plan.
+			// Returns:    None.
+			static void gatherColumns(Memory::SafePtr<Cplex> data, Memory::SafePtr<Cplex> scratch,
+				std::size_t c0, std::size_t width, const Plan &plan);
+			static void scatterColumns(Memory::SafePtr<Cplex> data,
+				Memory::SafePtr<Cplex> scratch, std::size_t c0, std::size_t width,
+				const Plan &plan);
+
+			// Function:   runRowGroups
+			// Purpose:    Run a task over the rows of the matrix, in groups of consecutive rows
+			//             that together fit in a block, spread over the thread pool.
+			// Parameters: numRows - The number of rows.
+			//             rowLen - The length of each row.
+			//             task - Does the rows first ... first + num - 1.
+			// Returns:    None.
+			void runRowGroups(std::size_t numRows, std::size_t rowLen,
+				const std::function<void(std::size_t first, std::size_t num)> &task);
+
+			void fwdFourStep(Memory::SafePtr<Cplex> data, const Plan &plan);
+			void revFourStep(Memory::SafePtr<Cplex> data, const Plan &plan);
+			void fwdSixStep(Memory::SafePtr<Cplex> data, const Plan &plan);
+			void revSixStep(Memory::SafePtr<Cplex> data, const Plan &plan);
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_FOURSTEP_HPP_ */
@@ -31,8 +31,8 @@
 
 namespace SDF::Bignum::Multiplication::Fft::Complex
 {
-	rad2Itr::rad2Itr(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize)
-		: m_omegaTable(omegaTable), m_omegaSize(omegaSize)
+	rad2Itr::rad2Itr(const TwiddleTable &twiddles)
+		: m_twiddles(twiddles), m_omegaSize(twiddles.getSize())
 	{
 	}
 
@@ -77,7 +77,7 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 				std::size_t half(step >> 1);
 
 				for (std::size_t n = 0; n < half; ++n) {
-					Cplex w = m_omegaTable[n * omegaStep];
+					Cplex w = m_twiddles[n * omegaStep];
 
 					Cplex tmp1 = { chunk[n].r + chunk[n + half].r, chunk[n].i + chunk[n + half].i };
 					Cplex tmp2 = { chunk[n].r - chunk[n + half].r, chunk[n].i - chunk[n + half].i };
@@ -106,7 +106,7 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 				std::size_t half(step >> 1);
 
 				for (std::size_t k = 0; k < half; ++k) {
-					Cplex w = m_omegaTable[k * omegaStep];
+					Cplex w = m_twiddles[k * omegaStep];
 					w.i = -w.i; // inverse roots are just conjugates
 
 					Cplex tmp1 { chunk[k].r, chunk[k].i };
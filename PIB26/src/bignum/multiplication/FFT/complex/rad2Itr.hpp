@@ -29,6 +29,7 @@
 #include "../../../../memory/SafePtr.hpp"
 
 #include "Cplex.hpp"
+#include "TwiddleTable.hpp"
 
 #include <cstddef>
 #include <vector>
@@ -41,7 +42,7 @@ namespace SDF::Bignum::Multiplication::Fft::Complex {
 	class rad2Itr : public ComplexFft {
 		public:
 			// NOTE: The FFT size passed to this MUST be a power of 2!
-			rad2Itr(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize);
+			rad2Itr(const TwiddleTable &twiddles);
 
 			std::size_t getMaxFftSize() const;
 			std::size_t getNearestSafeLengthTo(std::size_t length) const;
@@ -49,7 +50,7 @@ namespace SDF::Bignum::Multiplication::Fft::Complex {
 			void doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len);
 			void doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len);
 		private:
-			Memory::SafePtr<Cplex> m_omegaTable;
+			const TwiddleTable &m_twiddles;
 			std::size_t m_omegaSize;
 	};
 }
@@ -32,9 +32,9 @@
 
 namespace SDF::Bignum::Multiplication::Fft::Complex
 {
-	rad2Rec::rad2Rec(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize)
-		: m_omegaTable(omegaTable), m_omegaSize(omegaSize),
-		  m_rad4Fft(omegaTable, omegaSize)
+	rad2Rec::rad2Rec(const TwiddleTable &twiddles, Util::ThreadPool *threadPool)
+		: ComplexFft(threadPool), m_twiddles(twiddles), m_omegaSize(twiddles.getSize()),
+		  m_minRadix8Len(g_minRadix8FftLength), m_rad4Fft(twiddles, threadPool)
 	{
 	}
 
@@ -66,39 +66,51 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 		}
 	}
 
+	std::size_t rad2Rec::oddPowerRadix(std::size_t len) const
+	{
+		return ((m_minRadix8Len != 0) && (len >= m_minRadix8Len)) ? 8 : 2;
+	}
+
+	void rad2Rec::setCrossovers(std::size_t iterativeLen, std::size_t minRadix8Len)
+	{
+		m_minRadix8Len = minRadix8Len;
+		m_rad4Fft.setIterativeLen(iterativeLen);
+	}
+
 	void rad2Rec::doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		doFwdTransforms(data, len, 1);
+	}
+
+	void rad2Rec::doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		doRevTransforms(data, len, 1);
+	}
+
+	void rad2Rec::doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
 	{
 		// The forward transform is done as a decimation-in-frequency (DIF) version.
 		// The DIF version in a sense is just "built backwards" from the DIT version.
 		if (len & 0x5555555555555555UL) { // quick check for even powers of 2 NB: needs recalibrating
 			                               // for 32-bit machines
-			// Right now, we only use the radix-2 to break an odd power of 2 so we can then use the
-			// radix-4.
-			m_rad4Fft.doFwdTransform(data, len);
+			// Right now, we only use the radix-2 (or radix-8) to break an odd power of 2 so we can
+			// then use the radix-4.
+			m_rad4Fft.doFwdTransforms(data, len, count);
+		} else if ((count > 1) && (len * count > m_batchLimit)) {
+			runBatches(len, count, [&](std::size_t first, std::size_t num) {
+				doFwdTransforms(data + first * len, len, num);
+			});
 		} else {
-			std::size_t half(len >> 1);
-			std::size_t full(len);
-
-			for (std::size_t n = 0; n < half; ++n) {
-				// NEW: use precomputed trig tables.
-				Cplex w = m_omegaTable[n * m_omegaSize / full];
-
-				Cplex tmp1 = { data[n].r + data[n + half].r, data[n].i + data[n + half].i };
-				Cplex tmp2 = { data[n].r - data[n + half].r, data[n].i - data[n + half].i };
-
-				data[n].r = tmp1.r;
-				data[n].i = tmp1.i;
-
-				data[n + half].r = tmp2.r * w.r - tmp2.i * w.i;
-				data[n + half].i = tmp2.r * w.i + tmp2.i * w.r;
+			std::size_t radix(oddPowerRadix(len));
+			for (std::size_t b = 0; b < count; ++b) {
+				fwdPass(data + b * len, len);
 			}
 
-			doFwdTransform(data, half);
-			doFwdTransform(data + half, half);
+			m_rad4Fft.doFwdTransforms(data, len / radix, count * radix);
 		}
 	}
 
-	void rad2Rec::doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	void rad2Rec::doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
 	{
 		// Effectively assumes the data has been already sorted into even and odd parts, so that
 		// data(R/I) is the even part and data(R/I) + 2^(pow / 2) is the odd part. This way we can
@@ -107,7 +119,80 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 		// where it has that use, one will need to adapt the implementation or fashion a suitable
 		// frontend that will recursively sort the data.
 		if (len & 0x5555555555555555UL) {
-			m_rad4Fft.doRevTransform(data, len);
+			m_rad4Fft.doRevTransforms(data, len, count);
+		} else if ((count > 1) && (len * count > m_batchLimit)) {
+			runBatches(len, count, [&](std::size_t first, std::size_t num) {
+				doRevTransforms(data + first * len, len, num);
+			});
+		} else {
+			std::size_t radix(oddPowerRadix(len));
+			m_rad4Fft.doRevTransforms(data, len / radix, count * radix);
+
+			for (std::size_t b = 0; b < count; ++b) {
+				revPass(data + b * len, len);
+			}
+		}
+	}
+
+	void rad2Rec::fwdPass(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		std::size_t full(len);
+
+		if (oddPowerRadix(len) == 8) {
+			// Break off a factor of 8 instead, which leaves an even power for the radix-4 and
+			// costs less than a radix-2 pass followed by a radix-4 one.
+			std::size_t eighth(len >> 3);
+
+			std::size_t step;
+			const Cplex *direct(m_twiddles.getDirect(full, step));
+			if (useKernels(eighth) && (direct != nullptr)) {
+				m_kernels->rad8Fwd(rawBlock(data, len), eighth, direct, step);
+			} else {
+				for (std::size_t n = 0; n < eighth; ++n) {
+					rad8FwdButterfly(data + n, eighth, n * m_omegaSize / full);
+				}
+			}
+		} else {
+			std::size_t half(len >> 1);
+
+			std::size_t step;
+			const Cplex *direct(m_twiddles.getDirect(full, step));
+			if (useKernels(half) && (direct != nullptr)) {
+				m_kernels->rad2Fwd(rawBlock(data, len), half, direct, step);
+			} else {
+				for (std::size_t n = 0; n < half; ++n) {
+					// NEW: use precomputed trig tables.
+					Cplex w = m_twiddles[n * m_omegaSize / full];
+
+					Cplex tmp1 = { data[n].r + data[n + half].r, data[n].i + data[n + half].i };
+					Cplex tmp2 = { data[n].r - data[n + half].r, data[n].i - data[n + half].i };
+
+					data[n].r = tmp1.r;
+					data[n].i = tmp1.i;
+
+					data[n + half].r = tmp2.r * w.r - tmp2.i * w.i;
+					data[n + half].i = tmp2.r * w.i + tmp2.i * w.r;
+				}
+			}
+		}
+	}
+
+	void rad2Rec::revPass(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		std::size_t full(len);
+
+		if (oddPowerRadix(len) == 8) {
+			std::size_t eighth(len >> 3);
+
+			std::size_t step;
+			const Cplex *direct(m_twiddles.getDirect(full, step));
+			if (useKernels(eighth) && (direct != nullptr)) {
+				m_kernels->rad8Rev(rawBlock(data, len), eighth, direct, step);
+			} else {
+				for (std::size_t n = 0; n < eighth; ++n) {
+					rad8RevButterfly(data + n, eighth, n * m_omegaSize / full);
+				}
+			}
 		} else {
 			// Do the recursion:
 			//    X_k =                sum_{m=0...N/2-1} x_{2m} e^(-2piimk/(N/2))
@@ -117,25 +202,124 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 			//    X_k =         x_E_k + e^(-2piik/N) x_O_k
 			//    X_{k + N/2} = x_E_k - e^(-2piik/N) x_O_k.
 			std::size_t half(len >> 1);
-			std::size_t full(len);
 
-			doRevTransform(data, half);
-			doRevTransform(data + half, half);
+			std::size_t step;
+			const Cplex *direct(m_twiddles.getDirect(full, step));
+			if (useKernels(half) && (direct != nullptr)) {
+				m_kernels->rad2Rev(rawBlock(data, len), half, direct, step);
+			} else {
+				for (std::size_t k = 0; k < half; ++k) {
+					Cplex w = m_twiddles[k * m_omegaSize / full];
+					w.i = -w.i;
 
-			for (std::size_t k = 0; k < half; ++k) {
-				Cplex w = m_omegaTable[k * m_omegaSize / full];
-				w.i = -w.i;
+					Cplex tmp1 { data[k].r, data[k].i };
+					Cplex tmp2 { data[k + half].r * w.r - data[k + half].i * w.i, data[k + half].r * w.i
+						+ data[k + half].i * w.r };
 
-				Cplex tmp1 { data[k].r, data[k].i };
-				Cplex tmp2 { data[k + half].r * w.r - data[k + half].i * w.i, data[k + half].r * w.i
-					+ data[k + half].i * w.r };
+					data[k].r = tmp1.r + tmp2.r;
+					data[k].i = tmp1.i + tmp2.i;
 
-				data[k].r = tmp1.r + tmp2.r;
-				data[k].i = tmp1.i + tmp2.i;
-
-				data[k + half].r = tmp1.r - tmp2.r;
-				data[k + half].i = tmp1.i - tmp2.i;
+					data[k + half].r = tmp1.r - tmp2.r;
+					data[k + half].i = tmp1.i - tmp2.i;
+				}
 			}
 		}
 	}
+
+	// Length-4 DFT of d[0] ... d[3] in place; the forward and inverse ones differ only in
+	// which of outputs 1 and 3 gets e1 - i*o1.
+	static void dft4(Cplex *d, bool fwd)
+	{
+		Cplex e0 = { d[0].r + d[2].r, d[0].i + d[2].i };
+		Cplex e1 = { d[0].r - d[2].r, d[0].i - d[2].i };
+		Cplex o0 = { d[1].r + d[3].r, d[1].i + d[3].i };
+		Cplex o1 = { d[1].r - d[3].r, d[1].i - d[3].i };
+
+		std::size_t minus(fwd ? 1 : 3), plus(fwd ? 3 : 1);
+		d[0].r = e0.r + o0.r;
+		d[0].i = e0.i + o0.i;
+		d[2].r = e0.r - o0.r;
+		d[2].i = e0.i - o0.i;
+		d[minus].r = e1.r + o1.i;
+		d[minus].i = e1.i - o1.r;
+		d[plus].r = e1.r - o1.i;
+		d[plus].i = e1.i + o1.r;
+	}
+
+	void rad2Rec::rad8FwdButterfly(Memory::SafePtr<Cplex> data, std::size_t eighth,
+		std::size_t omegaIdx)
+	{
+		static const double c_sqrt1o2 = 0.70710678118654752; // sqrt(1/2)
+
+		// Split into the DFT of the sums, giving the even outputs, and the DFT of the differences
+		// times e^(-2piik/8), giving the odd outputs.
+		Cplex e[4], o[4];
+		for (std::size_t p = 0; p < 4; ++p) {
+			Cplex a = data[p * eighth];
+			Cplex b = data[(p + 4) * eighth];
+			e[p].r = a.r + b.r;
+			e[p].i = a.i + b.i;
+			o[p].r = a.r - b.r;
+			o[p].i = a.i - b.i;
+		}
+
+		Cplex t = o[1];
+		o[1].r = c_sqrt1o2 * (t.r + t.i);
+		o[1].i = c_sqrt1o2 * (t.i - t.r);
+		t = o[2];
+		o[2].r = t.i;
+		o[2].i = -t.r;
+		t = o[3];
+		o[3].r = c_sqrt1o2 * (t.i - t.r);
+		o[3].i = -c_sqrt1o2 * (t.r + t.i);
+
+		dft4(e, true);
+		dft4(o, true);
+
+		data[0] = e[0];
+		for (std::size_t p = 1; p < 8; ++p) {
+			Cplex w = m_twiddles[p * omegaIdx];
+			Cplex x = (p & 1) ? o[p >> 1] : e[p >> 1];
+
+			data[p * eighth].r = x.r * w.r - x.i * w.i;
+			data[p * eighth].i = x.r * w.i + x.i * w.r;
+		}
+	}
+
+	void rad2Rec::rad8RevButterfly(Memory::SafePtr<Cplex> data, std::size_t eighth,
+		std::size_t omegaIdx)
+	{
+		static const double c_sqrt1o2 = 0.70710678118654752; // sqrt(1/2)
+
+		Cplex e[4], o[4];
+		e[0] = data[0];
+		for (std::size_t p = 1; p < 8; ++p) {
+			Cplex w = m_twiddles[p * omegaIdx];
+			Cplex x = data[p * eighth];
+			Cplex &y = (p & 1) ? o[p >> 1] : e[p >> 1];
+
+			y.r = x.r * w.r + x.i * w.i; // conjugated root
+			y.i = x.i * w.r - x.r * w.i;
+		}
+
+		dft4(e, false);
+		dft4(o, false);
+
+		Cplex t = o[1];
+		o[1].r = c_sqrt1o2 * (t.r - t.i);
+		o[1].i = c_sqrt1o2 * (t.r + t.i);
+		t = o[2];
+		o[2].r = -t.i;
+		o[2].i = t.r;
+		t = o[3];
+		o[3].r = -c_sqrt1o2 * (t.r + t.i);
+		o[3].i = c_sqrt1o2 * (t.r - t.i);
+
+		for (std::size_t p = 0; p < 4; ++p) {
+			data[p * eighth].r = e[p].r + o[p].r;
+			data[p * eighth].i = e[p].i + o[p].i;
+			data[(p + 4) * eighth].r = e[p].r - o[p].r;
+			data[(p + 4) * eighth].i = e[p].i - o[p].i;
+		}
+	}
 }
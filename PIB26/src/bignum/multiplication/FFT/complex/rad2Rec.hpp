@@ -30,6 +30,7 @@
 #include "../../../../memory/SafePtr.hpp"
 
 #include "Cplex.hpp"
+#include "TwiddleTable.hpp"
 
 #include "rad4Rec.hpp"
 
@@ -37,22 +38,71 @@
 
 namespace SDF::Bignum::Multiplication::Fft::Complex {
 	// Class:      rad2Rec
-	// Purpose:    Wraps the radix-2 recursive complex FFT.
+	// Purpose:    Wraps the radix-2 recursive complex FFT. Odd powers of 2 are broken with one
+	//             radix-8 pass where they are long enough, and otherwise with a radix-2 pass, so
+	//             the rest can be done with the radix-4.
 	// Parameters: None.
 	class rad2Rec : public ComplexFft {
 		public:
-			rad2Rec(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize);
+			rad2Rec(const TwiddleTable &twiddles, Util::ThreadPool *threadPool);
 
 			std::size_t getMaxFftSize() const;
 			std::size_t getNearestSafeLengthTo(std::size_t length) const;
 
 			void doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len);
 			void doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len);
+
+			// Function:   doFwdTransforms/doRevTransforms
+			// Purpose:    Transform count consecutive blocks of length len. Short blocks are done
+			//             together, a pass at a time over all of them, so they make long enough
+			//             passes for the vector kernels.
+			// Parameters: data - The first block.
+			//             len - The length of each block.
+			//             count - The number of blocks.
+			// Returns:    None.
+			void doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+			void doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+
+			// Function:   setCrossovers
+			// Purpose:    Set where the transforms underneath switch methods (see FftPlanner).
+			// Parameters: iterativeLen - Powers of 4 shorter than this are done iteratively.
+			//             minRadix8Len - The shortest odd power of 2 broken with a radix-8 pass,
+			//                            or 0 for none.
+			// Returns:    None.
+			void setCrossovers(std::size_t iterativeLen, std::size_t minRadix8Len);
 		private:
-			Memory::SafePtr<Cplex> m_omegaTable;
+			const TwiddleTable &m_twiddles;
 			std::size_t m_omegaSize;
 
+			std::size_t m_minRadix8Len; // 0 for no radix-8 passes
+
 			rad4Rec m_rad4Fft;
+
+			// Function:   oddPowerRadix
+			// Purpose:    Get the radix to break an odd power of 2 with.
+			// Parameters: len - The odd power of 2.
+			// Returns:    2 or 8.
+			std::size_t oddPowerRadix(std::size_t len) const;
+
+			// Function:   fwdPass, revPass
+			// Purpose:    Do the radix-2 or radix-8 pass breaking an odd power of 2 down to an even
+			//             one, on one block.
+			// Parameters: data - The block.
+			//             len - The length of the block.
+			// Returns:    None.
+			void fwdPass(Memory::SafePtr<Cplex> data, std::size_t len);
+			void revPass(Memory::SafePtr<Cplex> data, std::size_t len);
+
+			// Function:   rad8FwdButterfly, rad8RevButterfly
+			// Purpose:    Do one scalar radix-8 butterfly.
+			// Parameters: data - The first of the eight elements.
+			//             eighth - The distance between the elements.
+			//             omegaIdx - The omega table index of the butterfly's twiddle.
+			// Returns:    None.
+			void rad8FwdButterfly(Memory::SafePtr<Cplex> data, std::size_t eighth,
+				std::size_t omegaIdx);
+			void rad8RevButterfly(Memory::SafePtr<Cplex> data, std::size_t eighth,
+				std::size_t omegaIdx);
 	};
 }
 
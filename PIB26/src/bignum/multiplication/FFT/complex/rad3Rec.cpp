@@ -31,8 +31,9 @@
 
 namespace SDF::Bignum::Multiplication::Fft::Complex
 {
-	rad3Rec::rad3Rec(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize)
-		: m_omegaTable(omegaTable), m_omegaSize(omegaSize), m_rad2Fft(omegaTable, omegaSize)
+	rad3Rec::rad3Rec(const TwiddleTable &twiddles, Util::ThreadPool *threadPool)
+		: ComplexFft(threadPool), m_twiddles(twiddles), m_omegaSize(twiddles.getSize()),
+		  m_rad2Fft(twiddles, threadPool)
 	{
 	}
 
@@ -80,20 +81,72 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 	}
 
 	void rad3Rec::doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		doFwdTransforms(data, len, 1);
+	}
+
+	void rad3Rec::doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		doRevTransforms(data, len, 1);
+	}
+
+	void rad3Rec::setCrossovers(std::size_t iterativeLen, std::size_t minRadix8Len)
+	{
+		m_rad2Fft.setCrossovers(iterativeLen, minRadix8Len);
+	}
+
+	void rad3Rec::doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
 	{
 		if (len % 3 != 0) {
 			// Switch to radix-2 transform.
-			m_rad2Fft.doFwdTransform(data, len);
+			m_rad2Fft.doFwdTransforms(data, len, count);
+		} else if ((count > 1) && (len * count > m_batchLimit)) {
+			runBatches(len, count, [&](std::size_t first, std::size_t num) {
+				doFwdTransforms(data + first * len, len, num);
+			});
 		} else {
-			std::size_t third(len / 3);
-			std::size_t full(len);
+			for (std::size_t b = 0; b < count; ++b) {
+				fwdPass(data + b * len, len);
+			}
+
+			doFwdTransforms(data, len / 3, count * 3);
+		}
+	}
 
+	void rad3Rec::doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
+	{
+		if (len % 3 != 0) {
+			// Switch to radix-2 transform.
+			m_rad2Fft.doRevTransforms(data, len, count);
+		} else if ((count > 1) && (len * count > m_batchLimit)) {
+			runBatches(len, count, [&](std::size_t first, std::size_t num) {
+				doRevTransforms(data + first * len, len, num);
+			});
+		} else {
+			doRevTransforms(data, len / 3, count * 3);
+
+			for (std::size_t b = 0; b < count; ++b) {
+				revPass(data + b * len, len);
+			}
+		}
+	}
+
+	void rad3Rec::fwdPass(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		std::size_t third(len / 3);
+		std::size_t full(len);
+
+		std::size_t step;
+		const Cplex *direct(m_twiddles.getDirect(full, step));
+		if (useKernels(third) && (direct != nullptr)) {
+			m_kernels->rad3Fwd(rawBlock(data, len), third, direct, step);
+		} else {
 			for (std::size_t n = 0; n < third; ++n) {
-				Cplex w = m_omegaTable[n * m_omegaSize / full];
+				Cplex w = m_twiddles[n * m_omegaSize / full];
 				Cplex w2 = w; // square of w
 
 				if(2 * n * m_omegaSize / full < m_omegaSize) {
-					w2 = m_omegaTable[2 * n * m_omegaSize / full];
+					w2 = m_twiddles[2 * n * m_omegaSize / full];
 				} else {
 					w2.r = w.r * w.r - w.i * w.i;
 					w2.i = 2.0 * w.r * w.i;
@@ -125,33 +178,26 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 				data[n + 2 * third].r = tmp3.r * w2.r - tmp3.i * w2.i;
 				data[n + 2 * third].i = tmp3.r * w2.i + tmp3.i * w2.r;
 			}
-
-			doFwdTransform(data, third);
-			doFwdTransform(data + third, third);
-			doFwdTransform(data + 2 * third, third);
 		}
 	}
 
-	void rad3Rec::doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	void rad3Rec::revPass(Memory::SafePtr<Cplex> data, std::size_t len)
 	{
-		if (len % 3 != 0) {
-			// Switch to radix-2 transform.
-			m_rad2Fft.doRevTransform(data, len);
-		} else {
-			std::size_t third(len / 3);
-			std::size_t full(len);
-
-			doRevTransform(data, third);
-			doRevTransform(data + third, third);
-			doRevTransform(data + 2 * third, third);
+		std::size_t third(len / 3);
+		std::size_t full(len);
 
+		std::size_t step;
+		const Cplex *direct(m_twiddles.getDirect(full, step));
+		if (useKernels(third) && (direct != nullptr)) {
+			m_kernels->rad3Rev(rawBlock(data, len), third, direct, step);
+		} else {
 			for (std::size_t n = 0; n < third; ++n) {
-				Cplex w = m_omegaTable[n * m_omegaSize / full];
+				Cplex w = m_twiddles[n * m_omegaSize / full];
 				w.i = -w.i; // invert the root
 				Cplex w2 = w; // square of w
 
 				if(2 * n * m_omegaSize / full < m_omegaSize) {
-					w2 = m_omegaTable[2 * n * m_omegaSize / full];
+					w2 = m_twiddles[2 * n * m_omegaSize / full];
 					w2.i = -w2.i;
 				} else {
 					w2.r = w.r * w.r - w.i * w.i;
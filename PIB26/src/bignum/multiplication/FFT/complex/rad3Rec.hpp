@@ -29,6 +29,7 @@
 #include "../../../../memory/SafePtr.hpp"
 
 #include "Cplex.hpp"
+#include "TwiddleTable.hpp"
 
 #include "rad2Rec.hpp"
 
@@ -40,18 +41,45 @@ namespace SDF::Bignum::Multiplication::Fft::Complex {
 	// Parameters: None.
 	class rad3Rec : public ComplexFft {
 		public:
-			rad3Rec(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize);
+			rad3Rec(const TwiddleTable &twiddles, Util::ThreadPool *threadPool);
 
 			std::size_t getMaxFftSize() const;
 			std::size_t getNearestSafeLengthTo(std::size_t length) const;
 
 			void doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len);
 			void doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len);
+
+			// Function:   doFwdTransforms/doRevTransforms
+			// Purpose:    Transform count consecutive blocks of length len. Short blocks are done
+			//             together, a pass at a time over all of them, so they make long enough
+			//             passes for the vector kernels.
+			// Parameters: data - The first block.
+			//             len - The length of each block.
+			//             count - The number of blocks.
+			// Returns:    None.
+			void doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+			void doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+
+			// Function:   setCrossovers
+			// Purpose:    Set where the transforms underneath switch methods (see FftPlanner).
+			// Parameters: iterativeLen - Powers of 4 shorter than this are done iteratively.
+			//             minRadix8Len - The shortest odd power of 2 broken with a radix-8 pass,
+			//                            or 0 for none.
+			// Returns:    None.
+			void setCrossovers(std::size_t iterativeLen, std::size_t minRadix8Len);
 		private:
-			Memory::SafePtr<Cplex> m_omegaTable;
+			const TwiddleTable &m_twiddles;
 			std::size_t m_omegaSize;
 
 			rad2Rec m_rad2Fft;
+
+			// Function:   fwdPass, revPass
+			// Purpose:    Do the radix-3 pass on one block.
+			// Parameters: data - The block.
+			//             len - The length of the block.
+			// Returns:    None.
+			void fwdPass(Memory::SafePtr<Cplex> data, std::size_t len);
+			void revPass(Memory::SafePtr<Cplex> data, std::size_t len);
 	};
 }
 
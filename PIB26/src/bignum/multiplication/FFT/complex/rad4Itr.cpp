@@ -25,15 +25,89 @@
 #include "rad4Itr.hpp"
 
 #include "../../../../exceptions/exceptions.hpp"
+#include "../../../../memory/buffers/local/RAMOnly.hpp"
+
+#include "vecButterflies.hpp"
 
 #include <cmath>
 #include <cstdio>
 
 namespace SDF::Bignum::Multiplication::Fft::Complex
 {
-	rad4Itr::rad4Itr(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize)
-		: m_omegaTable(omegaTable), m_omegaSize(omegaSize)
+	namespace
+	{
+		// A "vector" of one double, to build the scalar codelets from the same templates as the
+		// vector ones. They do the blocks left over by those, or all of them if there are none.
+		struct Scalar
+		{
+				typedef double Vec;
+				static const std::size_t WIDTH = 1;
+
+				static inline Vec add(Vec a, Vec b) { return a + b; }
+				static inline Vec sub(Vec a, Vec b) { return a - b; }
+				static inline Vec mul(Vec a, Vec b) { return a * b; }
+				static inline Vec fmadd(Vec a, Vec b, Vec c) { return a * b + c; }
+				static inline Vec fmsub(Vec a, Vec b, Vec c) { return a * b - c; }
+				static inline Vec fnmadd(Vec a, Vec b, Vec c) { return c - a * b; }
+				static inline Vec set1(double x) { return x; }
+
+				static inline void load(const double *p, Vec &re, Vec &im)
+				{
+					re = p[0];
+					im = p[1];
+				}
+
+				static inline void store(double *p, Vec re, Vec im)
+				{
+					p[0] = re;
+					p[1] = im;
+				}
+
+				static inline void loadStrided(const double *p, std::size_t, Vec &re, Vec &im)
+				{
+					load(p, re, im);
+				}
+
+				static inline void storeStrided(double *p, std::size_t, Vec re, Vec im)
+				{
+					store(p, re, im);
+				}
+
+				static inline void loadTwiddles(const double *omega, std::size_t n, std::size_t step,
+					Vec &re, Vec &im)
+				{
+					load(omega + 2 * n * step, re, im);
+				}
+		};
+	}
+
+	// The longest codelet; shorter transforms use the one of their own length.
+	static const std::size_t c_maxCodeletLen = 64;
+
+	rad4Itr::rad4Itr(const TwiddleTable &twiddles, std::size_t maxPackedLen)
+		: m_twiddles(twiddles), m_omegaSize(twiddles.getSize()), m_packedLen(1)
 	{
+		if (m_kernels != nullptr) {
+			while ((4 * m_packedLen <= maxPackedLen) && (m_omegaSize % (4 * m_packedLen) == 0)) {
+				m_packedLen <<= 2;
+			}
+
+			// The pass over blocks of size step = 4q needs w^p for p = 1, 2, 3 and n < q, i.e.
+			// 3q entries, placed after the 3(1 + 4 + ... + q/4) = q - 1 entries of the smaller
+			// passes, so all the passes together need m_packedLen - 1 entries.
+			m_packedBuffer = std::make_unique<Memory::Buffers::Local::RAMOnly<Cplex>>(m_packedLen);
+			m_packedTwiddles = m_packedBuffer->accessData(0);
+			for (std::size_t step = 4; step <= m_packedLen; step <<= 2) {
+				std::size_t quarter(step >> 2);
+				std::size_t omegaStep(m_omegaSize / step);
+				for (std::size_t p = 1; p < 4; ++p) {
+					for (std::size_t n = 0; n < quarter; ++n) {
+						m_packedTwiddles[quarter - 1 + (p - 1) * quarter + n] =
+							m_twiddles[p * n * omegaStep];
+					}
+				}
+			}
+		}
 	}
 
 	std::size_t rad4Itr::getMaxFftSize() const
@@ -66,97 +140,145 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 
 	void rad4Itr::doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len)
 	{
+		doFwdTransforms(data, len, 1);
+	}
+
+	void rad4Itr::doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		doRevTransforms(data, len, 1);
+	}
+
+	void rad4Itr::doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
+	{
+		// Every pass already works over chunks of the block, so a batch of blocks is just more
+		// chunks.
+		std::size_t total(len * count);
+		std::size_t leafLen((len < c_maxCodeletLen) ? len : c_maxCodeletLen);
 		std::size_t step(len);
 		std::size_t omegaStep(m_omegaSize / len); // for exploiting that even though the table stores
 																// e^(-2piin/Nmax) for some Nmax, we have
 																// e^(-2piin/(Nmax/d)) = e^(-2pii(dn)/Nmax).
 
-		while (step >= 4) {
-			// Perform the same pass as in the recursive case but over chunks of size step.
-			for (Memory::SafePtr<Cplex> chunk(data); chunk < data + len; chunk += step) {
+		while (step > leafLen) {
+			bool batch;
+			if (usePackedKernels(step, total, batch)) {
 				std::size_t quarter(step >> 2);
+				const Cplex *twiddles(rawBlock(m_packedTwiddles, m_packedLen - 1) + quarter - 1);
 
-				for (std::size_t n = 0; n < quarter; ++n) {
-					Cplex w = m_omegaTable[n * omegaStep];
-					Cplex w2 = m_omegaTable[2 * n * omegaStep];
-					Cplex w3 = m_omegaTable[3 * n * omegaStep];
+				if (batch) {
+					m_kernels->rad4FwdBatch(rawBlock(data, total), quarter, total / step, twiddles);
+				} else {
+					for (std::size_t offs = 0; offs < total; offs += step) {
+						m_kernels->rad4FwdPacked(rawBlock(data + offs, step), quarter, twiddles);
+					}
+				}
+			} else {
+				// Perform the same pass as in the recursive case but over chunks of size step.
+				for (Memory::SafePtr<Cplex> chunk(data); chunk < data + total; chunk += step) {
+					std::size_t quarter(step >> 2);
 
-					Cplex d0 = chunk[n];
-					Cplex d1 = chunk[n + quarter];
-					Cplex d2 = chunk[n + 2 * quarter];
-					Cplex d3 = chunk[n + 3 * quarter];
+					for (std::size_t n = 0; n < quarter; ++n) {
+						Cplex w = m_twiddles[n * omegaStep];
+						Cplex w2 = m_twiddles[2 * n * omegaStep];
+						Cplex w3 = m_twiddles[3 * n * omegaStep];
 
-					Cplex e0 = { d0.r + d2.r, d0.i + d2.i };
-					Cplex e1 = { d0.r - d2.r, d0.i - d2.i };
-					Cplex o0 = { d1.r + d3.r, d1.i + d3.i };
-					Cplex o1 = { d1.r - d3.r, d1.i - d3.i };
+						Cplex d0 = chunk[n];
+						Cplex d1 = chunk[n + quarter];
+						Cplex d2 = chunk[n + 2 * quarter];
+						Cplex d3 = chunk[n + 3 * quarter];
 
-					Cplex t0 = { e0.r + o0.r, e0.i + o0.i };
-					Cplex t1 = { e1.r + o1.i, e1.i - o1.r }; // e1 + (-i)*o1
-					Cplex t2 = { e0.r - o0.r, e0.i - o0.i };
-					Cplex t3 = { e1.r - o1.i, e1.i + o1.r }; // e1 - (-i)*o1
+						Cplex e0 = { d0.r + d2.r, d0.i + d2.i };
+						Cplex e1 = { d0.r - d2.r, d0.i - d2.i };
+						Cplex o0 = { d1.r + d3.r, d1.i + d3.i };
+						Cplex o1 = { d1.r - d3.r, d1.i - d3.i };
 
-					// Trig power multiplication
-					chunk[n].r = t0.r;
-					chunk[n].i = t0.i;
+						Cplex t0 = { e0.r + o0.r, e0.i + o0.i };
+						Cplex t1 = { e1.r + o1.i, e1.i - o1.r }; // e1 + (-i)*o1
+						Cplex t2 = { e0.r - o0.r, e0.i - o0.i };
+						Cplex t3 = { e1.r - o1.i, e1.i + o1.r }; // e1 - (-i)*o1
 
-					chunk[n + quarter].r = t1.r * w.r - t1.i * w.i;
-					chunk[n + quarter].i = t1.r * w.i + t1.i * w.r;
+						// Trig power multiplication
+						chunk[n].r = t0.r;
+						chunk[n].i = t0.i;
 
-					chunk[n + 2 * quarter].r = t2.r * w2.r - t2.i * w2.i;
-					chunk[n + 2 * quarter].i = t2.r * w2.i + t2.i * w2.r;
+						chunk[n + quarter].r = t1.r * w.r - t1.i * w.i;
+						chunk[n + quarter].i = t1.r * w.i + t1.i * w.r;
 
-					chunk[n + 3 * quarter].r = t3.r * w3.r - t3.i * w3.i;
-					chunk[n + 3 * quarter].i = t3.r * w3.i + t3.i * w3.r;
+						chunk[n + 2 * quarter].r = t2.r * w2.r - t2.i * w2.i;
+						chunk[n + 2 * quarter].i = t2.r * w2.i + t2.i * w2.r;
+
+						chunk[n + 3 * quarter].r = t3.r * w3.r - t3.i * w3.i;
+						chunk[n + 3 * quarter].i = t3.r * w3.i + t3.i * w3.r;
+					}
 				}
 			}
 
 			step >>= 2;
 			omegaStep <<= 2;
 		}
+
+		runCodelets(data, leafLen, total / leafLen, true);
 	}
 
-	void rad4Itr::doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	void rad4Itr::doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
 	{
-		std::size_t step(4);
-		std::size_t omegaStep(m_omegaSize / 4);
+		std::size_t total(len * count);
+		std::size_t leafLen((len < c_maxCodeletLen) ? len : c_maxCodeletLen);
+		runCodelets(data, leafLen, total / leafLen, false);
+
+		std::size_t step(4 * leafLen);
+		std::size_t omegaStep(m_omegaSize / step);
 
 		while (step <= len) {
-			// Perform the same pass as in the recursive case but over chunks of size step.
-			for (Memory::SafePtr<Cplex> chunk(data); chunk < data + len; chunk += step) {
+			bool batch;
+			if (usePackedKernels(step, total, batch)) {
 				std::size_t quarter(step >> 2);
+				const Cplex *twiddles(rawBlock(m_packedTwiddles, m_packedLen - 1) + quarter - 1);
 
-				for (std::size_t k = 0; k < quarter; ++k) {
-					Cplex w = m_omegaTable[k * omegaStep];
-					Cplex w2 = m_omegaTable[2 * k * omegaStep];
-					Cplex w3 = m_omegaTable[3 * k * omegaStep];
-
-					w.i = -w.i;
-					w2.i = -w2.i;
-					w3.i = -w3.i;
-
-					Cplex t0 = chunk[k];
-					Cplex t1 = { chunk[k + quarter].r * w.r - chunk[k + quarter].i * w.i, chunk[k
-						+ quarter].r * w.i + chunk[k + quarter].i * w.r };
-					Cplex t2 = { chunk[k + 2 * quarter].r * w2.r - chunk[k + 2 * quarter].i * w2.i,
-						chunk[k + 2 * quarter].r * w2.i + chunk[k + 2 * quarter].i * w2.r };
-					Cplex t3 = { chunk[k + 3 * quarter].r * w3.r - chunk[k + 3 * quarter].i * w3.i,
-						chunk[k + 3 * quarter].r * w3.i + chunk[k + 3 * quarter].i * w3.r };
-
-					Cplex e0 = { t0.r + t2.r, t0.i + t2.i };
-					Cplex e1 = { t0.r - t2.r, t0.i - t2.i };
-					Cplex o0 = { t1.r + t3.r, t1.i + t3.i };
-					Cplex o1 = { t1.r - t3.r, t1.i - t3.i };
-
-					Cplex d0 = { e0.r + o0.r, e0.i + o0.i };
-					Cplex d1 = { e1.r - o1.i, e1.i + o1.r }; // e1 + (+i)*o1
-					Cplex d2 = { e0.r - o0.r, e0.i - o0.i };
-					Cplex d3 = { e1.r + o1.i, e1.i - o1.r }; // e1 - (+i)*o1
-
-					chunk[k] = d0;
-					chunk[k + quarter] = d1;
-					chunk[k + 2 * quarter] = d2;
-					chunk[k + 3 * quarter] = d3;
+				if (batch) {
+					m_kernels->rad4RevBatch(rawBlock(data, total), quarter, total / step, twiddles);
+				} else {
+					for (std::size_t offs = 0; offs < total; offs += step) {
+						m_kernels->rad4RevPacked(rawBlock(data + offs, step), quarter, twiddles);
+					}
+				}
+			} else {
+				// Perform the same pass as in the recursive case but over chunks of size step.
+				for (Memory::SafePtr<Cplex> chunk(data); chunk < data + total; chunk += step) {
+					std::size_t quarter(step >> 2);
+
+					for (std::size_t k = 0; k < quarter; ++k) {
+						Cplex w = m_twiddles[k * omegaStep];
+						Cplex w2 = m_twiddles[2 * k * omegaStep];
+						Cplex w3 = m_twiddles[3 * k * omegaStep];
+
+						w.i = -w.i;
+						w2.i = -w2.i;
+						w3.i = -w3.i;
+
+						Cplex t0 = chunk[k];
+						Cplex t1 = { chunk[k + quarter].r * w.r - chunk[k + quarter].i * w.i, chunk[k
+							+ quarter].r * w.i + chunk[k + quarter].i * w.r };
+						Cplex t2 = { chunk[k + 2 * quarter].r * w2.r - chunk[k + 2 * quarter].i * w2.i,
+							chunk[k + 2 * quarter].r * w2.i + chunk[k + 2 * quarter].i * w2.r };
+						Cplex t3 = { chunk[k + 3 * quarter].r * w3.r - chunk[k + 3 * quarter].i * w3.i,
+							chunk[k + 3 * quarter].r * w3.i + chunk[k + 3 * quarter].i * w3.r };
+
+						Cplex e0 = { t0.r + t2.r, t0.i + t2.i };
+						Cplex e1 = { t0.r - t2.r, t0.i - t2.i };
+						Cplex o0 = { t1.r + t3.r, t1.i + t3.i };
+						Cplex o1 = { t1.r - t3.r, t1.i - t3.i };
+
+						Cplex d0 = { e0.r + o0.r, e0.i + o0.i };
+						Cplex d1 = { e1.r - o1.i, e1.i + o1.r }; // e1 + (+i)*o1
+						Cplex d2 = { e0.r - o0.r, e0.i - o0.i };
+						Cplex d3 = { e1.r + o1.i, e1.i - o1.r }; // e1 - (+i)*o1
+
+						chunk[k] = d0;
+						chunk[k + quarter] = d1;
+						chunk[k + 2 * quarter] = d2;
+						chunk[k + 3 * quarter] = d3;
+					}
 				}
 			}
 
@@ -164,5 +286,60 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 			omegaStep >>= 2;
 		}
 	}
-}
 
+	void rad4Itr::runCodelets(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count,
+		bool fwd)
+	{
+		ButterflyKernels::Codelet scalarCodelet(nullptr);
+		ButterflyKernels::Codelet vectorCodelet(nullptr);
+		switch (len) {
+			case 4:
+				scalarCodelet = fwd ? VecButterflies::codelet<Scalar, 4, true> :
+					VecButterflies::codelet<Scalar, 4, false>;
+				if (m_kernels != nullptr) {
+					vectorCodelet = fwd ? m_kernels->fft4Fwd : m_kernels->fft4Rev;
+				}
+				break;
+			case 16:
+				scalarCodelet = fwd ? VecButterflies::codelet<Scalar, 16, true> :
+					VecButterflies::codelet<Scalar, 16, false>;
+				if (m_kernels != nullptr) {
+					vectorCodelet = fwd ? m_kernels->fft16Fwd : m_kernels->fft16Rev;
+				}
+				break;
+			case 64:
+				scalarCodelet = fwd ? VecButterflies::codelet<Scalar, 64, true> :
+					VecButterflies::codelet<Scalar, 64, false>;
+				if (m_kernels != nullptr) {
+					vectorCodelet = fwd ? m_kernels->fft64Fwd : m_kernels->fft64Rev;
+				}
+				break;
+			default:
+				return; // length 1: nothing to do
+		}
+
+		std::size_t vectorBlocks(0);
+		if (vectorCodelet != nullptr) {
+			vectorBlocks = count - (count % m_kernels->width);
+			if (vectorBlocks != 0) {
+				vectorCodelet(rawBlock(data, vectorBlocks * len), vectorBlocks);
+			}
+		}
+
+		if (vectorBlocks < count) {
+			scalarCodelet(rawBlock(data + vectorBlocks * len, (count - vectorBlocks) * len),
+				count - vectorBlocks);
+		}
+	}
+
+	bool rad4Itr::usePackedKernels(std::size_t step, std::size_t len, bool &batch) const
+	{
+		if ((m_kernels == nullptr) || (step > m_packedLen)) {
+			return false;
+		} else {
+			// Small blocks do not fill a vector, so do several of them at once.
+			batch = ((step >> 2) < m_kernels->width);
+			return !batch || ((len / step) % m_kernels->width == 0);
+		}
+	}
+}
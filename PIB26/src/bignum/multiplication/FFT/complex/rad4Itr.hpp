@@ -27,29 +27,74 @@
 #include "ComplexFft.hpp"
 
 #include "../../../../memory/SafePtr.hpp"
+#include "../../../../memory/ILocalBuffer.hpp"
 
 #include "Cplex.hpp"
+#include "TwiddleTable.hpp"
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace SDF::Bignum::Multiplication::Fft::Complex {
 	// Class:      rad4Itr
-	// Purpose:    Wraps the radix-4 iterative complex FFT.
+	// Purpose:    Wraps the radix-4 iterative complex FFT. The passes over blocks of 64 or fewer
+	//             elements are left to the codelets (see ButterflyKernels).
 	// Parameters: None.
 	class rad4Itr : public ComplexFft {
 		public:
 			// NOTE: The FFT size passed to this MUST be a power of 4!
-			rad4Itr(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize);
+			// maxPackedLen is the largest transform length the packed twiddle tables used by the
+			// vector kernels are built for; longer transforms use the scalar loops for their outer
+			// passes.
+			rad4Itr(const TwiddleTable &twiddles, std::size_t maxPackedLen);
 
 			std::size_t getMaxFftSize() const;
 			std::size_t getNearestSafeLengthTo(std::size_t length) const;
 
 			void doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len);
 			void doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len);
+
+			// Function:   doFwdTransforms/doRevTransforms
+			// Purpose:    Transform count consecutive blocks of length len at once. Each pass goes
+			//             over all the blocks, so short blocks still make long enough passes for
+			//             the vector kernels.
+			// Parameters: data - The first block.
+			//             len - The length of each block.
+			//             count - The number of blocks.
+			// Returns:    None.
+			void doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+			void doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
 		private:
-			Memory::SafePtr<Cplex> m_omegaTable;
+			const TwiddleTable &m_twiddles;
 			std::size_t m_omegaSize;
+
+			// The twiddles for each pass, packed for the vector kernels. The pass over blocks of
+			// size 4 * q has its twiddles at offset q - 1, as ButterflyKernels::PackedPass wants
+			// them. Only built if there are kernels to use them.
+			std::unique_ptr<Memory::ILocalBuffer<Cplex>> m_packedBuffer;
+			Memory::SafePtr<Cplex> m_packedTwiddles;
+			std::size_t m_packedLen;
+
+			// Function:   runCodelets
+			// Purpose:    Transform blocks of one of the codelet lengths with the codelets: the
+			//             vector ones for as many blocks as they can take, the scalar ones for the
+			//             rest.
+			// Parameters: data - The first block.
+			//             len - The length of each block; 1, or a codelet length.
+			//             count - The number of blocks.
+			//             fwd - Whether to do the forward transform, rather than the inverse.
+			// Returns:    None.
+			void runCodelets(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count,
+				bool fwd);
+
+			// Function:   usePackedKernels
+			// Purpose:    Decide how to do a pass with the vector kernels.
+			// Parameters: step - The block size of the pass.
+			//             len - The length of all the data the pass goes over.
+			//             batch - Receives whether to use the batch kernel.
+			// Returns:    Whether the vector kernels can be used.
+			bool usePackedKernels(std::size_t step, std::size_t len, bool &batch) const;
 	};
 }
 
@@ -32,12 +32,12 @@
 
 namespace SDF::Bignum::Multiplication::Fft::Complex
 {
-	rad4Rec::rad4Rec(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize)
-		: m_omegaTable(omegaTable), m_omegaSize(omegaSize), m_iterativeFftThreshold(
-			g_cacheSize / (2 * sizeof(Cplex))), // try to fit whole iterative
+	rad4Rec::rad4Rec(const TwiddleTable &twiddles, Util::ThreadPool *threadPool)
+		: ComplexFft(threadPool), m_twiddles(twiddles), m_omegaSize(twiddles.getSize()), m_iterativeFftThreshold(
+			getIterativeCacheSize() / (2 * sizeof(Cplex))), // try to fit whole iterative
 															// FFT - table and data - into
 															// cache
-		m_iterativeFft(omegaTable, omegaSize)
+		m_iterativeFft(twiddles, m_iterativeFftThreshold)
 	{
 	}
 
@@ -77,53 +77,58 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 			std::size_t quarter(len >> 2);
 			std::size_t full(len);
 
-			for (std::size_t n = 0; n < quarter; ++n) {
-				Cplex w = m_omegaTable[n * m_omegaSize / full];
-				Cplex w2 = m_omegaTable[2 * n * m_omegaSize / full];
-				Cplex w3 = m_omegaTable[3 * n * m_omegaSize / full];
-
-				Cplex d0 = data[n];
-				Cplex d1 = data[n + quarter];
-				Cplex d2 = data[n + 2 * quarter];
-				Cplex d3 = data[n + 3 * quarter];
-
-				// NB: we almost surely can do this in fewer operations
-				//Cplex t0 = { d0.r + d1.r + d2.r + d3.r, d0.i + d1.i + d2.i + d3.i };
-				//Cplex t1 = { d0.r + d1.i - d2.r - d3.i, d0.i - d1.r - d2.i + d3.r };
-				//Cplex t2 = { d0.r - d1.r + d2.r - d3.r, d0.i - d1.i + d2.i - d3.i };
-				//Cplex t3 = { d0.r - d1.i - d2.r + d3.i, d0.i + d1.r - d2.i - d3.r };
-
-				// Optimized method: one should note that the "butterfly" is actually a small DFT
-				//                   within the larger FFT, and thus we can use the FFT decomposition on
-				//                   it as well.
-				Cplex e0 = { d0.r + d2.r, d0.i + d2.i }; // two length-2 DFTs
-				Cplex e1 = { d0.r - d2.r, d0.i - d2.i };
-				Cplex o0 = { d1.r + d3.r, d1.i + d3.i };
-				Cplex o1 = { d1.r - d3.r, d1.i - d3.i };
-
-				Cplex t0 = { e0.r + o0.r, e0.i + o0.i };
-				Cplex t1 = { e1.r + o1.i, e1.i - o1.r }; // e1 + (-i)*o1
-				Cplex t2 = { e0.r - o0.r, e0.i - o0.i };
-				Cplex t3 = { e1.r - o1.i, e1.i + o1.r }; // e1 - (-i)*o1
-
-				// Trig power multiplication
-				data[n].r = t0.r;
-				data[n].i = t0.i;
-
-				data[n + quarter].r = t1.r * w.r - t1.i * w.i;
-				data[n + quarter].i = t1.r * w.i + t1.i * w.r;
-
-				data[n + 2 * quarter].r = t2.r * w2.r - t2.i * w2.i;
-				data[n + 2 * quarter].i = t2.r * w2.i + t2.i * w2.r;
-
-				data[n + 3 * quarter].r = t3.r * w3.r - t3.i * w3.i;
-				data[n + 3 * quarter].i = t3.r * w3.i + t3.i * w3.r;
+			std::size_t step;
+			const Cplex *direct(m_twiddles.getDirect(full, step));
+			if (useKernels(quarter) && (direct != nullptr)) {
+				m_kernels->rad4Fwd(rawBlock(data, len), quarter, direct, step);
+			} else {
+				for (std::size_t n = 0; n < quarter; ++n) {
+					Cplex w = m_twiddles[n * m_omegaSize / full];
+					Cplex w2 = m_twiddles[2 * n * m_omegaSize / full];
+					Cplex w3 = m_twiddles[3 * n * m_omegaSize / full];
+
+					Cplex d0 = data[n];
+					Cplex d1 = data[n + quarter];
+					Cplex d2 = data[n + 2 * quarter];
+					Cplex d3 = data[n + 3 * quarter];
+
+					// NB: we almost surely can do this in fewer operations
+					//Cplex t0 = { d0.r + d1.r + d2.r + d3.r, d0.i + d1.i + d2.i + d3.i };
+					//Cplex t1 = { d0.r + d1.i - d2.r - d3.i, d0.i - d1.r - d2.i + d3.r };
+					//Cplex t2 = { d0.r - d1.r + d2.r - d3.r, d0.i - d1.i + d2.i - d3.i };
+					//Cplex t3 = { d0.r - d1.i - d2.r + d3.i, d0.i + d1.r - d2.i - d3.r };
+
+					// Optimized method: one should note that the "butterfly" is actually a small DFT
+					//                   within the larger FFT, and thus we can use the FFT decomposition on
+					//                   it as well.
+					Cplex e0 = { d0.r + d2.r, d0.i + d2.i }; // two length-2 DFTs
+					Cplex e1 = { d0.r - d2.r, d0.i - d2.i };
+					Cplex o0 = { d1.r + d3.r, d1.i + d3.i };
+					Cplex o1 = { d1.r - d3.r, d1.i - d3.i };
+
+					Cplex t0 = { e0.r + o0.r, e0.i + o0.i };
+					Cplex t1 = { e1.r + o1.i, e1.i - o1.r }; // e1 + (-i)*o1
+					Cplex t2 = { e0.r - o0.r, e0.i - o0.i };
+					Cplex t3 = { e1.r - o1.i, e1.i + o1.r }; // e1 - (-i)*o1
+
+					// Trig power multiplication
+					data[n].r = t0.r;
+					data[n].i = t0.i;
+
+					data[n + quarter].r = t1.r * w.r - t1.i * w.i;
+					data[n + quarter].i = t1.r * w.i + t1.i * w.r;
+
+					data[n + 2 * quarter].r = t2.r * w2.r - t2.i * w2.i;
+					data[n + 2 * quarter].i = t2.r * w2.i + t2.i * w2.r;
+
+					data[n + 3 * quarter].r = t3.r * w3.r - t3.i * w3.i;
+					data[n + 3 * quarter].i = t3.r * w3.i + t3.i * w3.r;
+				}
 			}
 
-			doFwdTransform(data, quarter);
-			doFwdTransform(data + quarter, quarter);
-			doFwdTransform(data + 2*quarter, quarter);
-			doFwdTransform(data + 3*quarter, quarter);
+			runSubTransforms(4, quarter, [&](std::size_t k) {
+				doFwdTransform(data + k * quarter, quarter);
+			});
 		}
 	}
 
@@ -135,49 +140,84 @@ namespace SDF::Bignum::Multiplication::Fft::Complex
 			std::size_t quarter(len >> 2);
 			std::size_t full(len);
 
-			doRevTransform(data, quarter);
-			doRevTransform(data + quarter, quarter);
-			doRevTransform(data + 2*quarter, quarter);
-			doRevTransform(data + 3*quarter, quarter);
-
-			for (std::size_t k = 0; k < quarter; ++k) {
-				Cplex w = m_omegaTable[k * m_omegaSize / full];
-				Cplex w2 = m_omegaTable[2 * k * m_omegaSize / full];
-				Cplex w3 = m_omegaTable[3 * k * m_omegaSize / full];
-
-				w.i = -w.i;
-				w2.i = -w2.i;
-				w3.i = -w3.i;
-
-				Cplex t0 = data[k];
-				Cplex t1 = { data[k + quarter].r * w.r - data[k + quarter].i * w.i, data[k
-					+ quarter].r * w.i + data[k + quarter].i * w.r };
-				Cplex t2 = { data[k + 2 * quarter].r * w2.r - data[k + 2 * quarter].i * w2.i,
-					data[k + 2 * quarter].r * w2.i + data[k + 2 * quarter].i * w2.r };
-				Cplex t3 = { data[k + 3 * quarter].r * w3.r - data[k + 3 * quarter].i * w3.i,
-					data[k + 3 * quarter].r * w3.i + data[k + 3 * quarter].i * w3.r };
-
-				//Cplex d0 = { t0.r + t1.r + t2.r + t3.r, t0.i + t1.i + t2.i + t3.i };
-				//Cplex d1 = { t0.r - t1.i - t2.r + t3.i, t0.i + t1.r - t2.i - t3.r };
-				//Cplex d2 = { t0.r - t1.r + t2.r - t3.r, t0.i - t1.i + t2.i - t3.i };
-				//Cplex d3 = { t0.r + t1.i - t2.r - t3.i, t0.i - t1.r - t2.i + t3.r };
-
-				Cplex e0 = { t0.r + t2.r, t0.i + t2.i };
-				Cplex e1 = { t0.r - t2.r, t0.i - t2.i };
-				Cplex o0 = { t1.r + t3.r, t1.i + t3.i };
-				Cplex o1 = { t1.r - t3.r, t1.i - t3.i };
-
-				Cplex d0 = { e0.r + o0.r, e0.i + o0.i };
-				Cplex d1 = { e1.r - o1.i, e1.i + o1.r }; // e1 + (+i)*o1
-				Cplex d2 = { e0.r - o0.r, e0.i - o0.i };
-				Cplex d3 = { e1.r + o1.i, e1.i - o1.r }; // e1 - (+i)*o1
-
-				data[k] = d0;
-				data[k + quarter] = d1;
-				data[k + 2 * quarter] = d2;
-				data[k + 3 * quarter] = d3;
+			runSubTransforms(4, quarter, [&](std::size_t k) {
+				doRevTransform(data + k * quarter, quarter);
+			});
+
+			std::size_t step;
+			const Cplex *direct(m_twiddles.getDirect(full, step));
+			if (useKernels(quarter) && (direct != nullptr)) {
+				m_kernels->rad4Rev(rawBlock(data, len), quarter, direct, step);
+			} else {
+				for (std::size_t k = 0; k < quarter; ++k) {
+					Cplex w = m_twiddles[k * m_omegaSize / full];
+					Cplex w2 = m_twiddles[2 * k * m_omegaSize / full];
+					Cplex w3 = m_twiddles[3 * k * m_omegaSize / full];
+
+					w.i = -w.i;
+					w2.i = -w2.i;
+					w3.i = -w3.i;
+
+					Cplex t0 = data[k];
+					Cplex t1 = { data[k + quarter].r * w.r - data[k + quarter].i * w.i, data[k
+						+ quarter].r * w.i + data[k + quarter].i * w.r };
+					Cplex t2 = { data[k + 2 * quarter].r * w2.r - data[k + 2 * quarter].i * w2.i,
+						data[k + 2 * quarter].r * w2.i + data[k + 2 * quarter].i * w2.r };
+					Cplex t3 = { data[k + 3 * quarter].r * w3.r - data[k + 3 * quarter].i * w3.i,
+						data[k + 3 * quarter].r * w3.i + data[k + 3 * quarter].i * w3.r };
+
+					//Cplex d0 = { t0.r + t1.r + t2.r + t3.r, t0.i + t1.i + t2.i + t3.i };
+					//Cplex d1 = { t0.r - t1.i - t2.r + t3.i, t0.i + t1.r - t2.i - t3.r };
+					//Cplex d2 = { t0.r - t1.r + t2.r - t3.r, t0.i - t1.i + t2.i - t3.i };
+					//Cplex d3 = { t0.r + t1.i - t2.r - t3.i, t0.i - t1.r - t2.i + t3.r };
+
+					Cplex e0 = { t0.r + t2.r, t0.i + t2.i };
+					Cplex e1 = { t0.r - t2.r, t0.i - t2.i };
+					Cplex o0 = { t1.r + t3.r, t1.i + t3.i };
+					Cplex o1 = { t1.r - t3.r, t1.i - t3.i };
+
+					Cplex d0 = { e0.r + o0.r, e0.i + o0.i };
+					Cplex d1 = { e1.r - o1.i, e1.i + o1.r }; // e1 + (+i)*o1
+					Cplex d2 = { e0.r - o0.r, e0.i - o0.i };
+					Cplex d3 = { e1.r + o1.i, e1.i - o1.r }; // e1 - (+i)*o1
+
+					data[k] = d0;
+					data[k + quarter] = d1;
+					data[k + 2 * quarter] = d2;
+					data[k + 3 * quarter] = d3;
+				}
 			}
 		}
 	}
-}
 
+	void rad4Rec::setIterativeLen(std::size_t len)
+	{
+		m_iterativeFftThreshold = len;
+	}
+
+	void rad4Rec::doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
+	{
+		if (len < m_iterativeFftThreshold) {
+			runBatches(len, count, [&](std::size_t first, std::size_t num) {
+				m_iterativeFft.doFwdTransforms(data + first * len, len, num);
+			});
+		} else {
+			runSubTransforms(count, len, [&](std::size_t k) {
+				doFwdTransform(data + k * len, len);
+			});
+		}
+	}
+
+	void rad4Rec::doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
+	{
+		if (len < m_iterativeFftThreshold) {
+			runBatches(len, count, [&](std::size_t first, std::size_t num) {
+				m_iterativeFft.doRevTransforms(data + first * len, len, num);
+			});
+		} else {
+			runSubTransforms(count, len, [&](std::size_t k) {
+				doRevTransform(data + k * len, len);
+			});
+		}
+	}
+}
@@ -29,6 +29,7 @@
 #include "../../../../memory/SafePtr.hpp"
 
 #include "Cplex.hpp"
+#include "TwiddleTable.hpp"
 
 #include "rad4Itr.hpp"
 
@@ -40,15 +41,32 @@ namespace SDF::Bignum::Multiplication::Fft::Complex {
 	// Parameters: None.
 	class rad4Rec : public ComplexFft {
 		public:
-			rad4Rec(Memory::SafePtr<Cplex> omegaTable, std::size_t omegaSize);
+			rad4Rec(const TwiddleTable &twiddles, Util::ThreadPool *threadPool);
 
 			std::size_t getMaxFftSize() const;
 			std::size_t getNearestSafeLengthTo(std::size_t length) const;
 
 			void doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len);
 			void doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len);
+
+			// Function:   doFwdTransforms/doRevTransforms
+			// Purpose:    Transform count consecutive blocks of length len. Short blocks are done
+			//             together, a pass at a time over all of them, so they make long enough
+			//             passes for the vector kernels.
+			// Parameters: data - The first block.
+			//             len - The length of each block.
+			//             count - The number of blocks.
+			// Returns:    None.
+			void doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+			void doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+
+			// Function:   setIterativeLen
+			// Purpose:    Set the length below which transforms are done iteratively.
+			// Parameters: len - The length; no more than getIterativeCacheSize() allows for.
+			// Returns:    None.
+			void setIterativeLen(std::size_t len);
 		private:
-			Memory::SafePtr<Cplex> m_omegaTable;
+			const TwiddleTable &m_twiddles;
 			std::size_t m_omegaSize;
 
 			std::size_t m_iterativeFftThreshold;
@@ -0,0 +1,247 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      rad5Rec.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "rad5Rec.hpp"
+
+#include "../../../../exceptions/exceptions.hpp"
+
+namespace SDF::Bignum::Multiplication::Fft::Complex
+{
+	const std::size_t rad5Rec::ODD_FACTORS[NUM_ODD_FACTORS] = { 1, 3, 5, 15 };
+
+	// cos(2pi/5), cos(4pi/5), sin(2pi/5), sin(4pi/5)
+	static const double c_cos1 = 0.30901699437494742;
+	static const double c_cos2 = -0.80901699437494742;
+	static const double c_sin1 = 0.95105651629515357;
+	static const double c_sin2 = 0.58778525229247313;
+
+	rad5Rec::rad5Rec(const TwiddleTable &twiddles, Util::ThreadPool *threadPool)
+		: ComplexFft(threadPool), m_twiddles(twiddles), m_omegaSize(twiddles.getSize()),
+		  m_rad3Fft(twiddles, threadPool)
+	{
+	}
+
+	std::size_t rad5Rec::getMaxFftSize() const
+	{
+		// The largest number of the form f * 2^n, f one of the odd factors, dividing the size of
+		// the omega table.
+		std::size_t maxPow2(1);
+		std::size_t omegaSize(m_omegaSize);
+		while(!(omegaSize & 1)) {
+			omegaSize >>= 1;
+			maxPow2 <<= 1;
+		}
+
+		std::size_t maxSize(maxPow2);
+		for(std::size_t i = 0; i < NUM_ODD_FACTORS; ++i) {
+			std::size_t candidate(ODD_FACTORS[i] * maxPow2);
+			if((m_omegaSize % candidate == 0) && (candidate > maxSize)) {
+				maxSize = candidate;
+			}
+		}
+
+		return maxSize;
+	}
+
+	std::size_t rad5Rec::getNearestSafeLengthTo(std::size_t length) const
+	{
+		std::size_t safeLength(getNearestSafeLength(length, m_omegaSize));
+		if(safeLength == 0) {
+			throw Exceptions::Exception("ERROR: Required FFT size is too large!");
+		} else {
+			return safeLength;
+		}
+	}
+
+	std::size_t rad5Rec::getNearestSafeLength(std::size_t length, std::size_t omegaSize)
+	{
+		// Get the smallest number of the form f * 2^n no smaller than length that divides the
+		// size of the omega table.
+		std::size_t bestLength(0);
+		for(std::size_t i = 0; i < NUM_ODD_FACTORS; ++i) {
+			std::size_t candidate(ODD_FACTORS[i]);
+			while(candidate < length) {
+				candidate <<= 1;
+			}
+
+			if((omegaSize % candidate == 0) && ((bestLength == 0) || (candidate < bestLength))) {
+				bestLength = candidate;
+			}
+		}
+
+		return bestLength;
+	}
+
+	void rad5Rec::doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		doFwdTransforms(data, len, 1);
+	}
+
+	void rad5Rec::doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		doRevTransforms(data, len, 1);
+	}
+
+	void rad5Rec::setCrossovers(std::size_t iterativeLen, std::size_t minRadix8Len)
+	{
+		m_rad3Fft.setCrossovers(iterativeLen, minRadix8Len);
+	}
+
+	void rad5Rec::doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
+	{
+		if (len % 5 != 0) {
+			// Switch to radix-3 transform.
+			m_rad3Fft.doFwdTransforms(data, len, count);
+		} else if ((count > 1) && (len * count > m_batchLimit)) {
+			runBatches(len, count, [&](std::size_t first, std::size_t num) {
+				doFwdTransforms(data + first * len, len, num);
+			});
+		} else {
+			for (std::size_t b = 0; b < count; ++b) {
+				fwdPass(data + b * len, len);
+			}
+
+			doFwdTransforms(data, len / 5, count * 5);
+		}
+	}
+
+	void rad5Rec::doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count)
+	{
+		if (len % 5 != 0) {
+			// Switch to radix-3 transform.
+			m_rad3Fft.doRevTransforms(data, len, count);
+		} else if ((count > 1) && (len * count > m_batchLimit)) {
+			runBatches(len, count, [&](std::size_t first, std::size_t num) {
+				doRevTransforms(data + first * len, len, num);
+			});
+		} else {
+			doRevTransforms(data, len / 5, count * 5);
+
+			for (std::size_t b = 0; b < count; ++b) {
+				revPass(data + b * len, len);
+			}
+		}
+	}
+
+	void rad5Rec::fwdPass(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		std::size_t fifth(len / 5);
+		std::size_t full(len);
+
+		std::size_t step;
+		const Cplex *direct(m_twiddles.getDirect(full, step));
+		if (useKernels(fifth) && (direct != nullptr)) {
+			m_kernels->rad5Fwd(rawBlock(data, len), fifth, direct, step);
+		} else {
+			for (std::size_t n = 0; n < fifth; ++n) {
+				// Pair the inputs symmetrically about x_0; the outputs then come in pairs
+				// m -/+ i*u, each needing only real multiplications.
+				Cplex x0 = data[n];
+				Cplex a1 = { data[n + fifth].r + data[n + 4 * fifth].r,
+					data[n + fifth].i + data[n + 4 * fifth].i };
+				Cplex b1 = { data[n + fifth].r - data[n + 4 * fifth].r,
+					data[n + fifth].i - data[n + 4 * fifth].i };
+				Cplex a2 = { data[n + 2 * fifth].r + data[n + 3 * fifth].r,
+					data[n + 2 * fifth].i + data[n + 3 * fifth].i };
+				Cplex b2 = { data[n + 2 * fifth].r - data[n + 3 * fifth].r,
+					data[n + 2 * fifth].i - data[n + 3 * fifth].i };
+
+				Cplex m1 = { x0.r + c_cos1 * a1.r + c_cos2 * a2.r,
+					x0.i + c_cos1 * a1.i + c_cos2 * a2.i };
+				Cplex m2 = { x0.r + c_cos2 * a1.r + c_cos1 * a2.r,
+					x0.i + c_cos2 * a1.i + c_cos1 * a2.i };
+				Cplex u = { c_sin1 * b1.r + c_sin2 * b2.r, c_sin1 * b1.i + c_sin2 * b2.i };
+				Cplex v = { c_sin2 * b1.r - c_sin1 * b2.r, c_sin2 * b1.i - c_sin1 * b2.i };
+
+				Cplex tmp[5];
+				tmp[1].r = m1.r + u.i;
+				tmp[1].i = m1.i - u.r;
+				tmp[4].r = m1.r - u.i;
+				tmp[4].i = m1.i + u.r;
+				tmp[2].r = m2.r + v.i;
+				tmp[2].i = m2.i - v.r;
+				tmp[3].r = m2.r - v.i;
+				tmp[3].i = m2.i + v.r;
+
+				data[n].r = x0.r + a1.r + a2.r;
+				data[n].i = x0.i + a1.i + a2.i;
+
+				for (std::size_t p = 1; p < 5; ++p) {
+					Cplex w = m_twiddles[p * n * m_omegaSize / full];
+
+					data[n + p * fifth].r = tmp[p].r * w.r - tmp[p].i * w.i;
+					data[n + p * fifth].i = tmp[p].r * w.i + tmp[p].i * w.r;
+				}
+			}
+		}
+	}
+
+	void rad5Rec::revPass(Memory::SafePtr<Cplex> data, std::size_t len)
+	{
+		std::size_t fifth(len / 5);
+		std::size_t full(len);
+
+		std::size_t step;
+		const Cplex *direct(m_twiddles.getDirect(full, step));
+		if (useKernels(fifth) && (direct != nullptr)) {
+			m_kernels->rad5Rev(rawBlock(data, len), fifth, direct, step);
+		} else {
+			for (std::size_t n = 0; n < fifth; ++n) {
+				Cplex tmp[5];
+				tmp[0] = data[n];
+				for (std::size_t p = 1; p < 5; ++p) {
+					Cplex w = m_twiddles[p * n * m_omegaSize / full];
+					w.i = -w.i; // invert the root
+
+					tmp[p].r = data[n + p * fifth].r * w.r - data[n + p * fifth].i * w.i;
+					tmp[p].i = data[n + p * fifth].r * w.i + data[n + p * fifth].i * w.r;
+				}
+
+				Cplex a1 = { tmp[1].r + tmp[4].r, tmp[1].i + tmp[4].i };
+				Cplex b1 = { tmp[1].r - tmp[4].r, tmp[1].i - tmp[4].i };
+				Cplex a2 = { tmp[2].r + tmp[3].r, tmp[2].i + tmp[3].i };
+				Cplex b2 = { tmp[2].r - tmp[3].r, tmp[2].i - tmp[3].i };
+
+				Cplex m1 = { tmp[0].r + c_cos1 * a1.r + c_cos2 * a2.r,
+					tmp[0].i + c_cos1 * a1.i + c_cos2 * a2.i };
+				Cplex m2 = { tmp[0].r + c_cos2 * a1.r + c_cos1 * a2.r,
+					tmp[0].i + c_cos2 * a1.i + c_cos1 * a2.i };
+				Cplex u = { c_sin1 * b1.r + c_sin2 * b2.r, c_sin1 * b1.i + c_sin2 * b2.i };
+				Cplex v = { c_sin2 * b1.r - c_sin1 * b2.r, c_sin2 * b1.i - c_sin1 * b2.i };
+
+				// n.b. the signs of the rotations flip due to the conjugated trig
+				data[n].r = tmp[0].r + a1.r + a2.r;
+				data[n].i = tmp[0].i + a1.i + a2.i;
+				data[n + fifth].r = m1.r - u.i;
+				data[n + fifth].i = m1.i + u.r;
+				data[n + 4 * fifth].r = m1.r + u.i;
+				data[n + 4 * fifth].i = m1.i - u.r;
+				data[n + 2 * fifth].r = m2.r - v.i;
+				data[n + 2 * fifth].i = m2.i + v.r;
+				data[n + 3 * fifth].r = m2.r + v.i;
+				data[n + 3 * fifth].i = m2.i - v.r;
+			}
+		}
+	}
+}
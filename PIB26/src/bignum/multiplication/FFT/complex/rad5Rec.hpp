@@ -0,0 +1,101 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      rad5Rec.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_RAD5REC_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_RAD5REC_HPP_
+
+#include "ComplexFft.hpp"
+
+#include "../../../../memory/SafePtr.hpp"
+
+#include "Cplex.hpp"
+#include "TwiddleTable.hpp"
+
+#include "rad3Rec.hpp"
+
+#include <cstddef>
+
+namespace SDF::Bignum::Multiplication::Fft::Complex {
+	// Class:      rad5Rec
+	// Purpose:    Wraps the radix-5 recursive complex FFT. Together with the radix-3 and radix-2
+	//             ones underneath, this takes lengths of the forms 2^n, 3 * 2^n, 5 * 2^n and
+	//             15 * 2^n, which pack the product much more tightly than the powers of 2 alone.
+	// Parameters: None.
+	class rad5Rec : public ComplexFft {
+		public:
+			rad5Rec(const TwiddleTable &twiddles, Util::ThreadPool *threadPool);
+
+			std::size_t getMaxFftSize() const;
+			std::size_t getNearestSafeLengthTo(std::size_t length) const;
+
+			// Function:   getNearestSafeLength
+			// Purpose:    Get the length getNearestSafeLengthTo would give with a given omega table
+			//             size, for choosing the table size.
+			// Parameters: length - The generic length to test.
+			//             omegaSize - The size of the omega table.
+			// Returns:    The smallest safe length no smaller than length, or 0 if there is none.
+			static std::size_t getNearestSafeLength(std::size_t length, std::size_t omegaSize);
+
+			void doFwdTransform(Memory::SafePtr<Cplex> data, std::size_t len);
+			void doRevTransform(Memory::SafePtr<Cplex> data, std::size_t len);
+
+			// Function:   doFwdTransforms/doRevTransforms
+			// Purpose:    Transform count consecutive blocks of length len. Short blocks are done
+			//             together, a pass at a time over all of them, so they make long enough
+			//             passes for the vector kernels.
+			// Parameters: data - The first block.
+			//             len - The length of each block.
+			//             count - The number of blocks.
+			// Returns:    None.
+			void doFwdTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+			void doRevTransforms(Memory::SafePtr<Cplex> data, std::size_t len, std::size_t count);
+
+			// Function:   setCrossovers
+			// Purpose:    Set where the transforms underneath switch methods (see FftPlanner).
+			// Parameters: iterativeLen - Powers of 4 shorter than this are done iteratively.
+			//             minRadix8Len - The shortest odd power of 2 broken with a radix-8 pass,
+			//                            or 0 for none.
+			// Returns:    None.
+			void setCrossovers(std::size_t iterativeLen, std::size_t minRadix8Len);
+		private:
+			// The odd factors a transform length may have.
+			static const std::size_t NUM_ODD_FACTORS = 4;
+			static const std::size_t ODD_FACTORS[NUM_ODD_FACTORS];
+
+			const TwiddleTable &m_twiddles;
+			std::size_t m_omegaSize;
+
+			rad3Rec m_rad3Fft;
+
+			// Function:   fwdPass, revPass
+			// Purpose:    Do the radix-5 pass on one block.
+			// Parameters: data - The block.
+			//             len - The length of the block.
+			// Returns:    None.
+			void fwdPass(Memory::SafePtr<Cplex> data, std::size_t len);
+			void revPass(Memory::SafePtr<Cplex> data, std::size_t len);
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_RAD5REC_HPP_ */
@@ -0,0 +1,744 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      vecButterflies.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_VECBUTTERFLIES_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_VECBUTTERFLIES_HPP_
+
+#include "Cplex.hpp"
+#include "butterflies.hpp"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// The butterfly passes in ButterflyKernels, written once over a vector "traits" type V which
+// supplies the vector type and the operations on it. This header is included from the translation
+// units that are compiled for a specific instruction set, and from rad4Itr for the scalar versions
+// of the codelets; V must be local to the including translation unit so the instantiations never
+// collide between instruction sets. For the same reason, nothing in here may construct a Cplex:
+// we only work with its doubles.
+//
+// V must provide:
+//    Vec                    - the vector type, holding WIDTH doubles
+//    WIDTH                  - the number of doubles in Vec
+//    add, sub, mul          - elementwise arithmetic
+//    fmadd(a, b, c)         - a * b + c
+//    fmsub(a, b, c)         - a * b - c
+//    fnmadd(a, b, c)        - c - a * b
+//    set1(x)                - x in every element
+//    load(p, re, im)        - load WIDTH complex numbers at p, split into real and imaginary parts
+//    store(p, re, im)       - the reverse of load
+//    loadStrided(p, stride, re, im), storeStrided(p, stride, re, im)
+//                           - as load and store, but for the complex numbers p[j * stride],
+//                             j = 0 ... WIDTH - 1
+//    loadTwiddles(omega, n, step, re, im)
+//                           - load the complex numbers omega[(n + j) * step], j = 0 ... WIDTH - 1,
+//                             in the same element order load uses.
+namespace SDF::Bignum::Multiplication::Fft::Complex::VecButterflies
+{
+	template<class V>
+	inline void cmul(typename V::Vec xr, typename V::Vec xi, typename V::Vec wr,
+		typename V::Vec wi, typename V::Vec &outR, typename V::Vec &outI)
+	{
+		outR = V::fmsub(xr, wr, V::mul(xi, wi));
+		outI = V::fmadd(xr, wi, V::mul(xi, wr));
+	}
+
+	// Multiply x by the conjugate of w.
+	template<class V>
+	inline void cmulConj(typename V::Vec xr, typename V::Vec xi, typename V::Vec wr,
+		typename V::Vec wi, typename V::Vec &outR, typename V::Vec &outI)
+	{
+		outR = V::fmadd(xr, wr, V::mul(xi, wi));
+		outI = V::fmsub(xi, wr, V::mul(xr, wi));
+	}
+
+	template<class V>
+	void rad2Fwd(Cplex *data, std::size_t half, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *a(reinterpret_cast<double*>(data));
+		double *b(a + 2 * half);
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		for (std::size_t n = 0; n < half; n += V::WIDTH) {
+			Vec ar, ai, br, bi, wr, wi;
+			V::load(a + 2 * n, ar, ai);
+			V::load(b + 2 * n, br, bi);
+			V::loadTwiddles(w, n, omegaStep, wr, wi);
+
+			Vec dr(V::sub(ar, br)), di(V::sub(ai, bi));
+			V::store(a + 2 * n, V::add(ar, br), V::add(ai, bi));
+
+			cmul<V>(dr, di, wr, wi, br, bi);
+			V::store(b + 2 * n, br, bi);
+		}
+	}
+
+	template<class V>
+	void rad2Rev(Cplex *data, std::size_t half, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *a(reinterpret_cast<double*>(data));
+		double *b(a + 2 * half);
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		for (std::size_t k = 0; k < half; k += V::WIDTH) {
+			Vec ar, ai, br, bi, wr, wi, tr, ti;
+			V::load(a + 2 * k, ar, ai);
+			V::load(b + 2 * k, br, bi);
+			V::loadTwiddles(w, k, omegaStep, wr, wi);
+
+			cmulConj<V>(br, bi, wr, wi, tr, ti);
+			V::store(a + 2 * k, V::add(ar, tr), V::add(ai, ti));
+			V::store(b + 2 * k, V::sub(ar, tr), V::sub(ai, ti));
+		}
+	}
+
+	template<class V>
+	void rad3Fwd(Cplex *data, std::size_t third, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *x0(reinterpret_cast<double*>(data));
+		double *x1(x0 + 2 * third);
+		double *x2(x1 + 2 * third);
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		const Vec half(V::set1(0.5));
+		const Vec sq3o2(V::set1(0.8660254037844386)); // sqrt(3)/2
+
+		for (std::size_t n = 0; n < third; n += V::WIDTH) {
+			Vec ar, ai, br, bi, cr, ci, wr, wi, w2r, w2i;
+			V::load(x0 + 2 * n, ar, ai);
+			V::load(x1 + 2 * n, br, bi);
+			V::load(x2 + 2 * n, cr, ci);
+			V::loadTwiddles(w, n, omegaStep, wr, wi);
+			V::loadTwiddles(w, n, 2 * omegaStep, w2r, w2i);
+
+			Vec sr(V::add(br, cr)), si(V::add(bi, ci));
+			Vec dr(V::sub(br, cr)), di(V::sub(bi, ci));
+			Vec mr(V::fnmadd(half, sr, ar)), mi(V::fnmadd(half, si, ai));
+
+			V::store(x0 + 2 * n, V::add(ar, sr), V::add(ai, si));
+
+			Vec t2r(V::fmadd(sq3o2, di, mr)), t2i(V::fnmadd(sq3o2, dr, mi));
+			Vec t3r(V::fnmadd(sq3o2, di, mr)), t3i(V::fmadd(sq3o2, dr, mi));
+
+			cmul<V>(t2r, t2i, wr, wi, br, bi);
+			cmul<V>(t3r, t3i, w2r, w2i, cr, ci);
+			V::store(x1 + 2 * n, br, bi);
+			V::store(x2 + 2 * n, cr, ci);
+		}
+	}
+
+	template<class V>
+	void rad3Rev(Cplex *data, std::size_t third, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *x0(reinterpret_cast<double*>(data));
+		double *x1(x0 + 2 * third);
+		double *x2(x1 + 2 * third);
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		const Vec half(V::set1(0.5));
+		const Vec sq3o2(V::set1(0.8660254037844386)); // sqrt(3)/2
+
+		for (std::size_t n = 0; n < third; n += V::WIDTH) {
+			Vec ar, ai, br, bi, cr, ci, wr, wi, w2r, w2i, t2r, t2i, t3r, t3i;
+			V::load(x0 + 2 * n, ar, ai);
+			V::load(x1 + 2 * n, br, bi);
+			V::load(x2 + 2 * n, cr, ci);
+			V::loadTwiddles(w, n, omegaStep, wr, wi);
+			V::loadTwiddles(w, n, 2 * omegaStep, w2r, w2i);
+
+			cmulConj<V>(br, bi, wr, wi, t2r, t2i);
+			cmulConj<V>(cr, ci, w2r, w2i, t3r, t3i);
+
+			Vec sr(V::add(t2r, t3r)), si(V::add(t2i, t3i));
+			Vec dr(V::sub(t2r, t3r)), di(V::sub(t2i, t3i));
+			Vec mr(V::fnmadd(half, sr, ar)), mi(V::fnmadd(half, si, ai));
+
+			// n.b. some of the signs change here due to the conjugated trig
+			V::store(x0 + 2 * n, V::add(ar, sr), V::add(ai, si));
+			V::store(x1 + 2 * n, V::fnmadd(sq3o2, di, mr), V::fmadd(sq3o2, dr, mi));
+			V::store(x2 + 2 * n, V::fmadd(sq3o2, di, mr), V::fnmadd(sq3o2, dr, mi));
+		}
+	}
+
+	// Load the twiddle powers w^1 ... w^P for the butterflies n ... n + WIDTH - 1 of a pass, where
+	// w = omega[n * step]. Only w and w^2 are loaded; the rest are built up from them, as each load
+	// from the omega table is a gather at a large stride. Each power is at most two products away
+	// from the loaded roots.
+	template<class V, std::size_t P>
+	inline void loadTwiddlePowers(const double *omega, std::size_t n, std::size_t step,
+		typename V::Vec (&wr)[P], typename V::Vec (&wi)[P])
+	{
+		V::loadTwiddles(omega, n, step, wr[0], wi[0]);
+		V::loadTwiddles(omega, n, 2 * step, wr[1], wi[1]);
+		if (P > 2) {
+			cmul<V>(wr[1], wi[1], wr[0], wi[0], wr[2], wi[2]); // w^3 = w^2 * w
+		}
+		if (P > 3) {
+			cmul<V>(wr[1], wi[1], wr[1], wi[1], wr[3], wi[3]); // w^4 = w^2 * w^2
+		}
+		for (std::size_t p = 4; p < P; ++p) {
+			cmul<V>(wr[3], wi[3], wr[p - 4], wi[p - 4], wr[p], wi[p]); // w^(p+1) = w^4 * w^(p-3)
+		}
+	}
+
+	// The length-5 DFT is done by pairing the inputs symmetrically about x0, after which the
+	// outputs come in conjugate-symmetric pairs: only two real "rotations" are needed per pair.
+	// c1, c2 are cos(2pi/5), cos(4pi/5); s1, s2 are sin(2pi/5), sin(4pi/5).
+	template<class V>
+	void rad5Fwd(Cplex *data, std::size_t fifth, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *x(reinterpret_cast<double*>(data));
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		const Vec c1(V::set1(0.30901699437494742)), c2(V::set1(-0.80901699437494742));
+		const Vec s1(V::set1(0.95105651629515357)), s2(V::set1(0.58778525229247313));
+
+		for (std::size_t n = 0; n < fifth; n += V::WIDTH) {
+			Vec dr[5], di[5];
+			for (std::size_t p = 0; p < 5; ++p) {
+				V::load(x + 2 * (p * fifth + n), dr[p], di[p]);
+			}
+
+			Vec a1r(V::add(dr[1], dr[4])), a1i(V::add(di[1], di[4]));
+			Vec b1r(V::sub(dr[1], dr[4])), b1i(V::sub(di[1], di[4]));
+			Vec a2r(V::add(dr[2], dr[3])), a2i(V::add(di[2], di[3]));
+			Vec b2r(V::sub(dr[2], dr[3])), b2i(V::sub(di[2], di[3]));
+
+			Vec m1r(V::fmadd(c1, a1r, V::fmadd(c2, a2r, dr[0])));
+			Vec m1i(V::fmadd(c1, a1i, V::fmadd(c2, a2i, di[0])));
+			Vec m2r(V::fmadd(c2, a1r, V::fmadd(c1, a2r, dr[0])));
+			Vec m2i(V::fmadd(c2, a1i, V::fmadd(c1, a2i, di[0])));
+			Vec ur(V::fmadd(s1, b1r, V::mul(s2, b2r))), ui(V::fmadd(s1, b1i, V::mul(s2, b2i)));
+			Vec vr(V::fmsub(s2, b1r, V::mul(s1, b2r))), vi(V::fmsub(s2, b1i, V::mul(s1, b2i)));
+
+			V::store(x + 2 * n, V::add(dr[0], V::add(a1r, a2r)), V::add(di[0], V::add(a1i, a2i)));
+
+			// X1, X4 = m1 -/+ i*u; X2, X3 = m2 -/+ i*v
+			dr[1] = V::add(m1r, ui); di[1] = V::sub(m1i, ur);
+			dr[4] = V::sub(m1r, ui); di[4] = V::add(m1i, ur);
+			dr[2] = V::add(m2r, vi); di[2] = V::sub(m2i, vr);
+			dr[3] = V::sub(m2r, vi); di[3] = V::add(m2i, vr);
+
+			Vec wr[4], wi[4];
+			loadTwiddlePowers<V, 4>(w, n, omegaStep, wr, wi);
+			for (std::size_t p = 1; p < 5; ++p) {
+				Vec yr, yi;
+				cmul<V>(dr[p], di[p], wr[p - 1], wi[p - 1], yr, yi);
+				V::store(x + 2 * (p * fifth + n), yr, yi);
+			}
+		}
+	}
+
+	template<class V>
+	void rad5Rev(Cplex *data, std::size_t fifth, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *x(reinterpret_cast<double*>(data));
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		const Vec c1(V::set1(0.30901699437494742)), c2(V::set1(-0.80901699437494742));
+		const Vec s1(V::set1(0.95105651629515357)), s2(V::set1(0.58778525229247313));
+
+		for (std::size_t n = 0; n < fifth; n += V::WIDTH) {
+			Vec dr[5], di[5], wr[4], wi[4];
+			loadTwiddlePowers<V, 4>(w, n, omegaStep, wr, wi);
+			V::load(x + 2 * n, dr[0], di[0]);
+			for (std::size_t p = 1; p < 5; ++p) {
+				Vec yr, yi;
+				V::load(x + 2 * (p * fifth + n), yr, yi);
+				cmulConj<V>(yr, yi, wr[p - 1], wi[p - 1], dr[p], di[p]);
+			}
+
+			Vec a1r(V::add(dr[1], dr[4])), a1i(V::add(di[1], di[4]));
+			Vec b1r(V::sub(dr[1], dr[4])), b1i(V::sub(di[1], di[4]));
+			Vec a2r(V::add(dr[2], dr[3])), a2i(V::add(di[2], di[3]));
+			Vec b2r(V::sub(dr[2], dr[3])), b2i(V::sub(di[2], di[3]));
+
+			Vec m1r(V::fmadd(c1, a1r, V::fmadd(c2, a2r, dr[0])));
+			Vec m1i(V::fmadd(c1, a1i, V::fmadd(c2, a2i, di[0])));
+			Vec m2r(V::fmadd(c2, a1r, V::fmadd(c1, a2r, dr[0])));
+			Vec m2i(V::fmadd(c2, a1i, V::fmadd(c1, a2i, di[0])));
+			Vec ur(V::fmadd(s1, b1r, V::mul(s2, b2r))), ui(V::fmadd(s1, b1i, V::mul(s2, b2i)));
+			Vec vr(V::fmsub(s2, b1r, V::mul(s1, b2r))), vi(V::fmsub(s2, b1i, V::mul(s1, b2i)));
+
+			// n.b. the signs of the rotations flip due to the conjugated trig
+			V::store(x + 2 * n, V::add(dr[0], V::add(a1r, a2r)), V::add(di[0], V::add(a1i, a2i)));
+			V::store(x + 2 * (fifth + n), V::sub(m1r, ui), V::add(m1i, ur));
+			V::store(x + 2 * (4 * fifth + n), V::add(m1r, ui), V::sub(m1i, ur));
+			V::store(x + 2 * (2 * fifth + n), V::sub(m2r, vi), V::add(m2i, vr));
+			V::store(x + 2 * (3 * fifth + n), V::add(m2r, vi), V::sub(m2i, vr));
+		}
+	}
+
+	// An untwiddled length-4 DFT in place, forward or inverse. Used to build the radix-8 pass.
+	template<class V, bool fwd>
+	inline void dft4(typename V::Vec (&dr)[4], typename V::Vec (&di)[4])
+	{
+		typedef typename V::Vec Vec;
+
+		Vec e0r(V::add(dr[0], dr[2])), e0i(V::add(di[0], di[2]));
+		Vec e1r(V::sub(dr[0], dr[2])), e1i(V::sub(di[0], di[2]));
+		Vec o0r(V::add(dr[1], dr[3])), o0i(V::add(di[1], di[3]));
+		Vec o1r(V::sub(dr[1], dr[3])), o1i(V::sub(di[1], di[3]));
+
+		// The forward and inverse transforms differ only in which of outputs 1 and 3 gets
+		// e1 - i*o1 and which e1 + i*o1.
+		std::size_t minus(fwd ? 1 : 3), plus(fwd ? 3 : 1);
+		dr[0] = V::add(e0r, o0r);
+		di[0] = V::add(e0i, o0i);
+		dr[2] = V::sub(e0r, o0r);
+		di[2] = V::sub(e0i, o0i);
+		dr[minus] = V::add(e1r, o1i);
+		di[minus] = V::sub(e1i, o1r);
+		dr[plus] = V::sub(e1r, o1i);
+		di[plus] = V::add(e1i, o1r);
+	}
+
+	// The radix-8 pass splits the length-8 DFT into two length-4 DFTs: one of the sums
+	// x_k + x_{k+4}, giving the even outputs, and one of the differences x_k - x_{k+4} times
+	// e^(-2piik/8), giving the odd outputs. The eighth roots of unity are trivial apart from a
+	// factor of sqrt(1/2), so this saves the general multiplications a radix-2 pass and a
+	// radix-4 pass would spend on the intermediate twiddles.
+	template<class V>
+	void rad8Fwd(Cplex *data, std::size_t eighth, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *x(reinterpret_cast<double*>(data));
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		const Vec sqrt1o2(V::set1(0.70710678118654752)); // sqrt(1/2)
+
+		for (std::size_t n = 0; n < eighth; n += V::WIDTH) {
+			Vec er[4], ei[4], or_[4], oi[4];
+			for (std::size_t p = 0; p < 4; ++p) {
+				Vec ar, ai, br, bi;
+				V::load(x + 2 * (p * eighth + n), ar, ai);
+				V::load(x + 2 * ((p + 4) * eighth + n), br, bi);
+				er[p] = V::add(ar, br);
+				ei[p] = V::add(ai, bi);
+				or_[p] = V::sub(ar, br);
+				oi[p] = V::sub(ai, bi);
+			}
+
+			// Multiply the differences by e^(-2piik/8).
+			Vec tr(or_[1]), ti(oi[1]);
+			or_[1] = V::mul(sqrt1o2, V::add(tr, ti));
+			oi[1] = V::mul(sqrt1o2, V::sub(ti, tr));
+			tr = or_[2];
+			or_[2] = oi[2];
+			oi[2] = V::sub(V::set1(0.0), tr);
+			tr = or_[3];
+			ti = oi[3];
+			or_[3] = V::mul(sqrt1o2, V::sub(ti, tr));
+			oi[3] = V::mul(sqrt1o2, V::sub(V::set1(0.0), V::add(tr, ti)));
+
+			dft4<V, true>(er, ei);
+			dft4<V, true>(or_, oi);
+
+			Vec wr[7], wi[7];
+			loadTwiddlePowers<V, 7>(w, n, omegaStep, wr, wi);
+			V::store(x + 2 * n, er[0], ei[0]);
+			for (std::size_t p = 1; p < 8; ++p) {
+				Vec yr, yi;
+				if (p & 1) {
+					cmul<V>(or_[p >> 1], oi[p >> 1], wr[p - 1], wi[p - 1], yr, yi);
+				} else {
+					cmul<V>(er[p >> 1], ei[p >> 1], wr[p - 1], wi[p - 1], yr, yi);
+				}
+				V::store(x + 2 * (p * eighth + n), yr, yi);
+			}
+		}
+	}
+
+	template<class V>
+	void rad8Rev(Cplex *data, std::size_t eighth, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *x(reinterpret_cast<double*>(data));
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		const Vec sqrt1o2(V::set1(0.70710678118654752)); // sqrt(1/2)
+
+		for (std::size_t n = 0; n < eighth; n += V::WIDTH) {
+			Vec er[4], ei[4], or_[4], oi[4], wr[7], wi[7];
+			loadTwiddlePowers<V, 7>(w, n, omegaStep, wr, wi);
+			V::load(x + 2 * n, er[0], ei[0]);
+			for (std::size_t p = 1; p < 8; ++p) {
+				Vec yr, yi;
+				V::load(x + 2 * (p * eighth + n), yr, yi);
+				if (p & 1) {
+					cmulConj<V>(yr, yi, wr[p - 1], wi[p - 1], or_[p >> 1], oi[p >> 1]);
+				} else {
+					cmulConj<V>(yr, yi, wr[p - 1], wi[p - 1], er[p >> 1], ei[p >> 1]);
+				}
+			}
+
+			dft4<V, false>(er, ei);
+			dft4<V, false>(or_, oi);
+
+			// Multiply the odd half by e^(+2piik/8).
+			Vec tr(or_[1]), ti(oi[1]);
+			or_[1] = V::mul(sqrt1o2, V::sub(tr, ti));
+			oi[1] = V::mul(sqrt1o2, V::add(tr, ti));
+			tr = or_[2];
+			or_[2] = V::sub(V::set1(0.0), oi[2]);
+			oi[2] = tr;
+			tr = or_[3];
+			ti = oi[3];
+			or_[3] = V::mul(sqrt1o2, V::sub(V::set1(0.0), V::add(tr, ti)));
+			oi[3] = V::mul(sqrt1o2, V::sub(tr, ti));
+
+			for (std::size_t p = 0; p < 4; ++p) {
+				V::store(x + 2 * (p * eighth + n), V::add(er[p], or_[p]), V::add(ei[p], oi[p]));
+				V::store(x + 2 * ((p + 4) * eighth + n), V::sub(er[p], or_[p]),
+					V::sub(ei[p], oi[p]));
+			}
+		}
+	}
+
+	// The radix-4 butterflies themselves, on data already split into vectors. d holds the four
+	// inputs and receives the four outputs; w holds w, w^2 and w^3.
+	template<class V>
+	inline void rad4FwdButterfly(typename V::Vec (&dr)[4], typename V::Vec (&di)[4],
+		const typename V::Vec (&wr)[3], const typename V::Vec (&wi)[3])
+	{
+		typedef typename V::Vec Vec;
+
+		// Same decomposition into two length-2 DFTs as in the scalar version.
+		Vec e0r(V::add(dr[0], dr[2])), e0i(V::add(di[0], di[2]));
+		Vec e1r(V::sub(dr[0], dr[2])), e1i(V::sub(di[0], di[2]));
+		Vec o0r(V::add(dr[1], dr[3])), o0i(V::add(di[1], di[3]));
+		Vec o1r(V::sub(dr[1], dr[3])), o1i(V::sub(di[1], di[3]));
+
+		dr[0] = V::add(e0r, o0r);
+		di[0] = V::add(e0i, o0i);
+		cmul<V>(V::add(e1r, o1i), V::sub(e1i, o1r), wr[0], wi[0], dr[1], di[1]); // e1 + (-i)*o1
+		cmul<V>(V::sub(e0r, o0r), V::sub(e0i, o0i), wr[1], wi[1], dr[2], di[2]);
+		cmul<V>(V::sub(e1r, o1i), V::add(e1i, o1r), wr[2], wi[2], dr[3], di[3]); // e1 - (-i)*o1
+	}
+
+	template<class V>
+	inline void rad4RevButterfly(typename V::Vec (&dr)[4], typename V::Vec (&di)[4],
+		const typename V::Vec (&wr)[3], const typename V::Vec (&wi)[3])
+	{
+		typedef typename V::Vec Vec;
+
+		Vec t1r, t1i, t2r, t2i, t3r, t3i;
+		cmulConj<V>(dr[1], di[1], wr[0], wi[0], t1r, t1i);
+		cmulConj<V>(dr[2], di[2], wr[1], wi[1], t2r, t2i);
+		cmulConj<V>(dr[3], di[3], wr[2], wi[2], t3r, t3i);
+
+		Vec e0r(V::add(dr[0], t2r)), e0i(V::add(di[0], t2i));
+		Vec e1r(V::sub(dr[0], t2r)), e1i(V::sub(di[0], t2i));
+		Vec o0r(V::add(t1r, t3r)), o0i(V::add(t1i, t3i));
+		Vec o1r(V::sub(t1r, t3r)), o1i(V::sub(t1i, t3i));
+
+		dr[0] = V::add(e0r, o0r);
+		di[0] = V::add(e0i, o0i);
+		dr[1] = V::sub(e1r, o1i); // e1 + (+i)*o1
+		di[1] = V::add(e1i, o1r);
+		dr[2] = V::sub(e0r, o0r);
+		di[2] = V::sub(e0i, o0i);
+		dr[3] = V::add(e1r, o1i); // e1 - (+i)*o1
+		di[3] = V::sub(e1i, o1r);
+	}
+
+	// One radix-4 pass, with the twiddles taken from the omega table as in rad4Rec.
+	template<class V, bool fwd>
+	void rad4Strided(Cplex *data, std::size_t quarter, const Cplex *omega, std::size_t omegaStep)
+	{
+		typedef typename V::Vec Vec;
+		double *x(reinterpret_cast<double*>(data));
+		const double *w(reinterpret_cast<const double*>(omega));
+
+		for (std::size_t n = 0; n < quarter; n += V::WIDTH) {
+			Vec dr[4], di[4], wr[3], wi[3];
+			for (std::size_t p = 0; p < 4; ++p) {
+				V::load(x + 2 * (p * quarter + n), dr[p], di[p]);
+			}
+			for (std::size_t p = 0; p < 3; ++p) {
+				V::loadTwiddles(w, n, (p + 1) * omegaStep, wr[p], wi[p]);
+			}
+
+			if (fwd) {
+				rad4FwdButterfly<V>(dr, di, wr, wi);
+			} else {
+				rad4RevButterfly<V>(dr, di, wr, wi);
+			}
+
+			for (std::size_t p = 0; p < 4; ++p) {
+				V::store(x + 2 * (p * quarter + n), dr[p], di[p]);
+			}
+		}
+	}
+
+	// One radix-4 pass, with the twiddles packed as described for ButterflyKernels::PackedPass.
+	template<class V, bool fwd>
+	void rad4Packed(Cplex *data, std::size_t quarter, const Cplex *twiddles)
+	{
+		typedef typename V::Vec Vec;
+		double *x(reinterpret_cast<double*>(data));
+		const double *w(reinterpret_cast<const double*>(twiddles));
+
+		for (std::size_t n = 0; n < quarter; n += V::WIDTH) {
+			Vec dr[4], di[4], wr[3], wi[3];
+			for (std::size_t p = 0; p < 4; ++p) {
+				V::load(x + 2 * (p * quarter + n), dr[p], di[p]);
+			}
+			for (std::size_t p = 0; p < 3; ++p) {
+				V::load(w + 2 * (p * quarter + n), wr[p], wi[p]);
+			}
+
+			if (fwd) {
+				rad4FwdButterfly<V>(dr, di, wr, wi);
+			} else {
+				rad4RevButterfly<V>(dr, di, wr, wi);
+			}
+
+			for (std::size_t p = 0; p < 4; ++p) {
+				V::store(x + 2 * (p * quarter + n), dr[p], di[p]);
+			}
+		}
+	}
+
+	// The same pass over many consecutive blocks at once, for when the blocks are too small to
+	// fill a vector: each vector then takes the same butterfly from WIDTH different blocks.
+	template<class V, bool fwd>
+	void rad4Batch(Cplex *data, std::size_t quarter, std::size_t blocks, const Cplex *twiddles)
+	{
+		typedef typename V::Vec Vec;
+		double *x(reinterpret_cast<double*>(data));
+		const double *w(reinterpret_cast<const double*>(twiddles));
+		std::size_t blockSize(4 * quarter);
+
+		for (std::size_t n = 0; n < quarter; ++n) {
+			Vec wr[3], wi[3];
+			for (std::size_t p = 0; p < 3; ++p) {
+				wr[p] = V::set1(w[2 * (p * quarter + n)]);
+				wi[p] = V::set1(w[2 * (p * quarter + n) + 1]);
+			}
+
+			for (std::size_t b = 0; b < blocks; b += V::WIDTH) {
+				double *block(x + 2 * (b * blockSize + n));
+
+				Vec dr[4], di[4];
+				for (std::size_t p = 0; p < 4; ++p) {
+					V::loadStrided(block + 2 * p * quarter, blockSize, dr[p], di[p]);
+				}
+
+				if (fwd) {
+					rad4FwdButterfly<V>(dr, di, wr, wi);
+				} else {
+					rad4RevButterfly<V>(dr, di, wr, wi);
+				}
+
+				for (std::size_t p = 0; p < 4; ++p) {
+					V::storeStrided(block + 2 * p * quarter, blockSize, dr[p], di[p]);
+				}
+			}
+		}
+	}
+
+	// The codelets: straight-line transforms of a fixed power-of-4 length N, generated at compile
+	// time by unrolling the passes rad4Itr would do, with their twiddles as constants. They do
+	// exactly the same arithmetic as those passes, so a transform may use them on one side and
+	// not the other. The roots are worked out by the compiler, from Taylor series in long double
+	// on the first quadrant, which is accurate to well past double precision for the few angles
+	// needed.
+	constexpr long double c_codeletPi = 3.141592653589793238462643383279502884L;
+
+	constexpr long double codeletSin(long double x)
+	{
+		long double sum(0.0L), term(x);
+		for (int k = 1; k < 40; k += 2) {
+			sum += term;
+			term *= -x * x / ((k + 1) * (k + 2));
+		}
+
+		return sum;
+	}
+
+	constexpr long double codeletCos(long double x)
+	{
+		long double sum(0.0L), term(1.0L);
+		for (int k = 0; k < 40; k += 2) {
+			sum += term;
+			term *= -x * x / ((k + 1) * (k + 2));
+		}
+
+		return sum;
+	}
+
+	// e^(-2pii k/N) for k < N, real parts (imag = false) or imaginary parts (imag = true).
+	template<std::size_t N>
+	constexpr std::array<double, N> makeCodeletRoots(bool imag)
+	{
+		std::array<double, N> roots {};
+		for (std::size_t k = 0; k < N; ++k) {
+			// 2pi k/N = quadrant * pi/2 + phi, with 0 <= phi < pi/2.
+			std::size_t quadrant((4 * k) / N);
+			long double phi(c_codeletPi * (4 * k - quadrant * N) / (2 * N));
+			long double c(codeletCos(phi)), s(codeletSin(phi));
+
+			long double cosTheta(0.0L), sinTheta(0.0L);
+			switch (quadrant) {
+				case 0: cosTheta = c; sinTheta = s; break;
+				case 1: cosTheta = -s; sinTheta = c; break;
+				case 2: cosTheta = -c; sinTheta = -s; break;
+				default: cosTheta = s; sinTheta = -c; break;
+			}
+
+			roots[k] = static_cast<double>(imag ? -sinTheta : cosTheta);
+		}
+
+		return roots;
+	}
+
+	template<std::size_t N>
+	struct CodeletRoots
+	{
+			static constexpr std::array<double, N> re = makeCodeletRoots<N>(false);
+			static constexpr std::array<double, N> im = makeCodeletRoots<N>(true);
+	};
+
+	// Butterfly n of the radix-4 pass over a codelet block of length N, held in registers. The
+	// first butterfly has only trivial twiddles, so it is a plain length-4 DFT.
+	template<class V, std::size_t N, bool fwd, std::size_t n>
+	inline void codeletButterfly(typename V::Vec *xr, typename V::Vec *xi)
+	{
+		typedef typename V::Vec Vec;
+		constexpr std::size_t quarter(N / 4);
+
+		Vec dr[4], di[4];
+		for (std::size_t p = 0; p < 4; ++p) {
+			dr[p] = xr[n + p * quarter];
+			di[p] = xi[n + p * quarter];
+		}
+
+		if constexpr (n == 0) {
+			dft4<V, fwd>(dr, di);
+		} else {
+			const Vec wr[3] = { V::set1(CodeletRoots<N>::re[n]), V::set1(CodeletRoots<N>::re[2 * n]),
+				V::set1(CodeletRoots<N>::re[3 * n]) };
+			const Vec wi[3] = { V::set1(CodeletRoots<N>::im[n]), V::set1(CodeletRoots<N>::im[2 * n]),
+				V::set1(CodeletRoots<N>::im[3 * n]) };
+
+			if constexpr (fwd) {
+				rad4FwdButterfly<V>(dr, di, wr, wi);
+			} else {
+				rad4RevButterfly<V>(dr, di, wr, wi);
+			}
+		}
+
+		for (std::size_t p = 0; p < 4; ++p) {
+			xr[n + p * quarter] = dr[p];
+			xi[n + p * quarter] = di[p];
+		}
+	}
+
+	template<class V, std::size_t N, bool fwd, std::size_t... n>
+	inline void codeletPass(typename V::Vec *xr, typename V::Vec *xi, std::index_sequence<n...>)
+	{
+		(codeletButterfly<V, N, fwd, n>(xr, xi), ...);
+	}
+
+	// The whole length-N transform in registers: DIF for the forward one, DIT for the inverse, in
+	// the same order as rad4Itr's passes.
+	template<class V, std::size_t N, bool fwd>
+	inline void codeletTransform(typename V::Vec *xr, typename V::Vec *xi)
+	{
+		if constexpr (N >= 4) {
+			constexpr std::size_t quarter(N / 4);
+
+			if constexpr (fwd) {
+				codeletPass<V, N, fwd>(xr, xi, std::make_index_sequence<quarter>());
+			}
+
+			codeletTransform<V, quarter, fwd>(xr, xi);
+			codeletTransform<V, quarter, fwd>(xr + quarter, xi + quarter);
+			codeletTransform<V, quarter, fwd>(xr + 2 * quarter, xi + 2 * quarter);
+			codeletTransform<V, quarter, fwd>(xr + 3 * quarter, xi + 3 * quarter);
+
+			if constexpr (!fwd) {
+				codeletPass<V, N, fwd>(xr, xi, std::make_index_sequence<quarter>());
+			}
+		}
+	}
+
+	// The codelet over consecutive blocks of length N, WIDTH blocks at a time, each vector taking
+	// the same element from each of them. blocks must be a multiple of WIDTH.
+	template<class V, std::size_t N, bool fwd>
+	void codelet(Cplex *data, std::size_t blocks)
+	{
+		typedef typename V::Vec Vec;
+		double *x(reinterpret_cast<double*>(data));
+
+		for (std::size_t b = 0; b < blocks; b += V::WIDTH) {
+			double *block(x + 2 * b * N);
+
+			Vec xr[N], xi[N];
+			for (std::size_t j = 0; j < N; ++j) {
+				V::loadStrided(block + 2 * j, N, xr[j], xi[j]);
+			}
+
+			codeletTransform<V, N, fwd>(xr, xi);
+
+			for (std::size_t j = 0; j < N; ++j) {
+				V::storeStrided(block + 2 * j, N, xr[j], xi[j]);
+			}
+		}
+	}
+
+	// Function:   makeKernels
+	// Purpose:    Fill out a ButterflyKernels with the kernels for V.
+	// Parameters: name - The name of the instruction set.
+	// Returns:    The kernels.
+	template<class V>
+	ButterflyKernels makeKernels(const char *name)
+	{
+		ButterflyKernels kernels = {
+			name, V::WIDTH,
+			rad2Fwd<V>, rad2Rev<V>,
+			rad3Fwd<V>, rad3Rev<V>,
+			rad5Fwd<V>, rad5Rev<V>,
+			rad8Fwd<V>, rad8Rev<V>,
+			rad4Strided<V, true>, rad4Strided<V, false>,
+			rad4Packed<V, true>, rad4Packed<V, false>,
+			rad4Batch<V, true>, rad4Batch<V, false>,
+			codelet<V, 4, true>, codelet<V, 4, false>,
+			codelet<V, 16, true>, codelet<V, 16, false>,
+			codelet<V, 64, true>, codelet<V, 64, false>
+		};
+
+		return kernels;
+	}
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_VECBUTTERFLIES_HPP_ */
@@ -0,0 +1,54 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      ModularFft.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ModularFft.hpp"
+
+#include <cmath>
+
+namespace SDF::Bignum::Multiplication::Fft::Modular
+{
+	ModularFft::ModularFft(const Montgomery &mod)
+		: m_mod(mod)
+	{
+	}
+
+	std::size_t ModularFft::getMaxNumLengthAtBase(long base) const
+	{
+		// Unlike the complex FFT, there is no rounding error here at all: the transform is exact,
+		// so the only limit is that the largest element of the multiplication pyramid,
+		//
+		//        Factor size * (base-1)^2,
+		//
+		// must not wrap around the modulus. (Larger products are possible by transforming over
+		// several primes and recombining with the Chinese remainder theorem - see the NTT
+		// multiplication strategy.)
+		long double pyramidMax(static_cast<long double>(base - 1) * (base - 1));
+		return static_cast<std::size_t>(floorl(m_mod.getModulus() / pyramidMax));
+	}
+
+	const Montgomery &ModularFft::getArithmetic() const
+	{
+		return m_mod;
+	}
+}
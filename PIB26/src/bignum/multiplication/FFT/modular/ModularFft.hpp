@@ -0,0 +1,61 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      ModularFft.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_MODULARFFT_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_MODULARFFT_HPP_
+
+#include "../IFft.hpp"
+
+#include "Montgomery.hpp"
+
+#include <cstdint>
+
+namespace SDF::Bignum::Multiplication::Fft::Modular
+{
+	// Class:      ModularFft
+	// Purpose:    Provides an abstract base for number-theoretic transforms (NTTs), i.e. FFTs over
+	//             the finite field Z/pZ for a prime p. Elements are residues held as plain
+	//             64-bit integers in [0, p).
+	// Parameters: None.
+	class ModularFft : public IFft<std::uint64_t>
+	{
+		public:
+			// Function:   ModularFft
+			// Purpose:    Construct the base for a transform over a given prime field.
+			// Parameters: mod - The modular arithmetic for the prime.
+			ModularFft(const Montgomery &mod);
+
+			std::size_t getMaxNumLengthAtBase(long base) const;
+
+			// Function:   getArithmetic
+			// Purpose:    Get the modular arithmetic object this transform works in.
+			// Parameters: None.
+			// Returns:    The arithmetic object.
+			const Montgomery &getArithmetic() const;
+		protected:
+			Montgomery m_mod;
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_MODULARFFT_HPP_ */
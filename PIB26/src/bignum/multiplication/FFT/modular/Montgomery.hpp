@@ -0,0 +1,166 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      Montgomery.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_MONTGOMERY_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_MONTGOMERY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SDF::Bignum::Multiplication::Fft::Modular
+{
+	// Class:      Montgomery
+	// Purpose:    Provides fast arithmetic modulo a prime just under 2^63 using Montgomery's
+	//             method, so that a modular multiply costs two integer multiplies and a shift
+	//             instead of a 128-bit division. Note that multiplying a plain residue by a constant
+	//             held in Montgomery form (i.e. times 2^64 mod p) gives a plain residue back; the
+	//             number-theoretic transforms exploit this by storing only the roots of unity in
+	//             Montgomery form and leaving the data in plain form.
+	// Parameters: None.
+	class Montgomery
+	{
+		public:
+			Montgomery()
+				: m_p(0), m_pInvNeg(0), m_r2(0)
+			{
+			}
+
+			// Function:   Montgomery
+			// Purpose:    Set up the arithmetic for a given prime modulus.
+			// Parameters: p - The modulus. Must be an odd prime less than 2^63.
+			Montgomery(std::uint64_t p)
+				: m_p(p)
+			{
+				// Newton iteration for p^(-1) mod 2^64: each step doubles the number of correct
+				// bits, and p itself is correct to 3 bits since p*p == 1 mod 8 for odd p.
+				std::uint64_t inv(p);
+				for (int i(0); i < 5; ++i) {
+					inv *= 2 - p * inv;
+				}
+
+				m_pInvNeg = -inv;
+
+				unsigned __int128 r(((static_cast<unsigned __int128>(1) << 64)) % p);
+				m_r2 = static_cast<std::uint64_t>((r * r) % p);
+			}
+
+			// Function:   getModulus
+			// Purpose:    Get the modulus.
+			// Parameters: None.
+			// Returns:    The modulus p.
+			std::uint64_t getModulus() const
+			{
+				return m_p;
+			}
+
+			// Function:   add/sub
+			// Purpose:    Add or subtract two residues in [0, p).
+			// Parameters: a, b - The residues.
+			// Returns:    The sum/difference, in [0, p).
+			inline std::uint64_t add(std::uint64_t a, std::uint64_t b) const
+			{
+				std::uint64_t s(a + b);
+				return (s >= m_p) ? (s - m_p) : s;
+			}
+
+			inline std::uint64_t sub(std::uint64_t a, std::uint64_t b) const
+			{
+				return (a >= b) ? (a - b) : (a + (m_p - b));
+			}
+
+			// Function:   mul
+			// Purpose:    Montgomery product of two residues, i.e. a * b * 2^(-64) mod p.
+			// Parameters: a, b - The residues.
+			// Returns:    The reduced product, in [0, p).
+			inline std::uint64_t mul(std::uint64_t a, std::uint64_t b) const
+			{
+				// Since p < 2^63, t + m*p < 2^126 + 2^127 and so cannot overflow 128 bits.
+				unsigned __int128 t(static_cast<unsigned __int128>(a) * b);
+				std::uint64_t m(static_cast<std::uint64_t>(t) * m_pInvNeg);
+				std::uint64_t u(static_cast<std::uint64_t>((t + static_cast<unsigned __int128>(m) * m_p)
+					>> 64));
+
+				return (u >= m_p) ? (u - m_p) : u;
+			}
+
+			// Function:   toMont/fromMont
+			// Purpose:    Convert a plain residue into and out of Montgomery form.
+			// Parameters: a - The residue to convert.
+			// Returns:    The converted residue.
+			inline std::uint64_t toMont(std::uint64_t a) const
+			{
+				return mul(a, m_r2);
+			}
+
+			inline std::uint64_t fromMont(std::uint64_t a) const
+			{
+				return mul(a, 1);
+			}
+
+			// Function:   mulPlain
+			// Purpose:    Plain modular product a * b mod p. Slow - for setup use only.
+			// Parameters: a, b - The residues.
+			// Returns:    The product mod p.
+			std::uint64_t mulPlain(std::uint64_t a, std::uint64_t b) const
+			{
+				return static_cast<std::uint64_t>((static_cast<unsigned __int128>(a) * b) % m_p);
+			}
+
+			// Function:   powPlain
+			// Purpose:    Plain modular exponentiation. Slow - for setup use only.
+			// Parameters: a - The base.
+			//             e - The exponent.
+			// Returns:    a^e mod p.
+			std::uint64_t powPlain(std::uint64_t a, std::uint64_t e) const
+			{
+				std::uint64_t rv(1);
+				a %= m_p;
+				while (e) {
+					if (e & 1) {
+						rv = mulPlain(rv, a);
+					}
+
+					a = mulPlain(a, a);
+					e >>= 1;
+				}
+
+				return rv;
+			}
+
+			// Function:   invPlain
+			// Purpose:    Plain modular inverse via Fermat's little theorem.
+			// Parameters: a - The residue to invert. Must be nonzero mod p.
+			// Returns:    a^(-1) mod p.
+			std::uint64_t invPlain(std::uint64_t a) const
+			{
+				return powPlain(a, m_p - 2);
+			}
+		private:
+			std::uint64_t m_p;       // The modulus.
+			std::uint64_t m_pInvNeg; // -p^(-1) mod 2^64.
+			std::uint64_t m_r2;      // 2^128 mod p, for conversion into Montgomery form.
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_MONTGOMERY_HPP_ */
@@ -0,0 +1,55 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      genRootTable.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "genRootTable.hpp"
+
+#include "../../../../exceptions/exceptions.hpp"
+
+#include "../../../../memory/buffers/local/RAMOnly.hpp"
+
+namespace SDF::Bignum::Multiplication::Fft::Modular
+{
+	std::unique_ptr<Memory::ILocalBuffer<std::uint64_t>> genRootTable(const Montgomery &mod,
+		std::uint64_t primRoot, std::size_t length)
+	{
+		if ((mod.getModulus() - 1) % length != 0) {
+			throw Exceptions::Exception("ERROR: Root table size does not divide the field order!");
+		}
+
+		std::unique_ptr<Memory::ILocalBuffer<std::uint64_t>> buf(
+			new Memory::Buffers::Local::RAMOnly<std::uint64_t>(length));
+		Memory::SafePtr<std::uint64_t> bufPtr(buf->accessData(0));
+
+		// Unlike the complex case, successive multiplication by the root accumulates no error, so
+		// we can just run up the powers directly.
+		std::uint64_t omega(mod.toMont(mod.powPlain(primRoot, (mod.getModulus() - 1) / length)));
+		std::uint64_t cur(mod.toMont(1));
+		for (std::size_t i(0); i < length; ++i) {
+			bufPtr[i] = cur;
+			cur = mod.mul(cur, omega);
+		}
+
+		return buf;
+	}
+}
@@ -0,0 +1,50 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      genRootTable.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_GENROOTTABLE_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_GENROOTTABLE_HPP_
+
+#include "../../../../memory/ILocalBuffer.hpp"
+
+#include "Montgomery.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace SDF::Bignum::Multiplication::Fft::Modular
+{
+	// Function:   genRootTable
+	// Purpose:    Generate the table of powers of a primitive root of unity of a given order in
+	//             Z/pZ, the modular analogue of the complex omega table. Entries are stored in
+	//             Montgomery form.
+	// Parameters: mod - The modular arithmetic for the prime p.
+	//             primRoot - A primitive root (generator) of the multiplicative group mod p.
+	//             length - The length of table to generate. Must divide p - 1.
+	// Returns:    The newly-generated root table.
+	std::unique_ptr<Memory::ILocalBuffer<std::uint64_t>> genRootTable(const Montgomery &mod,
+		std::uint64_t primRoot, std::size_t length);
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_GENROOTTABLE_HPP_ */
@@ -0,0 +1,173 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      nttItr.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "nttItr.hpp"
+
+#include "../../../../exceptions/exceptions.hpp"
+
+namespace SDF::Bignum::Multiplication::Fft::Modular
+{
+	nttItr::nttItr(const Montgomery &mod, Memory::SafePtr<std::uint64_t> rootTable,
+		std::size_t rootSize)
+		: ModularFft(mod), m_rootTable(rootTable), m_rootSize(rootSize)
+	{
+	}
+
+	std::size_t nttItr::getMaxFftSize() const
+	{
+		// As for rad3Rec, the largest number of the form 2^n or 3 * 2^n dividing the table size.
+		std::size_t maxPow2(1);
+		std::size_t rootSize(m_rootSize);
+		while (!(rootSize & 1)) {
+			rootSize >>= 1;
+			maxPow2 <<= 1;
+		}
+
+		if (m_rootSize % (3 * maxPow2) == 0) {
+			return 3 * maxPow2;
+		} else {
+			return maxPow2;
+		}
+	}
+
+	std::size_t nttItr::getNearestSafeLengthTo(std::size_t length) const
+	{
+		// Get smallest power of 2 no smaller than length.
+		std::size_t pow2(1);
+		while (pow2 < length) {
+			pow2 <<= 1;
+		}
+
+		// Get smallest number of the form 3 * 2^n no smaller than length.
+		std::size_t pow2Times3(3);
+		while (pow2Times3 < length) {
+			pow2Times3 <<= 1;
+		}
+
+		// Use the smaller as the desired safe length.
+		std::size_t safeLength(((pow2 < pow2Times3) && (m_rootSize % pow2 == 0)) ? pow2 : pow2Times3);
+		if (m_rootSize % safeLength != 0) {
+			throw Exceptions::Exception("ERROR: Required FFT size is too large!");
+		} else {
+			return safeLength;
+		}
+	}
+
+	void nttItr::doFwdTransform(Memory::SafePtr<std::uint64_t> data, std::size_t len)
+	{
+		std::size_t step(len);
+
+		if (len % 3 == 0) {
+			// One radix-3 pass up front. With w3 a primitive cube root of unity we have
+			// w3^2 = -1 - w3, so each output needs only one multiplication by it.
+			std::size_t third(len / 3);
+			std::size_t rootStep(m_rootSize / len);
+			std::uint64_t w3(m_rootTable[m_rootSize / 3]);
+
+			for (std::size_t n(0); n < third; ++n) {
+				std::uint64_t w(m_rootTable[n * rootStep]);
+				std::uint64_t w2(m_rootTable[2 * n * rootStep]);
+
+				std::uint64_t a(data[n]);
+				std::uint64_t b(data[n + third]);
+				std::uint64_t c(data[n + 2 * third]);
+
+				std::uint64_t t(m_mod.mul(m_mod.sub(b, c), w3)); // w3 * (b - c)
+
+				data[n] = m_mod.add(m_mod.add(a, b), c);
+				data[n + third] = m_mod.mul(m_mod.add(m_mod.sub(a, c), t), w); // a + w3 b + w3^2 c
+				data[n + 2 * third] = m_mod.mul(m_mod.sub(m_mod.sub(a, b), t), w2); // a + w3^2 b + w3 c
+			}
+
+			step = third;
+		}
+
+		// Radix-2 passes over chunks of size step.
+		std::size_t rootStep(m_rootSize / step);
+		while (step >= 2) {
+			std::size_t half(step >> 1);
+
+			for (Memory::SafePtr<std::uint64_t> chunk(data); chunk < data + len; chunk += step) {
+				for (std::size_t n(0); n < half; ++n) {
+					std::uint64_t x(chunk[n]);
+					std::uint64_t y(chunk[n + half]);
+
+					chunk[n] = m_mod.add(x, y);
+					chunk[n + half] = m_mod.mul(m_mod.sub(x, y), m_rootTable[n * rootStep]);
+				}
+			}
+
+			step >>= 1;
+			rootStep <<= 1;
+		}
+	}
+
+	void nttItr::doRevTransform(Memory::SafePtr<std::uint64_t> data, std::size_t len)
+	{
+		// Inverse roots are read from the table "backwards": w^(-k) = w^(N - k).
+		std::size_t pow2Len((len % 3 == 0) ? (len / 3) : len);
+		std::size_t step(2);
+		std::size_t rootStep(m_rootSize / 2);
+
+		while (step <= pow2Len) {
+			std::size_t half(step >> 1);
+
+			for (Memory::SafePtr<std::uint64_t> chunk(data); chunk < data + len; chunk += step) {
+				for (std::size_t k(0); k < half; ++k) {
+					std::uint64_t x(chunk[k]);
+					std::uint64_t y(m_mod.mul(chunk[k + half],
+						m_rootTable[(m_rootSize - k * rootStep) % m_rootSize]));
+
+					chunk[k] = m_mod.add(x, y);
+					chunk[k + half] = m_mod.sub(x, y);
+				}
+			}
+
+			step <<= 1;
+			rootStep >>= 1;
+		}
+
+		if (len % 3 == 0) {
+			// Final radix-3 pass. The inverse cube root is w3^2, and so the roles of w3 and w3^2
+			// from the forward pass swap.
+			std::size_t third(len / 3);
+			std::size_t rootStep(m_rootSize / len);
+			std::uint64_t w3(m_rootTable[m_rootSize / 3]);
+
+			for (std::size_t k(0); k < third; ++k) {
+				std::uint64_t a(data[k]);
+				std::uint64_t b(m_mod.mul(data[k + third],
+					m_rootTable[(m_rootSize - k * rootStep) % m_rootSize]));
+				std::uint64_t c(m_mod.mul(data[k + 2 * third],
+					m_rootTable[(m_rootSize - 2 * k * rootStep) % m_rootSize]));
+
+				std::uint64_t t(m_mod.mul(m_mod.sub(b, c), w3)); // w3 * (b - c)
+
+				data[k] = m_mod.add(m_mod.add(a, b), c);
+				data[k + third] = m_mod.sub(m_mod.sub(a, b), t); // a + w3^2 b + w3 c
+				data[k + 2 * third] = m_mod.add(m_mod.sub(a, c), t); // a + w3 b + w3^2 c
+			}
+		}
+	}
+}
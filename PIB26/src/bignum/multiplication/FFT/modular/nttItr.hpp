@@ -0,0 +1,68 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      nttItr.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_NTTITR_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_NTTITR_HPP_
+
+#include "ModularFft.hpp"
+
+#include "../../../../memory/SafePtr.hpp"
+
+#include "Montgomery.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SDF::Bignum::Multiplication::Fft::Modular
+{
+	// Class:      nttItr
+	// Purpose:    Wraps the iterative radix-3/radix-2 number-theoretic transform. Like rad3Rec, the
+	//             forward transform is decimation-in-frequency and the reverse decimation-in-time,
+	//             so no bit-reversal is needed, and the reverse transform is not normalized: the
+	//             data comes back multiplied by the transform length.
+	// Parameters: None.
+	class nttItr : public ModularFft
+	{
+		public:
+			// Function:   nttItr
+			// Purpose:    Construct the transform.
+			// Parameters: mod - The modular arithmetic for the prime.
+			//             rootTable - The root table, from genRootTable. Its size must be of the
+			//                         form 3 * 2^n.
+			//             rootSize - The size of the root table.
+			nttItr(const Montgomery &mod, Memory::SafePtr<std::uint64_t> rootTable,
+				std::size_t rootSize);
+
+			std::size_t getMaxFftSize() const;
+			std::size_t getNearestSafeLengthTo(std::size_t length) const;
+
+			void doFwdTransform(Memory::SafePtr<std::uint64_t> data, std::size_t len);
+			void doRevTransform(Memory::SafePtr<std::uint64_t> data, std::size_t len);
+		private:
+			Memory::SafePtr<std::uint64_t> m_rootTable;
+			std::size_t m_rootSize;
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_MODULAR_NTTITR_HPP_ */
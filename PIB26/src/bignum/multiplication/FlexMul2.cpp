@@ -28,52 +28,101 @@ namespace SDF::Bignum::Multiplication
 {
 	FlexMul2::FlexMul2(IMultiplicationStrategy *strategy1, IMultiplicationStrategy *strategy2,
 		std::size_t overrideLen)
-		: m_strategy1(strategy1), m_strategy2(strategy2), m_overrideLen(overrideLen), m_lastStrategy(
-			nullptr)
+		: m_strategy1(strategy1), m_strategy2(strategy2), m_overrideLen(overrideLen)
 	{
 	}
 
-	void FlexMul2::mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+	std::size_t FlexMul2::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
 		std::size_t bLen)
 	{
 		std::size_t prodLen(aLen + bLen);
+		IMultiplicationStrategy *strategy(nullptr);
 
 		if (prodLen < m_overrideLen) {
-			m_lastStrategy = m_strategy1;
+			strategy = m_strategy1;
 		} else {
-			m_lastStrategy = m_strategy2;
+			strategy = m_strategy2;
 		}
 
-		m_lastStrategy->mulDigits(a, aLen, b, bLen);
+		return strategy->mulDigitsInto(dst, dstLen, keepTop, a, aLen, b, bLen);
 	}
 
-	void FlexMul2::squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen)
+	std::size_t FlexMul2::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
 	{
 		std::size_t prodLen(aLen << 1);
+		IMultiplicationStrategy *strategy(nullptr);
 
 		if (prodLen < m_overrideLen) {
-			m_lastStrategy = m_strategy1;
+			strategy = m_strategy1;
 		} else {
-			m_lastStrategy = m_strategy2;
+			strategy = m_strategy2;
 		}
 
-		m_lastStrategy->squareDigits(a, aLen);
+		return strategy->squareDigitsInto(dst, dstLen, keepTop, a, aLen);
 	}
 
-	std::size_t FlexMul2::getProductLength() const
+	std::size_t FlexMul2::mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen)
 	{
-		if (m_lastStrategy != nullptr) {
-			return m_lastStrategy->getProductLength();
+		std::size_t prodLen(aLen + bLen);
+		IMultiplicationStrategy *strategy(nullptr);
+
+		if (prodLen < m_overrideLen) {
+			strategy = m_strategy1;
 		} else {
-			return 0;
+			strategy = m_strategy2;
 		}
+
+		return strategy->mulDigitsHighInto(dst, dstLen, a, aLen, b, bLen);
 	}
 
-	void FlexMul2::getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin,
-		std::size_t length)
+	std::size_t FlexMul2::mulDigitsWrappedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen,
+		std::size_t wrapLen)
 	{
-		if (m_lastStrategy != nullptr) {
-			m_lastStrategy->getProductDigits(dst, origin, length);
+		std::size_t prodLen(aLen + bLen);
+		IMultiplicationStrategy *strategy(nullptr);
+
+		if (prodLen < m_overrideLen) {
+			strategy = m_strategy1;
+		} else {
+			strategy = m_strategy2;
 		}
+
+		return strategy->mulDigitsWrappedInto(dst, dstLen, a, aLen, b, bLen, wrapLen);
+	}
+
+	std::unique_ptr<PreparedOperand> FlexMul2::prepareOperand(Memory::SafePtr<Digit> a,
+		std::size_t aLen, std::size_t maxOtherLen)
+	{
+		// Prepare it for the strategy the longest product goes to. Shorter ones going to another
+		// strategy get multiplied the ordinary way.
+		std::size_t prodLen(aLen + maxOtherLen);
+		IMultiplicationStrategy *strategy(nullptr);
+
+		if (prodLen < m_overrideLen) {
+			strategy = m_strategy1;
+		} else {
+			strategy = m_strategy2;
+		}
+
+		return strategy->prepareOperand(a, aLen, maxOtherLen);
+	}
+
+	std::size_t FlexMul2::mulPreparedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, const PreparedOperand &a, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		std::size_t prodLen(a.getLength() + bLen);
+		IMultiplicationStrategy *strategy(nullptr);
+
+		if (prodLen < m_overrideLen) {
+			strategy = m_strategy1;
+		} else {
+			strategy = m_strategy2;
+		}
+
+		return strategy->mulPreparedInto(dst, dstLen, keepTop, a, b, bLen);
 	}
 }
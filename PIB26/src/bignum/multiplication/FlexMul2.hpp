@@ -46,19 +46,27 @@ namespace SDF::Bignum::Multiplication
 			FlexMul2(IMultiplicationStrategy *strategy1, IMultiplicationStrategy *strategy2,
 				std::size_t overrideLen);
 
-			void mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+			std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
 				std::size_t bLen);
-			void squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen);
-
-			std::size_t getProductLength() const;
+			std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen);
+			std::size_t mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+			std::size_t mulDigitsWrappedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen, std::size_t wrapLen);
 
-			void getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin, std::size_t length);
+			std::unique_ptr<PreparedOperand> prepareOperand(Memory::SafePtr<Digit> a,
+				std::size_t aLen, std::size_t maxOtherLen);
+			std::size_t mulPreparedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, const PreparedOperand &a, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
 		private:
 			IMultiplicationStrategy *m_strategy1;
 			IMultiplicationStrategy *m_strategy2;
 			std::size_t m_overrideLen;
-
-			IMultiplicationStrategy *m_lastStrategy;
 	};
 }
 
@@ -29,55 +29,114 @@ namespace SDF::Bignum::Multiplication
 	FlexMul3::FlexMul3(IMultiplicationStrategy *strategy1, IMultiplicationStrategy *strategy2,
 		IMultiplicationStrategy *strategy3, std::size_t overrideLen1, std::size_t overrideLen2)
 		: m_strategy1(strategy1), m_strategy2(strategy2), m_strategy3(strategy3), m_overrideLen1(
-			overrideLen1), m_overrideLen2(overrideLen2), m_lastStrategy(nullptr)
+			overrideLen1), m_overrideLen2(overrideLen2)
 	{
 	}
 
-	void FlexMul3::mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+	std::size_t FlexMul3::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
 		std::size_t bLen)
 	{
 		std::size_t prodLen(aLen + bLen);
+		IMultiplicationStrategy *strategy(nullptr);
 
 		if (prodLen < m_overrideLen1) {
-			m_lastStrategy = m_strategy1;
+			strategy = m_strategy1;
 		} else if (prodLen < m_overrideLen2) {
-			m_lastStrategy = m_strategy2;
+			strategy = m_strategy2;
 		} else {
-			m_lastStrategy = m_strategy3;
+			strategy = m_strategy3;
 		}
 
-		m_lastStrategy->mulDigits(a, aLen, b, bLen);
+		return strategy->mulDigitsInto(dst, dstLen, keepTop, a, aLen, b, bLen);
 	}
 
-	void FlexMul3::squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen) {
+	std::size_t FlexMul3::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
+	{
 		std::size_t prodLen(aLen << 1);
+		IMultiplicationStrategy *strategy(nullptr);
+
+		if (prodLen < m_overrideLen1) {
+			strategy = m_strategy1;
+		} else if (prodLen < m_overrideLen2) {
+			strategy = m_strategy2;
+		} else {
+			strategy = m_strategy3;
+		}
+
+		return strategy->squareDigitsInto(dst, dstLen, keepTop, a, aLen);
+	}
+
+	std::size_t FlexMul3::mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		std::size_t prodLen(aLen + bLen);
+		IMultiplicationStrategy *strategy(nullptr);
+
+		if (prodLen < m_overrideLen1) {
+			strategy = m_strategy1;
+		} else if (prodLen < m_overrideLen2) {
+			strategy = m_strategy2;
+		} else {
+			strategy = m_strategy3;
+		}
+
+		return strategy->mulDigitsHighInto(dst, dstLen, a, aLen, b, bLen);
+	}
+
+	std::size_t FlexMul3::mulDigitsWrappedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen,
+		std::size_t wrapLen)
+	{
+		std::size_t prodLen(aLen + bLen);
+		IMultiplicationStrategy *strategy(nullptr);
 
 		if (prodLen < m_overrideLen1) {
-			m_lastStrategy = m_strategy1;
+			strategy = m_strategy1;
 		} else if (prodLen < m_overrideLen2) {
-			m_lastStrategy = m_strategy2;
+			strategy = m_strategy2;
 		} else {
-			m_lastStrategy = m_strategy3;
+			strategy = m_strategy3;
 		}
 
-		m_lastStrategy->squareDigits(a, aLen);
+		return strategy->mulDigitsWrappedInto(dst, dstLen, a, aLen, b, bLen, wrapLen);
 	}
 
-	std::size_t FlexMul3::getProductLength() const
+	std::unique_ptr<PreparedOperand> FlexMul3::prepareOperand(Memory::SafePtr<Digit> a,
+		std::size_t aLen, std::size_t maxOtherLen)
 	{
-		if (m_lastStrategy != nullptr) {
-			return m_lastStrategy->getProductLength();
+		// Prepare it for the strategy the longest product goes to. Shorter ones going to another
+		// strategy get multiplied the ordinary way.
+		std::size_t prodLen(aLen + maxOtherLen);
+		IMultiplicationStrategy *strategy(nullptr);
+
+		if (prodLen < m_overrideLen1) {
+			strategy = m_strategy1;
+		} else if (prodLen < m_overrideLen2) {
+			strategy = m_strategy2;
 		} else {
-			return 0;
+			strategy = m_strategy3;
 		}
+
+		return strategy->prepareOperand(a, aLen, maxOtherLen);
 	}
 
-	void FlexMul3::getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin,
-		std::size_t length)
+	std::size_t FlexMul3::mulPreparedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, const PreparedOperand &a, Memory::SafePtr<Digit> b, std::size_t bLen)
 	{
-		if (m_lastStrategy != nullptr) {
-			m_lastStrategy->getProductDigits(dst, origin, length);
+		std::size_t prodLen(a.getLength() + bLen);
+		IMultiplicationStrategy *strategy(nullptr);
+
+		if (prodLen < m_overrideLen1) {
+			strategy = m_strategy1;
+		} else if (prodLen < m_overrideLen2) {
+			strategy = m_strategy2;
+		} else {
+			strategy = m_strategy3;
 		}
+
+		return strategy->mulPreparedInto(dst, dstLen, keepTop, a, b, bLen);
 	}
 }
 
@@ -0,0 +1,93 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      FlexMulN.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "FlexMulN.hpp"
+
+#include "../../exceptions/exceptions.hpp"
+
+namespace SDF::Bignum::Multiplication
+{
+	FlexMulN::FlexMulN(const std::vector<IMultiplicationStrategy *> &strategies,
+		const std::vector<std::size_t> &overrideLens)
+		: m_strategies(strategies), m_overrideLens(overrideLens)
+	{
+		if (m_strategies.empty() || (m_overrideLens.size() + 1 != m_strategies.size())) {
+			throw SDF::Exceptions::Exception(
+				"FlexMulN needs one fewer override length than strategies");
+		}
+	}
+
+	std::size_t FlexMulN::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+		std::size_t bLen)
+	{
+		return pickStrategy(aLen + bLen)->mulDigitsInto(dst, dstLen, keepTop, a, aLen, b, bLen);
+	}
+
+	std::size_t FlexMulN::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
+	{
+		return pickStrategy(aLen << 1)->squareDigitsInto(dst, dstLen, keepTop, a, aLen);
+	}
+
+	std::size_t FlexMulN::mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		return pickStrategy(aLen + bLen)->mulDigitsHighInto(dst, dstLen, a, aLen, b, bLen);
+	}
+
+	std::size_t FlexMulN::mulDigitsWrappedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen,
+		std::size_t wrapLen)
+	{
+		return pickStrategy(aLen + bLen)->mulDigitsWrappedInto(dst, dstLen, a, aLen, b, bLen,
+			wrapLen);
+	}
+
+	std::unique_ptr<PreparedOperand> FlexMulN::prepareOperand(Memory::SafePtr<Digit> a,
+		std::size_t aLen, std::size_t maxOtherLen)
+	{
+		// Prepare it for the strategy the longest product goes to. Shorter ones going to another
+		// strategy get multiplied the ordinary way.
+		return pickStrategy(aLen + maxOtherLen)->prepareOperand(a, aLen, maxOtherLen);
+	}
+
+	std::size_t FlexMulN::mulPreparedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, const PreparedOperand &a, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		return pickStrategy(a.getLength() + bLen)->mulPreparedInto(dst, dstLen, keepTop, a, b,
+			bLen);
+	}
+
+	// Private members.
+	IMultiplicationStrategy *FlexMulN::pickStrategy(std::size_t prodLen) const
+	{
+		std::size_t tier(0);
+		while ((tier < m_overrideLens.size()) && (prodLen >= m_overrideLens[tier])) {
+			++tier;
+		}
+
+		return m_strategies[tier];
+	}
+}
@@ -0,0 +1,79 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      FlexMulN.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FLEXMULN_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FLEXMULN_HPP_
+
+#include "../IMultiplicationStrategy.hpp"
+
+#include <vector>
+
+namespace SDF::Bignum::Multiplication
+{
+	// Class:   FlexMulN
+	// Purpose: Implements a "flex" mul strategy like FlexMul2 and FlexMul3, but combining any
+	//          number of other multiplication strategies, each taking over from the one before it
+	//          at a given product length.
+	class FlexMulN : public IMultiplicationStrategy
+	{
+		public:
+			// Function:  FlexMulN
+			// Purpose:   Construct a new flex multiply strategy object.
+			// Arguments: strategies - The strategies to combine, from the one for the shortest
+			//                         products to the one for the longest.
+			//            overrideLens - The lengths at which to switch from each strategy to the
+			//                           next, in increasing order, one fewer than the strategies.
+			FlexMulN(const std::vector<IMultiplicationStrategy *> &strategies,
+				const std::vector<std::size_t> &overrideLens);
+
+			std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+			std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen);
+			std::size_t mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+			std::size_t mulDigitsWrappedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen, std::size_t wrapLen);
+
+			std::unique_ptr<PreparedOperand> prepareOperand(Memory::SafePtr<Digit> a,
+				std::size_t aLen, std::size_t maxOtherLen);
+			std::size_t mulPreparedInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, const PreparedOperand &a, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+		private:
+			std::vector<IMultiplicationStrategy *> m_strategies;
+			std::vector<std::size_t> m_overrideLens;
+
+			// Function:   pickStrategy
+			// Purpose:    Pick the strategy for a product.
+			// Parameters: prodLen - The length of the product.
+			// Returns:    The strategy.
+			IMultiplicationStrategy *pickStrategy(std::size_t prodLen) const;
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FLEXMULN_HPP_ */
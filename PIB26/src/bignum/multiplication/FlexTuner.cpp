@@ -0,0 +1,328 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      FlexTuner.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "FlexTuner.hpp"
+
+#include "../../exceptions/exceptions.hpp"
+
+#include "../../memory/buffers/local/RAMOnly.hpp"
+
+#include "../../util/cacheInfo.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace SDF::Bignum::Multiplication
+{
+	FlexTuner::FlexTuner(const std::string &fileName, const std::vector<Tier> &tiers,
+		std::size_t numThreads)
+		: m_tiers(tiers), m_fileName(fileName), m_haveOverrideLens(false), m_timedLen(0)
+	{
+		if (m_tiers.empty()) {
+			throw SDF::Exceptions::Exception("FlexTuner needs at least one tier");
+		}
+
+		const Util::CacheSizes &caches(Util::getCacheSizes());
+
+		std::ostringstream key;
+		for (std::size_t t(0); t < m_tiers.size(); ++t) {
+			key << ((t > 0) ? "," : "") << m_tiers[t].name;
+		}
+
+		key << "/L1=" << caches.l1 << "/L2=" << caches.l2 << "/L3=" << caches.l3 << "/threads="
+			<< numThreads;
+		m_key = key.str();
+
+		load();
+	}
+
+	bool FlexTuner::getOverrideLens(std::size_t maxProdLen,
+		std::vector<std::size_t> &overrideLens) const
+	{
+		if (!m_haveOverrideLens) {
+			return false;
+		}
+
+		// Past the lengths timed, everything went to the last tier, which may not be right.
+		if ((getTimedLen(maxProdLen) > m_timedLen) && !m_overrideLens.empty() &&
+			(maxProdLen >= m_overrideLens.back())) {
+			return false;
+		}
+
+		overrideLens = m_overrideLens;
+		return true;
+	}
+
+	std::vector<std::size_t> FlexTuner::calibrate(std::size_t maxProdLen)
+	{
+		// The lengths to time: STEPS_PER_OCTAVE to each doubling.
+		std::vector<std::size_t> lens;
+		maxProdLen = getTimedLen(maxProdLen);
+		for (std::size_t step(0);; ++step) {
+			std::size_t len(static_cast<std::size_t>(std::lround(MIN_PROD_LEN *
+				std::pow(2.0, static_cast<double>(step) / STEPS_PER_OCTAVE))));
+			if (len > maxProdLen) {
+				break;
+			}
+
+			if (lens.empty() || (len != lens.back())) {
+				lens.push_back(len);
+			}
+		}
+
+		if (lens.empty()) {
+			lens.push_back(maxProdLen);
+		}
+
+		std::size_t numTiers(m_tiers.size());
+		std::size_t longest(lens.back());
+
+		std::mt19937 rng(26);
+		std::uniform_int_distribution<Digit> digit(0, BASE - 1);
+		Memory::Buffers::Local::RAMOnly<Digit> aBuffer(longest);
+		Memory::Buffers::Local::RAMOnly<Digit> bBuffer(longest);
+		Memory::Buffers::Local::RAMOnly<Digit> prodBuffer(2 * longest);
+		Memory::SafePtr<Digit> a(aBuffer.accessData(0));
+		Memory::SafePtr<Digit> b(bBuffer.accessData(0));
+		for (std::size_t i(0); i < longest; ++i) {
+			a[i] = digit(rng);
+			b[i] = digit(rng);
+		}
+
+		// The cost of each tier at each length: the time for a balanced product and for one with
+		// a factor a fifth of the length, each over the fastest tier's, summed. Tiers that cannot
+		// take the length, or have been left out, cost infinity.
+		static const double c_infinity = std::numeric_limits<double>::infinity();
+		std::vector<std::vector<double>> cost(lens.size(), std::vector<double>(numTiers,
+			c_infinity));
+		std::vector<std::size_t> slowRuns(numTiers, 0);
+		for (std::size_t k(0); k < lens.size(); ++k) {
+			std::size_t len(lens[k]);
+			std::size_t shapes[2][2] = { { len - (len / 2), len / 2 },
+				{ len - (len / 5), std::max<std::size_t>(len / 5, 1) } };
+
+			std::vector<double> total(numTiers, 0.0);
+			for (const auto &shape : shapes) {
+				std::vector<double> times(numTiers, c_infinity);
+				for (std::size_t t(0); t < numTiers; ++t) {
+					if ((len <= m_tiers[t].maxProdLen) && (slowRuns[t] < 2)) {
+						times[t] = timeProduct(*m_tiers[t].strategy, prodBuffer.accessData(0), a,
+							shape[0], b, shape[1]);
+					}
+				}
+
+				double best(*std::min_element(times.begin(), times.end()));
+				for (std::size_t t(0); t < numTiers; ++t) {
+					total[t] += times[t] / best;
+				}
+			}
+
+			// Leave out a tier once some later one has beaten it by far at two lengths in a row.
+			for (std::size_t t(0); t < numTiers; ++t) {
+				cost[k][t] = total[t];
+
+				double laterBest(c_infinity);
+				for (std::size_t u(t + 1); u < numTiers; ++u) {
+					laterBest = std::min(laterBest, total[u]);
+				}
+
+				slowRuns[t] = (total[t] > DROP_FACTOR * laterBest) ? slowRuns[t] + 1 : 0;
+			}
+		}
+
+		// Give each length to a tier, the tiers coming in order, so the total cost is least.
+		// best[k][t] is the least cost of the lengths up to k with length k given to tier t, and
+		// from[k][t] the tier length k - 1 was given to for it.
+		std::vector<std::vector<double>> best(lens.size(), std::vector<double>(numTiers));
+		std::vector<std::vector<std::size_t>> from(lens.size(),
+			std::vector<std::size_t>(numTiers, 0));
+		for (std::size_t k(0); k < lens.size(); ++k) {
+			double bestBefore(c_infinity);
+			std::size_t bestTier(0);
+			for (std::size_t t(0); t < numTiers; ++t) {
+				if (k > 0) {
+					if (best[k - 1][t] < bestBefore) {
+						bestBefore = best[k - 1][t];
+						bestTier = t;
+					}
+				} else {
+					bestBefore = 0.0;
+				}
+
+				best[k][t] = bestBefore + cost[k][t];
+				from[k][t] = bestTier;
+			}
+		}
+
+		// Trace the choice back from the cheapest tier for the longest length.
+		std::vector<std::size_t> tierOf(lens.size());
+		std::size_t last(lens.size() - 1);
+		std::size_t tier(static_cast<std::size_t>(std::min_element(best[last].begin(),
+			best[last].end()) - best[last].begin()));
+		for (std::size_t k(last + 1); k-- > 0;) {
+			tierOf[k] = tier;
+			tier = from[k][tier];
+		}
+
+		// Lengths past the last one timed go to the last tier.
+		m_overrideLens.assign(numTiers - 1, longest + 1);
+		for (std::size_t t(0); t + 1 < numTiers; ++t) {
+			for (std::size_t k(0); k < lens.size(); ++k) {
+				if (tierOf[k] > t) {
+					m_overrideLens[t] = lens[k];
+					break;
+				}
+			}
+		}
+
+		// A tier cannot take products past its limit, even those between the lengths timed.
+		for (std::size_t t(numTiers - 1); t-- > 0;) {
+			m_overrideLens[t] = std::min(m_overrideLens[t], m_tiers[t].maxProdLen + 1);
+			if (t + 1 < numTiers - 1) {
+				m_overrideLens[t] = std::min(m_overrideLens[t], m_overrideLens[t + 1]);
+			}
+		}
+
+		m_haveOverrideLens = true;
+		m_timedLen = maxProdLen;
+		save();
+
+		return m_overrideLens;
+	}
+
+	// Private members.
+	std::size_t FlexTuner::getTimedLen(std::size_t maxProdLen)
+	{
+		return std::min(maxProdLen, MAX_PROD_LEN);
+	}
+
+	double FlexTuner::timeProduct(IMultiplicationStrategy &strategy, Memory::SafePtr<Digit> prod,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		auto run = [&](std::size_t reps) {
+			auto start(std::chrono::steady_clock::now());
+			for (std::size_t rep(0); rep < reps; ++rep) {
+				strategy.mulDigitsInto(prod, aLen + bLen, false, a, aLen, b, bLen);
+			}
+
+			std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - start);
+			return elapsed.count();
+		};
+
+		// Size the batches from one product, so each takes long enough to time.
+		double once(run(1));
+		std::size_t reps((once >= MIN_BATCH_TIME) ? 1 :
+			static_cast<std::size_t>(MIN_BATCH_TIME / std::max(once, 1e-9)) + 1);
+
+		double best(0.0);
+		for (std::size_t batch(0); batch < BATCH_RUNS; ++batch) {
+			double time(run(reps) / reps);
+			if ((batch == 0) || (time < best)) {
+				best = time;
+			}
+		}
+
+		return best;
+	}
+
+	// The file holds a version line, then one line for each set of tiers:
+	//
+	//    <key> <timedLen> <overrideLen> ...
+	void FlexTuner::load()
+	{
+		std::ifstream file(m_fileName);
+		std::string line;
+		if (!std::getline(file, line)) {
+			return;
+		}
+
+		std::istringstream header(line);
+		std::string magic;
+		int version(0);
+		if (!(header >> magic >> version) || (magic != "PIB26-mul-profile")
+			|| (version != VERSION)) {
+			return; // from another version; it will be overwritten
+		}
+
+		while (std::getline(file, line)) {
+			std::istringstream fields(line);
+			std::string key;
+			if (!(fields >> key)) {
+				continue;
+			}
+
+			if (key != m_key) {
+				m_otherLines.push_back(line);
+				continue;
+			}
+
+			std::size_t timedLen(0);
+			std::vector<std::size_t> overrideLens;
+			std::size_t len;
+			if (!(fields >> timedLen)) {
+				continue;
+			}
+
+			while (fields >> len) {
+				overrideLens.push_back(len);
+			}
+
+			// Take them only if they fit the tiers, as they would not if the limits had changed.
+			bool fits((overrideLens.size() + 1 == m_tiers.size()) &&
+				std::is_sorted(overrideLens.begin(), overrideLens.end()));
+			for (std::size_t t(0); fits && (t < overrideLens.size()); ++t) {
+				fits = (overrideLens[t] <= m_tiers[t].maxProdLen + 1);
+			}
+
+			if (fits) {
+				m_overrideLens = overrideLens;
+				m_haveOverrideLens = true;
+				m_timedLen = timedLen;
+			}
+		}
+	}
+
+	void FlexTuner::save() const
+	{
+		std::ofstream file(m_fileName);
+		file << "PIB26-mul-profile " << VERSION << std::endl;
+		for (const std::string &line : m_otherLines) {
+			file << line << std::endl;
+		}
+
+		if (m_haveOverrideLens) {
+			file << m_key << " " << m_timedLen;
+			for (std::size_t len : m_overrideLens) {
+				file << " " << len;
+			}
+
+			file << std::endl;
+		}
+	}
+}
@@ -0,0 +1,151 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      FlexTuner.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_FLEXTUNER_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_FLEXTUNER_HPP_
+
+#include "../IMultiplicationStrategy.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace SDF::Bignum::Multiplication
+{
+	// Class:      FlexTuner
+	// Purpose:    Finds the product lengths at which a FlexMulN should switch from each of its
+	//             strategies to the next on this machine, by timing them all, and keeps them in a
+	//             profile file so later runs need not time them again. The strategies are timed on
+	//             balanced and lopsided products over a sweep of lengths, and each length is given
+	//             to a tier so that the tiers come in order and the total time, relative to the
+	//             fastest at each length, is least. A tier may so end up with no lengths at all.
+	//             The crossovers are only good for the same tiers, thread count and caches, so
+	//             they are filed under a key made from those; the entries under other keys in the
+	//             file are kept as they are. The longest length timed is filed with them, and
+	//             they are timed again for a run with longer products.
+	// Parameters: None.
+	class FlexTuner
+	{
+		public:
+			// Structure: Tier
+			// Purpose:   A strategy to be combined, from the one for the shortest products to the
+			//            one for the longest.
+			struct Tier
+			{
+					std::string name; // names the tier in the profile; no spaces
+					IMultiplicationStrategy *strategy;
+					std::size_t maxProdLen; // the longest product it can take
+			};
+
+			// The file the profiles are kept in, in the working directory.
+			static constexpr const char *PROFILE_FILE = "PIB26-mul.profile";
+
+			// Function:  FlexTuner
+			// Purpose:   Construct a tuner for a set of tiers, loading whatever profile there is
+			//            for them on this machine.
+			// Arguments: fileName - The profile file. It need not exist yet.
+			//            tiers - The tiers.
+			//            numThreads - The number of threads the strategies run on.
+			FlexTuner(const std::string &fileName, const std::vector<Tier> &tiers,
+				std::size_t numThreads);
+
+			// Function:   getOverrideLens
+			// Purpose:    Get the crossovers, if they have been found for products as long as will
+			//             be timed for this run. Those found in a run with shorter products, which
+			//             gave everything past the lengths timed to the last tier, are not taken
+			//             if this run has products past both those lengths and the crossovers.
+			// Parameters: maxProdLen - The longest product there will be.
+			//             overrideLens - Receives the lengths at which to switch from each tier
+			//                            to the next, as FlexMulN takes them.
+			// Returns:    Whether there were any to take.
+			bool getOverrideLens(std::size_t maxProdLen, std::vector<std::size_t> &overrideLens)
+				const;
+
+			// Function:   calibrate
+			// Purpose:    Find the crossovers by timing the tiers, and save them.
+			// Parameters: maxProdLen - The longest product there will be. Those longer than the
+			//                          longest timed go to the last tier.
+			// Returns:    The lengths at which to switch from each tier to the next.
+			std::vector<std::size_t> calibrate(std::size_t maxProdLen);
+		private:
+			static constexpr int VERSION = 2;
+
+			// Shortest and longest products to time, and the number of lengths timed for each
+			// doubling. Past the longest, the transforms are taken to have won.
+			static constexpr std::size_t MIN_PROD_LEN = 4;
+			static constexpr std::size_t MAX_PROD_LEN = 65536;
+			static constexpr std::size_t STEPS_PER_OCTAVE = 4;
+
+			// How many times slower than a later tier a tier must be, at two lengths in a row,
+			// for it to be left out at all longer lengths.
+			static constexpr double DROP_FACTOR = 4.0;
+
+			// Shortest time to run a batch of products for, in seconds, and how many batches to
+			// take the best of.
+			static constexpr double MIN_BATCH_TIME = 0.0005;
+			static constexpr std::size_t BATCH_RUNS = 3;
+
+			std::vector<Tier> m_tiers;
+			std::string m_fileName;
+			std::string m_key;
+
+			bool m_haveOverrideLens;
+			std::vector<std::size_t> m_overrideLens;
+			std::size_t m_timedLen; // the longest product timed for them
+
+			std::vector<std::string> m_otherLines; // profiles under other keys
+
+			// Function:   getTimedLen
+			// Purpose:    Get the longest product to time for a run.
+			// Parameters: maxProdLen - The longest product there will be.
+			// Returns:    The length.
+			static std::size_t getTimedLen(std::size_t maxProdLen);
+
+			// Function:   timeProduct
+			// Purpose:    Time a strategy on one product, as the best of a few batches.
+			// Parameters: strategy - The strategy.
+			//             prod - A buffer for the product, at least aLen + bLen digits long.
+			//             a, aLen - The first factor and its length.
+			//             b, bLen - The second factor and its length.
+			// Returns:    The time for one product, in seconds.
+			static double timeProduct(IMultiplicationStrategy &strategy,
+				Memory::SafePtr<Digit> prod, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen);
+
+			// Function:   load
+			// Purpose:    Read the profile file, if there is one and it is of this version.
+			// Parameters: None.
+			// Returns:    None.
+			void load();
+
+			// Function:   save
+			// Purpose:    Write the profile file. Failing to is not an error: the crossovers will
+			//             just have to be found again next time.
+			// Parameters: None.
+			// Returns:    None.
+			void save() const;
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_FLEXTUNER_HPP_ */
@@ -0,0 +1,250 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      NTT.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "NTT.hpp"
+
+#include "../../exceptions/exceptions.hpp"
+
+#include "FFT/modular/genRootTable.hpp"
+#include "FFT/modular/nttItr.hpp"
+
+#include <iostream>
+
+namespace SDF::Bignum::Multiplication
+{
+	const std::uint64_t NTT::PRIMES[NTT::NUM_PRIMES] = {
+		0x7ffffe0000000001ULL, // 3 * 2^41 * 1398101 + 1
+		0x7fffe00000000001ULL, // 3^3 * 2^45 * 9709 + 1
+		0x7fff8c0000000001ULL  // 3 * 2^42 * 699041 + 1
+	};
+
+	const std::uint64_t NTT::PRIM_ROOTS[NTT::NUM_PRIMES] = { 7, 5, 10 };
+
+	NTT::NTT(std::size_t maxProdSize, Memory::Buffers::Local::ScratchPool *scratch)
+		: m_maxProdSize(maxProdSize), m_scratch(scratch)
+	{
+		// The largest element count of any product is the sum of those of the factors.
+		std::size_t maxElements((m_maxProdSize / DIGITS_PER_ELEMENT) + 2);
+
+		std::cout << "Preparing Number-Theoretic Transform root tables ..." << std::flush;
+
+		// As with the complex FFT, the root table size should contain 1 factor of 3.
+		std::size_t rootTableSize(3);
+		while (rootTableSize < maxElements) {
+			rootTableSize <<= 1;
+		}
+
+		for (std::size_t i(0); i < NUM_PRIMES; ++i) {
+			m_mods[i] = Fft::Modular::Montgomery(PRIMES[i]);
+			m_rootBuffers[i] = Fft::Modular::genRootTable(m_mods[i], PRIM_ROOTS[i], rootTableSize);
+			m_ntts[i] = std::make_unique<Fft::Modular::nttItr>(m_mods[i],
+				m_rootBuffers[i]->accessData(0), rootTableSize);
+		}
+
+		std::cout << " done!" << std::endl;
+
+		// Set up the CRT constants.
+		m_crtInvP0ModP1 = m_mods[1].toMont(m_mods[1].invPlain(PRIMES[0] % PRIMES[1]));
+		m_crtP0ModP2 = m_mods[2].toMont(PRIMES[0] % PRIMES[2]);
+		m_crtInvP0P1ModP2 = m_mods[2].toMont(m_mods[2].invPlain(m_mods[2].mulPlain(PRIMES[0] % PRIMES[2],
+			PRIMES[1] % PRIMES[2])));
+		m_crtP0P1 = static_cast<unsigned __int128>(PRIMES[0]) * PRIMES[1];
+	}
+
+	std::size_t NTT::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		if (aLen + bLen > m_maxProdSize) {
+			throw SDF::Exceptions::Exception("Requested NTT multiply of numbers that were too big :(");
+		}
+
+		return putProduct(*m_scratch, dst, dstLen, keepTop, aLen + bLen,
+			[&](Memory::SafePtr<Digit> prod) { mulCore(prod, a, aLen, b, bLen, false); });
+	}
+
+	std::size_t NTT::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
+	{
+		if ((aLen << 1) > m_maxProdSize) {
+			throw SDF::Exceptions::Exception("Requested NTT multiply of numbers that were too big :(");
+		}
+
+		return putProduct(*m_scratch, dst, dstLen, keepTop, aLen << 1,
+			[&](Memory::SafePtr<Digit> prod) { mulCore(prod, a, aLen, a, aLen, true); });
+	}
+
+	// Private members.
+	void NTT::mulCore(Memory::SafePtr<Digit> prod, Memory::SafePtr<Digit> a, std::size_t aLen,
+		Memory::SafePtr<Digit> b, std::size_t bLen, bool square)
+	{
+		// The transform is cyclic, so it must be at least as long as the element product. Unlike
+		// the complex FFT, there is no right-angle trick to halve the size here as the elements
+		// have no imaginary part to fold into.
+		std::size_t aElements((aLen + DIGITS_PER_ELEMENT - 1) / DIGITS_PER_ELEMENT);
+		std::size_t bElements((bLen + DIGITS_PER_ELEMENT - 1) / DIGITS_PER_ELEMENT);
+		std::size_t safeSize(m_ntts[0]->getNearestSafeLengthTo(aElements + bElements));
+
+		// A residue buffer for each prime, one after the other, and one for the second factor,
+		// which a square can do without.
+		auto residues(m_scratch->borrow<std::uint64_t>(NUM_PRIMES * safeSize));
+		auto tmp(m_scratch->borrow<std::uint64_t>(square ? 0 : safeSize));
+		Memory::SafePtr<std::uint64_t> tmpBufPtr(tmp.accessData(0));
+
+		// The inputs are smaller than every prime, so the same loaded data serves for each one. We
+		// work one prime at a time, keeping only the pointwise products. A square saves a
+		// transform per prime.
+		for (std::size_t i(0); i < NUM_PRIMES; ++i) {
+			Memory::SafePtr<std::uint64_t> resBufPtr(residues.accessData(i * safeSize));
+
+			loadBuffer(resBufPtr, safeSize, a, aLen);
+			m_ntts[i]->doFwdTransform(resBufPtr, safeSize);
+
+			if (square) {
+				convolute(resBufPtr, resBufPtr, safeSize, i);
+			} else {
+				loadBuffer(tmpBufPtr, safeSize, b, bLen);
+				m_ntts[i]->doFwdTransform(tmpBufPtr, safeSize);
+				convolute(resBufPtr, tmpBufPtr, safeSize, i);
+			}
+
+			m_ntts[i]->doRevTransform(resBufPtr, safeSize);
+		}
+
+		recombine(prod, aLen + bLen, residues.accessData(0), safeSize);
+	}
+
+	void NTT::loadBuffer(Memory::SafePtr<std::uint64_t> nttBuffer, std::size_t bufferLen,
+		Memory::SafePtr<Digit> num, std::size_t numLen)
+	{
+		// Pack DIGITS_PER_ELEMENT digits into each element. BASE^3 < 2^57, so the elements are
+		// already reduced modulo every one of the primes.
+		std::size_t outBufIdx(0);
+		std::size_t i(0);
+
+		for (; i + DIGITS_PER_ELEMENT <= numLen; i += DIGITS_PER_ELEMENT, ++outBufIdx) {
+			nttBuffer[outBufIdx] = static_cast<std::uint64_t>(num[i])
+				+ BASE * (static_cast<std::uint64_t>(num[i + 1])
+					+ BASE * static_cast<std::uint64_t>(num[i + 2]));
+		}
+
+		// Finish off any remainder.
+		if (i < numLen) {
+			std::uint64_t element(0);
+			for (std::size_t j(numLen); j > i; --j) {
+				element = element * BASE + static_cast<std::uint64_t>(num[j - 1]);
+			}
+
+			nttBuffer[outBufIdx++] = element;
+		}
+
+		for (; outBufIdx < bufferLen; ++outBufIdx) {
+			nttBuffer[outBufIdx] = 0;
+		}
+	}
+
+	void NTT::convolute(Memory::SafePtr<std::uint64_t> nttBuffer1,
+		Memory::SafePtr<std::uint64_t> nttBuffer2, std::size_t bufferLen, std::size_t prime)
+	{
+		const Fft::Modular::Montgomery &mod(m_mods[prime]);
+
+		// The pointwise Montgomery product leaves a factor of 2^(-64) on each element, and the
+		// unnormalized reverse transform a factor of bufferLen. We cancel both at once here by a
+		// further Montgomery multiplication by 2^128 / bufferLen.
+		std::uint64_t r(mod.powPlain(2, 64));
+		std::uint64_t scale(mod.mulPlain(mod.mulPlain(r, r), mod.invPlain(bufferLen % PRIMES[prime])));
+
+		for (std::size_t i(0); i < bufferLen; ++i) {
+			nttBuffer1[i] = mod.mul(mod.mul(nttBuffer1[i], nttBuffer2[i]), scale);
+		}
+	}
+
+	void NTT::recombine(Memory::SafePtr<Digit> digitBuffer, std::size_t digitsToGet,
+		Memory::SafePtr<const std::uint64_t> residues, std::size_t nttSize)
+	{
+		static const std::uint64_t c_base3(static_cast<std::uint64_t>(BASE) * BASE * BASE);
+
+		Memory::SafePtr<const std::uint64_t> res0Ptr(residues);
+		Memory::SafePtr<const std::uint64_t> res1Ptr(residues + nttSize);
+		Memory::SafePtr<const std::uint64_t> res2Ptr(residues + 2 * nttSize);
+
+		// The carry can exceed 128 bits in principle, so we hold it and each recombined element as
+		// 3 64-bit words, least significant first.
+		std::uint64_t carry[3] = { 0, 0, 0 };
+		std::size_t outBufIdx(0);
+
+		for (std::size_t k(0); (k < nttSize) && (outBufIdx < digitsToGet); ++k) {
+			// Garner's form of the CRT: with r_i the residue mod p_i, the element is
+			//
+			//        x = r_0 + p_0 v_1 + p_0 p_1 v_2, where
+			//        v_1 = (r_1 - r_0) / p_0 mod p_1, and
+			//        v_2 = (r_2 - (r_0 + p_0 v_1)) / (p_0 p_1) mod p_2.
+			//
+			// p_0 > p_1, p_2, so reducing r_0 takes at most one subtraction.
+			std::uint64_t r0(res0Ptr[k]);
+			std::uint64_t r0ModP1((r0 >= PRIMES[1]) ? (r0 - PRIMES[1]) : r0);
+			std::uint64_t r0ModP2((r0 >= PRIMES[2]) ? (r0 - PRIMES[2]) : r0);
+
+			std::uint64_t v1(m_mods[1].mul(m_mods[1].sub(res1Ptr[k], r0ModP1), m_crtInvP0ModP1));
+			std::uint64_t partialModP2(m_mods[2].add(r0ModP2, m_mods[2].mul(v1, m_crtP0ModP2)));
+			std::uint64_t v2(m_mods[2].mul(m_mods[2].sub(res2Ptr[k], partialModP2),
+				m_crtInvP0P1ModP2));
+
+			unsigned __int128 partial(static_cast<unsigned __int128>(PRIMES[0]) * v1 + r0);
+			unsigned __int128 topLo(static_cast<unsigned __int128>(static_cast<std::uint64_t>(m_crtP0P1))
+				* v2);
+			unsigned __int128 topHi(static_cast<unsigned __int128>(static_cast<std::uint64_t>(m_crtP0P1
+				>> 64)) * v2);
+
+			// Sum the pieces and the carry, word by word.
+			unsigned __int128 acc(static_cast<unsigned __int128>(static_cast<std::uint64_t>(partial))
+				+ static_cast<std::uint64_t>(topLo) + carry[0]);
+			std::uint64_t x[3];
+			x[0] = static_cast<std::uint64_t>(acc);
+
+			acc = (acc >> 64) + static_cast<std::uint64_t>(partial >> 64)
+				+ static_cast<std::uint64_t>(topLo >> 64) + static_cast<std::uint64_t>(topHi) + carry[1];
+			x[1] = static_cast<std::uint64_t>(acc);
+
+			acc = (acc >> 64) + static_cast<std::uint64_t>(topHi >> 64) + carry[2];
+			x[2] = static_cast<std::uint64_t>(acc);
+
+			// Release carries: divide by BASE^3, most significant word first.
+			std::uint64_t rem(0);
+			for (std::size_t w(3); w > 0; --w) {
+				unsigned __int128 cur((static_cast<unsigned __int128>(rem) << 64) | x[w - 1]);
+				carry[w - 1] = static_cast<std::uint64_t>(cur / c_base3);
+				rem = static_cast<std::uint64_t>(cur % c_base3);
+			}
+
+			for (std::size_t d(0); (d < DIGITS_PER_ELEMENT) && (outBufIdx < digitsToGet); ++d) {
+				digitBuffer[outBufIdx++] = rem % BASE;
+				rem /= BASE;
+			}
+		}
+
+		for (; outBufIdx < digitsToGet; ++outBufIdx) {
+			digitBuffer[outBufIdx] = 0;
+		}
+	}
+}
@@ -0,0 +1,100 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      NTT.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_NTT_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_NTT_HPP_
+
+#include "../IMultiplicationStrategy.hpp"
+
+#include "../../memory/buffers/local/ScratchPool.hpp"
+
+#include "FFT/modular/Montgomery.hpp"
+#include "FFT/modular/ModularFft.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace SDF::Bignum::Multiplication
+{
+	// Class:      NTT
+	// Purpose:    Performs a multiplication using number-theoretic transforms (NTTs), i.e. FFTs over
+	//             finite fields Z/pZ. Unlike the complex FFT, these are exact, so there is no
+	//             rounding error to limit how many digits can be packed into each element - instead
+	//             the limit is the size of the modulus. We transform over three primes just under
+	//             2^63 and recombine the results with the Chinese remainder theorem (CRT), which
+	//             gives us an effective modulus of about 189 bits. That is enough to pack 3 full
+	//             base-BASE digits into each element at any size we could ever hope to reach, whereas
+	//             the complex FFT has to drop to half a digit per element for large products.
+	// Parameters: None.
+	class NTT : public IMultiplicationStrategy
+	{
+		public:
+			// Function:  NTT
+			// Purpose:   Construct a new strategy object with a given maximum buffer size.
+			// Arguments: maxProdSize - The maximum multiplication size to allow.
+			//            scratch - The pool to borrow scratch space from, shared with the other
+			//                      strategies.
+			NTT(std::size_t maxProdSize, Memory::Buffers::Local::ScratchPool *scratch);
+
+			std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+			std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen);
+		private:
+			static const std::size_t NUM_PRIMES = 3;
+			static const std::size_t DIGITS_PER_ELEMENT = 3;
+
+			// The primes, and primitive roots mod each. All are of the form k * 3 * 2^n + 1 with
+			// n >= 41, so they support transforms of any length 2^m or 3 * 2^m we could need.
+			static const std::uint64_t PRIMES[NUM_PRIMES];
+			static const std::uint64_t PRIM_ROOTS[NUM_PRIMES];
+
+			// The arithmetic and transform for each prime.
+			Fft::Modular::Montgomery m_mods[NUM_PRIMES];
+			std::unique_ptr<Memory::ILocalBuffer<std::uint64_t>> m_rootBuffers[NUM_PRIMES];
+			std::unique_ptr<Fft::Modular::ModularFft> m_ntts[NUM_PRIMES];
+
+			// CRT constants (see recombine).
+			std::uint64_t m_crtInvP0ModP1;   // p0^(-1) mod p1, Montgomery form
+			std::uint64_t m_crtP0ModP2;      // p0 mod p2, Montgomery form
+			std::uint64_t m_crtInvP0P1ModP2; // (p0 p1)^(-1) mod p2, Montgomery form
+			unsigned __int128 m_crtP0P1;      // p0 p1
+
+			std::size_t m_maxProdSize;
+
+			Memory::Buffers::Local::ScratchPool *m_scratch;
+
+			void mulCore(Memory::SafePtr<Digit> prod, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen, bool square);
+			void loadBuffer(Memory::SafePtr<std::uint64_t> nttBuffer, std::size_t bufferLen,
+				Memory::SafePtr<Digit> num, std::size_t numLen);
+			void convolute(Memory::SafePtr<std::uint64_t> nttBuffer1,
+				Memory::SafePtr<std::uint64_t> nttBuffer2, std::size_t bufferLen, std::size_t prime);
+			void recombine(Memory::SafePtr<Digit> digitBuffer, std::size_t digitsToGet,
+				Memory::SafePtr<const std::uint64_t> residues, std::size_t nttSize);
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_NTT_HPP_ */
@@ -0,0 +1,499 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      SSA.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "SSA.hpp"
+
+#include "../../exceptions/exceptions.hpp"
+
+#include "../primitives/add.hpp"
+#include "../primitives/assign.hpp"
+#include "../primitives/divsm.hpp"
+#include "../primitives/sub.hpp"
+
+#include <algorithm>
+
+namespace SDF::Bignum::Multiplication
+{
+	const std::size_t SSA::DEFAULT_CROSSOVER;
+
+	SSA::SSA(IMultiplicationStrategy *baseStrategy, std::size_t crossover, std::size_t maxProdSize,
+		Memory::Buffers::Local::ScratchPool *scratch)
+		: m_baseStrategy(baseStrategy), m_crossover(crossover), m_maxProdSize(maxProdSize),
+		  m_scratch(scratch)
+	{
+	}
+
+	std::size_t SSA::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+		Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		if (aLen + bLen > m_maxProdSize) {
+			throw SDF::Exceptions::Exception("Requested SSA multiply of numbers that were too big :(");
+		}
+
+		std::size_t prodSize(aLen + bLen);
+		if (prodSize < m_crossover) {
+			return m_baseStrategy->mulDigitsInto(dst, dstLen, keepTop, a, aLen, b, bLen);
+		}
+
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodSize,
+			[&](Memory::SafePtr<Digit> prod) { mulTop(prod, a, aLen, b, bLen, false); });
+	}
+
+	std::size_t SSA::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
+	{
+		if ((aLen << 1) > m_maxProdSize) {
+			throw SDF::Exceptions::Exception("Requested SSA multiply of numbers that were too big :(");
+		}
+
+		std::size_t prodSize(aLen << 1);
+		if (prodSize < m_crossover) {
+			return m_baseStrategy->squareDigitsInto(dst, dstLen, keepTop, a, aLen);
+		}
+
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodSize,
+			[&](Memory::SafePtr<Digit> prod) { mulTop(prod, a, aLen, a, aLen, true); });
+	}
+
+	// Private members.
+	std::size_t SSA::chooseSplit(std::size_t ringSize) const
+	{
+		// Split into about sqrt(K) pieces, which balances the transform length against the size of
+		// the pointwise products.
+		std::size_t numPieces(1);
+		while (numPieces * numPieces < ringSize) {
+			numPieces <<= 1;
+		}
+
+		return numPieces;
+	}
+
+	std::size_t SSA::chooseRingSize(std::size_t minRingSize, std::size_t multipleOf) const
+	{
+		// Get the smallest K >= minRingSize that is a multiple of multipleOf and, if we will be
+		// transforming in it, of the number of pieces it is to be split into. Rings we hand off to
+		// the base strategy need no splitting.
+		std::size_t ringSize(((minRingSize + multipleOf - 1) / multipleOf) * multipleOf);
+		while (2 * ringSize >= m_crossover) {
+			std::size_t numPieces(chooseSplit(ringSize));
+			if (ringSize % numPieces == 0) {
+				break;
+			}
+
+			ringSize = ((ringSize + numPieces - 1) / numPieces) * numPieces;
+		}
+
+		return ringSize;
+	}
+
+	void SSA::normalize(Memory::SafePtr<Digit> x, std::size_t ringSize)
+	{
+		// Fold the top digit back down using BASE^K == -1.
+		Digit top(x[ringSize]);
+		if (top == 0) {
+			return;
+		}
+
+		x[ringSize] = 0;
+
+		Digit tmp(x[0] - top);
+		if (tmp >= 0) {
+			x[0] = tmp;
+		} else {
+			x[0] = tmp + BASE;
+
+			// Propagate the borrow only as far as it goes.
+			std::size_t i(1);
+			for (; (i <= ringSize) && (x[i] == 0); ++i) {
+				x[i] = BASE - 1;
+			}
+
+			if (i <= ringSize) {
+				--x[i];
+			} else {
+				fixBorrow(x, ringSize);
+			}
+		}
+	}
+
+	void SSA::fixBorrow(Memory::SafePtr<Digit> x, std::size_t ringSize)
+	{
+		// Given a result v in [-BASE^K, -1] that borrowed out of the top digit, i.e. is held as
+		// BASE^(K+1) + v, add in the modulus BASE^K + 1 and drop the borrow to get it into range.
+		Digit carry(1);
+		for (std::size_t i(0); carry && (i < ringSize); ++i) {
+			if (++x[i] == static_cast<Digit>(BASE)) {
+				x[i] = 0;
+			} else {
+				carry = 0;
+			}
+		}
+
+		x[ringSize] += 1 + carry - BASE;
+	}
+
+	void SSA::accumulate(Memory::SafePtr<Digit> acc, std::size_t accLen, Memory::SafePtr<Digit> src,
+		std::size_t srcLen)
+	{
+		// Add src into acc, propagating the carry only as far as it goes.
+		Digit carry(Primitives::add(acc, acc, src, srcLen, 0));
+		for (std::size_t i(srcLen); carry && (i < accLen); ++i) {
+			if (++acc[i] == static_cast<Digit>(BASE)) {
+				acc[i] = 0;
+			} else {
+				carry = 0;
+			}
+		}
+	}
+
+	void SSA::subMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, Memory::SafePtr<Digit> b,
+		std::size_t ringSize)
+	{
+		if (Primitives::sub(r, a, b, ringSize + 1, 0)) {
+			fixBorrow(r, ringSize);
+		}
+	}
+
+	void SSA::addSubMod(Memory::SafePtr<Digit> sum, Memory::SafePtr<Digit> diff,
+		Memory::SafePtr<Digit> a, Memory::SafePtr<Digit> b, std::size_t ringSize)
+	{
+		// The transform butterfly: a + b and a - b in one pass over the digits. sum may alias a,
+		// and diff b, but not the other way around.
+		Digit carry(0);
+		Digit borrow(0);
+		for (std::size_t i(0); i <= ringSize; ++i) {
+			Digit aDig(a[i]);
+			Digit bDig(b[i]);
+
+			Digit sumDig(aDig + bDig + carry);
+			carry = (sumDig >= static_cast<Digit>(BASE));
+			sum[i] = sumDig - carry * BASE;
+
+			Digit diffDig(aDig - bDig - borrow);
+			borrow = (diffDig < 0);
+			diff[i] = diffDig + borrow * BASE;
+		}
+
+		normalize(sum, ringSize);
+		if (borrow) {
+			fixBorrow(diff, ringSize);
+		}
+	}
+
+	void SSA::negMod(Memory::SafePtr<Digit> x, std::size_t ringSize)
+	{
+		if (Primitives::neg(x, x, 0, ringSize + 1)) {
+			fixBorrow(x, ringSize);
+		}
+	}
+
+	void SSA::shiftMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t shift,
+		std::size_t ringSize)
+	{
+		// Multiply by BASE^shift. This is our root-of-unity multiplication: BASE^K == -1, so a
+		// shift by K or more is a negation plus a shift by less than K, and the digits shifted out
+		// the top come back in at the bottom negated. NB: r and a must not overlap.
+		bool negate(shift >= ringSize);
+		if (negate) {
+			shift -= ringSize;
+		}
+
+		if (a[ringSize] != 0) {
+			// a == BASE^K == -1.
+			Primitives::zeroize(r, ringSize + 1);
+			r[shift] = 1;
+			negate = !negate;
+		} else {
+			Digit borrow(Primitives::neg(r, a + (ringSize - shift), 0, shift));
+			borrow = Primitives::propagateBorrow(r + shift, a, borrow, ringSize - shift);
+
+			r[ringSize] = 0;
+			if (borrow) {
+				r[ringSize] = BASE - 1;
+				fixBorrow(r, ringSize);
+			}
+		}
+
+		if (negate) {
+			negMod(r, ringSize);
+		}
+	}
+
+	void SSA::halveMod(Memory::SafePtr<Digit> x, std::size_t log2Divisor, std::size_t ringSize)
+	{
+		// Divide by 2^log2Divisor. BASE is divisible by 16, so the modulus is odd and 2 is
+		// invertible. Moreover the modulus is 1 mod 16, so we can divide out up to 4 factors of 2
+		// at a time by first adding the multiple of the modulus that makes x divisible by them
+		// exactly. This multiple is determined by the lowest digit of x alone.
+		while (log2Divisor > 0) {
+			std::size_t numBits(std::min<std::size_t>(log2Divisor, 4));
+			Digit mask((1 << numBits) - 1);
+			Digit adjust((-x[0]) & mask);
+
+			if (adjust != 0) {
+				x[0] += adjust;
+				for (std::size_t i(0); x[i] >= static_cast<Digit>(BASE); ++i) {
+					x[i] -= BASE;
+					++x[i + 1];
+				}
+
+				x[ringSize] += adjust;
+			}
+
+			Primitives::divBySmall(x, x, 1 << numBits, ringSize + 1, 0);
+			log2Divisor -= numBits;
+		}
+	}
+
+	void SSA::reduceMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> src, std::size_t srcLen,
+		std::size_t ringSize)
+	{
+		// Reduce a number of up to 2K digits using BASE^K == -1, i.e. low half minus high half.
+		std::size_t loLen(std::min(srcLen, ringSize));
+		Primitives::copy(r, src, loLen);
+		Primitives::zeroize(r + loLen, ringSize + 1 - loLen);
+
+		if (srcLen > ringSize) {
+			std::size_t hiLen(srcLen - ringSize);
+			Digit borrow(Primitives::sub(r, r, src + ringSize, hiLen, 0));
+			if (Primitives::propagateBorrow(r + hiLen, r + hiLen, borrow, ringSize + 1 - hiLen)) {
+				fixBorrow(r, ringSize);
+			}
+		}
+	}
+
+	void SSA::fwdTransform(Memory::SafePtr<Digit> data, std::size_t len, std::size_t ringSize,
+		Memory::SafePtr<Digit> tmp)
+	{
+		// Radix-2 decimation in frequency, as in rad2Rec, but with omega = BASE^(2K/len) so that
+		// all the root multiplications are shifts.
+		std::size_t elementSize(ringSize + 1);
+		std::size_t unitShift((2 * ringSize) / len);
+
+		for (std::size_t step(len); step >= 2; step >>= 1) {
+			std::size_t half(step >> 1);
+			std::size_t shiftStep(unitShift * (len / step));
+
+			for (std::size_t chunk(0); chunk < len; chunk += step) {
+				for (std::size_t n(0); n < half; ++n) {
+					Memory::SafePtr<Digit> x(data + (chunk + n) * elementSize);
+					Memory::SafePtr<Digit> y(x + half * elementSize);
+
+					addSubMod(x, tmp, x, y, ringSize);
+					shiftMod(y, tmp, n * shiftStep, ringSize);
+				}
+			}
+		}
+	}
+
+	void SSA::revTransform(Memory::SafePtr<Digit> data, std::size_t len, std::size_t ringSize,
+		Memory::SafePtr<Digit> tmp)
+	{
+		// Radix-2 decimation in time with the inverse roots BASE^(-j) = BASE^(2K - j). Like the
+		// other transforms, the result is left multiplied by len.
+		std::size_t elementSize(ringSize + 1);
+		std::size_t unitShift((2 * ringSize) / len);
+
+		for (std::size_t step(2); step <= len; step <<= 1) {
+			std::size_t half(step >> 1);
+			std::size_t shiftStep(unitShift * (len / step));
+
+			for (std::size_t chunk(0); chunk < len; chunk += step) {
+				for (std::size_t k(0); k < half; ++k) {
+					Memory::SafePtr<Digit> x(data + (chunk + k) * elementSize);
+					Memory::SafePtr<Digit> y(x + half * elementSize);
+
+					shiftMod(tmp, y, (2 * ringSize - k * shiftStep) % (2 * ringSize), ringSize);
+					addSubMod(x, y, x, tmp, ringSize);
+				}
+			}
+		}
+	}
+
+	void SSA::mulTop(Memory::SafePtr<Digit> prod, Memory::SafePtr<Digit> a, std::size_t aLen,
+		Memory::SafePtr<Digit> b, std::size_t bLen, bool square)
+	{
+		// Modulo BASE^K + 1 for K >= the product length, the modular product *is* the product. The
+		// residue takes K + 1 digits, more than the product, so it is got elsewhere and copied.
+		std::size_t prodSize(aLen + bLen);
+		std::size_t ringSize(chooseRingSize(prodSize, 1));
+
+		auto residue(m_scratch->borrow<Digit>(ringSize + 1));
+		mulMod(residue.accessData(0), a, aLen, b, bLen, ringSize, square);
+		Primitives::copy(prod, residue.accessData(0), prodSize);
+	}
+
+	void SSA::mulMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+		Memory::SafePtr<Digit> b, std::size_t bLen, std::size_t ringSize, bool square)
+	{
+		// Compute a * b mod BASE^K + 1 into r, which must have room for K + 1 digits and may alias
+		// a or b. The factors may be up to K + 1 digits long, but must be normalized.
+		if ((aLen > ringSize) && (a[ringSize] != 0)) {
+			// a == -1
+			Primitives::copy(r, b, std::min(bLen, ringSize + 1));
+			Primitives::zeroize(r + std::min(bLen, ringSize + 1), ringSize + 1 - std::min(bLen,
+				ringSize + 1));
+			negMod(r, ringSize);
+			return;
+		} else if ((bLen > ringSize) && (b[ringSize] != 0)) {
+			// b == -1
+			Primitives::copy(r, a, std::min(aLen, ringSize + 1));
+			Primitives::zeroize(r + std::min(aLen, ringSize + 1), ringSize + 1 - std::min(aLen,
+				ringSize + 1));
+			negMod(r, ringSize);
+			return;
+		}
+
+		aLen = std::min(aLen, ringSize);
+		bLen = std::min(bLen, ringSize);
+
+		if (2 * ringSize < m_crossover) {
+			baseMulMod(r, a, aLen, b, bLen, ringSize, square);
+			return;
+		}
+
+		// Split the factors into numPieces pieces of pieceSize digits each:
+		//
+		//        a = sum_i a_i BASE^(i * pieceSize).
+		//
+		// BASE^(numPieces * pieceSize) = BASE^K == -1, so the product we want is the negacyclic
+		// convolution of the pieces. We get this using a transform of length numPieces with the
+		// pieces weighted by powers of a 2*numPieces-th root of unity, theta, just like the
+		// right-angle convolution in the complex FFT. Each coefficient of the product is bounded in
+		// absolute value by numPieces * BASE^(2 * pieceSize), so we pick the ring for the transform
+		// large enough to hold twice that (to be able to tell the sign).
+		std::size_t numPieces(chooseSplit(ringSize));
+		std::size_t log2NumPieces(0);
+		while ((static_cast<std::size_t>(1) << log2NumPieces) < numPieces) {
+			++log2NumPieces;
+		}
+
+		std::size_t pieceSize(ringSize / numPieces);
+
+		std::size_t signDigits(0);
+		for (std::size_t bound(1); bound < 2 * numPieces; bound *= BASE) {
+			++signDigits;
+		}
+
+		std::size_t subRingSize(chooseRingSize(2 * pieceSize + signDigits + 1, numPieces));
+		if (subRingSize >= ringSize) {
+			// Only possible for tiny rings (i.e. a tiny crossover), where splitting doesn't pay.
+			baseMulMod(r, a, aLen, b, bLen, ringSize, square);
+			return;
+		}
+
+		std::size_t elementSize(subRingSize + 1);
+		std::size_t thetaShift(subRingSize / numPieces);
+		std::size_t accLen(ringSize + elementSize);
+
+		// Lay out the scratch space for this level.
+		std::size_t transformBufSize(numPieces * elementSize);
+		auto scratchLease(m_scratch->borrow<Digit>((square ? 1 : 2) * transformBufSize + elementSize
+			+ (ringSize + 1) + 2 * accLen));
+		Memory::SafePtr<Digit> scratch(scratchLease.accessData(0));
+
+		Memory::SafePtr<Digit> aBuf(scratch);
+		Memory::SafePtr<Digit> bBuf(square ? aBuf : (aBuf + transformBufSize));
+		Memory::SafePtr<Digit> tmp(bBuf + transformBufSize);
+		Memory::SafePtr<Digit> negReduced(tmp + elementSize);
+		Memory::SafePtr<Digit> posAcc(negReduced + (ringSize + 1));
+		Memory::SafePtr<Digit> negAcc(posAcc + accLen);
+
+		// Load and weight the pieces.
+		for (std::size_t i(0); i < numPieces; ++i) {
+			std::size_t start(i * pieceSize);
+
+			std::size_t aPieceLen(0);
+			if (start < aLen) {
+				aPieceLen = std::min(pieceSize, aLen - start);
+				Primitives::copy(tmp, a + start, aPieceLen);
+			}
+
+			Primitives::zeroize(tmp + aPieceLen, elementSize - aPieceLen);
+			shiftMod(aBuf + i * elementSize, tmp, i * thetaShift, subRingSize);
+
+			if (!square) {
+				std::size_t bPieceLen(0);
+				if (start < bLen) {
+					bPieceLen = std::min(pieceSize, bLen - start);
+					Primitives::copy(tmp, b + start, bPieceLen);
+				}
+
+				Primitives::zeroize(tmp + bPieceLen, elementSize - bPieceLen);
+				shiftMod(bBuf + i * elementSize, tmp, i * thetaShift, subRingSize);
+			}
+		}
+
+		// Do the transform multiplication itself, recursing for the pointwise products.
+		fwdTransform(aBuf, numPieces, subRingSize, tmp);
+		if (!square) {
+			fwdTransform(bBuf, numPieces, subRingSize, tmp);
+		}
+
+		for (std::size_t i(0); i < numPieces; ++i) {
+			mulMod(aBuf + i * elementSize, aBuf + i * elementSize, elementSize, bBuf + i * elementSize,
+				elementSize, subRingSize, square);
+		}
+
+		revTransform(aBuf, numPieces, subRingSize, tmp);
+
+		// Unweight, normalize and recover the signs of the coefficients, then sum them up. We keep
+		// separate sums for the positive and negative ones so as to only ever have to add.
+		Primitives::zeroize(posAcc, accLen);
+		Primitives::zeroize(negAcc, accLen);
+
+		for (std::size_t i(0); i < numPieces; ++i) {
+			shiftMod(tmp, aBuf + i * elementSize, (2 * subRingSize - i * thetaShift) % (2
+				* subRingSize), subRingSize);
+			halveMod(tmp, log2NumPieces, subRingSize);
+
+			if ((tmp[subRingSize] != 0) || (tmp[subRingSize - 1] >= static_cast<Digit>(BASE / 2))) {
+				negMod(tmp, subRingSize);
+				accumulate(negAcc + i * pieceSize, accLen - i * pieceSize, tmp, elementSize);
+			} else {
+				accumulate(posAcc + i * pieceSize, accLen - i * pieceSize, tmp, elementSize);
+			}
+		}
+
+		reduceMod(r, posAcc, accLen, ringSize);
+		reduceMod(negReduced, negAcc, accLen, ringSize);
+		subMod(r, r, negReduced, ringSize);
+	}
+
+	void SSA::baseMulMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+		Memory::SafePtr<Digit> b, std::size_t bLen, std::size_t ringSize, bool square)
+	{
+		// r may alias a or b, so the product is got elsewhere and reduced into r.
+		auto prod(m_scratch->borrow<Digit>(aLen + bLen));
+
+		if (square) {
+			m_baseStrategy->squareDigitsInto(prod.accessData(0), aLen + bLen, false, a, aLen);
+		} else {
+			m_baseStrategy->mulDigitsInto(prod.accessData(0), aLen + bLen, false, a, aLen, b,
+				bLen);
+		}
+
+		reduceMod(r, prod.accessData(0), aLen + bLen, ringSize);
+	}
+}
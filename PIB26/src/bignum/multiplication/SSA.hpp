@@ -0,0 +1,126 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      SSA.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_SSA_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_SSA_HPP_
+
+#include "../IMultiplicationStrategy.hpp"
+
+#include "../../memory/buffers/local/ScratchPool.hpp"
+
+
+namespace SDF::Bignum::Multiplication
+{
+	// Class:      SSA
+	// Purpose:    Performs a multiplication using the Schonhage-Strassen method, i.e. FFTs over the
+	//             rings Z/(BASE^K + 1). In these rings BASE itself is a 2K-th root of unity, so all
+	//             the "twiddle" multiplications in the transform are just (negacyclic) digit shifts
+	//             and the whole transform is exact and carried out in plain bignum arithmetic. The
+	//             pointwise products are again products modulo BASE^K' + 1, which we compute by
+	//             recursing into the method until they are small enough to hand off to another
+	//             strategy (normally the complex FFT). Since the pointwise products are a good deal
+	//             smaller than the product as a whole, that strategy can keep packing its elements
+	//             densely no matter how big the product gets.
+	//
+	//             NB: the classical formulation works modulo 2^N + 1; we use BASE^K + 1 instead so
+	//             as not to have to convert out of our base-BASE digit representation.
+	// Parameters: None.
+	class SSA : public IMultiplicationStrategy
+	{
+		public:
+			// Crossover product length, in digits, below which we do not bother with SSA at all and
+			// just pass the product straight through to the base strategy. This is a guess, not a
+			// measured crossover: over complex FFT base multiplies, SSA measured 5-10x slower than
+			// the FFT alone for products of 2^16 to 2^22 digits, whatever its own crossover, so it
+			// never wins on speed in the range we can measure. Nor could a point be measured where
+			// the FFT fails: on random factors its largest round-off error came to 0.11 at 2^23
+			// digits of product at 4 base-BASE_MINOR digits per element, which scales to 2.4e-7 at
+			// 2 per element (cf. FFT::predictRoundOff), growing about 1.5x each time the product
+			// doubles, so it would not reach the retry point (FFT::ROUNDOFF_RETRY) in any
+			// addressable length. 2^28 digits, about a billion base-BASE_MINOR digits, is where we
+			// would rather not lean on the FFT's error bounds for numbers that are not random.
+			static const std::size_t DEFAULT_CROSSOVER = 268435456;
+
+			// Function:  SSA
+			// Purpose:   Construct a new strategy object with a given maximum buffer size.
+			// Arguments: baseStrategy - The strategy to use for small and pointwise products. Must be
+			//                           able to handle products up to crossover digits long.
+			//            crossover - The product length at which to switch to SSA from the base
+			//                        strategy. Pointwise products are also handed off to the base
+			//                        strategy once they fall below this length.
+			//            maxProdSize - The maximum multiplication size to allow.
+			//            scratch - The pool to borrow scratch space from, shared with the other
+			//                      strategies.
+			SSA(IMultiplicationStrategy *baseStrategy, std::size_t crossover, std::size_t maxProdSize,
+				Memory::Buffers::Local::ScratchPool *scratch);
+
+			std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+			std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen);
+		private:
+			IMultiplicationStrategy *m_baseStrategy;
+			std::size_t m_crossover;
+			std::size_t m_maxProdSize;
+
+			// Scratch space for each level of recursion.
+			Memory::Buffers::Local::ScratchPool *m_scratch;
+
+			// Ring size selection.
+			std::size_t chooseSplit(std::size_t ringSize) const;
+			std::size_t chooseRingSize(std::size_t minRingSize, std::size_t multipleOf) const;
+
+			// Arithmetic modulo BASE^K + 1. Residues are held in K + 1 digits and kept normalized
+			// to [0, BASE^K].
+			void normalize(Memory::SafePtr<Digit> x, std::size_t ringSize);
+			void fixBorrow(Memory::SafePtr<Digit> x, std::size_t ringSize);
+			void subMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, Memory::SafePtr<Digit> b,
+				std::size_t ringSize);
+			void addSubMod(Memory::SafePtr<Digit> sum, Memory::SafePtr<Digit> diff,
+				Memory::SafePtr<Digit> a, Memory::SafePtr<Digit> b, std::size_t ringSize);
+			void negMod(Memory::SafePtr<Digit> x, std::size_t ringSize);
+			void shiftMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t shift,
+				std::size_t ringSize);
+			void halveMod(Memory::SafePtr<Digit> x, std::size_t log2Divisor, std::size_t ringSize);
+			void accumulate(Memory::SafePtr<Digit> acc, std::size_t accLen, Memory::SafePtr<Digit> src,
+				std::size_t srcLen);
+			void reduceMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> src, std::size_t srcLen,
+				std::size_t ringSize);
+
+			void fwdTransform(Memory::SafePtr<Digit> data, std::size_t len, std::size_t ringSize,
+				Memory::SafePtr<Digit> tmp);
+			void revTransform(Memory::SafePtr<Digit> data, std::size_t len, std::size_t ringSize,
+				Memory::SafePtr<Digit> tmp);
+
+			void mulTop(Memory::SafePtr<Digit> prod, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen, bool square);
+			void mulMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen, std::size_t ringSize, bool square);
+			void baseMulMod(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen, std::size_t ringSize, bool square);
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_SSA_HPP_ */
@@ -27,26 +27,26 @@
 #include "../primitives/assign.hpp"
 #include "../primitives/add.hpp"
 #include "../primitives/sub.hpp"
+#include "../primitives/comba.hpp"
 
 #include <cstddef>
 #include <algorithm>
+#include <cassert>
 
 #include <iostream>
 #include <iomanip>
 
 namespace SDF::Bignum::Multiplication
 {
-	// Note: It would be more efficient to give these multiplication strategies a common
-	//       multiplication buffer instead of creating multiple buffers. Again, this is just a start
-	//       to the full program.
-	SmallKaratsuba::SmallKaratsuba(std::size_t maxProdSize)
-		: m_lastProductLength(0), m_productBuffer(maxProdSize), m_workBuffer(
-			maxProdSize + 2)
+	SmallKaratsuba::SmallKaratsuba(std::size_t maxProdSize,
+		Memory::Buffers::Local::ScratchPool *scratch)
+		: m_maxProdSize(maxProdSize), m_scratch(scratch)
 	{
 	}
 
-	void SmallKaratsuba::mulDigits(Memory::SafePtr<Digit> u, std::size_t uLen,
-		Memory::SafePtr<Digit> v, std::size_t vLen)
+	std::size_t SmallKaratsuba::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> u, std::size_t uLen, Memory::SafePtr<Digit> v,
+		std::size_t vLen)
 	{
 		// The Karatsuba method is based on the following identity:
 		//
@@ -58,39 +58,45 @@ namespace SDF::Bignum::Multiplication
 		// with just 3 multiplications, by noting that ad + bc is part of (a + b)(c + d), which
 		// generally equals ac + ad + bc + bd, so we can find ad + bc as (a + b)(c + d) - ac - bd,
 		// and the last two are also what we need for the above.
-
-		// Step 1: Zeroize the product buffer.
-		Memory::SafePtr<Digit> prodBuf(m_productBuffer.accessData(0));
-		for (std::size_t i(0); i < uLen + vLen; ++i) {
-			prodBuf[i] = 0;
-		}
-
-		// Now go to the recursive multiplication.
-		recursiveMul(prodBuf, u, uLen, v, vLen, m_workBuffer.accessData(0));
-		m_lastProductLength = uLen + vLen;
-		if (prodBuf[uLen + vLen - 1] == 0) {
-			--m_lastProductLength;
-		}
+		//
+		// recursiveMul zeroizes its answer itself. Its work space is borrowed for the call, so
+		// that several threads may multiply at once; twice the product is more than it needs.
+		std::size_t prodLen(uLen + vLen);
+		assert(prodLen <= m_maxProdSize);
+
+		auto work(m_scratch->borrow<Digit>(2 * prodLen + 2));
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodLen,
+			[&](Memory::SafePtr<Digit> prod) {
+				recursiveMul(prod, u, uLen, v, vLen, work.accessData(0));
+			});
 	}
 
+	std::size_t SmallKaratsuba::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
+	{
+		// As above, but (see recursiveSqr) with the three products all squares.
+		std::size_t prodLen(aLen << 1);
+		assert(prodLen <= m_maxProdSize);
 
-	void SmallKaratsuba::squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen) {
-		// TBA
-		mulDigits(a, aLen, a, aLen);
+		auto work(m_scratch->borrow<Digit>(2 * prodLen + 2));
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodLen,
+			[&](Memory::SafePtr<Digit> prod) { recursiveSqr(prod, a, aLen, work.accessData(0)); });
 	}
 
-	std::size_t SmallKaratsuba::getProductLength() const
+	std::size_t SmallKaratsuba::mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		Memory::SafePtr<Digit> u, std::size_t uLen, Memory::SafePtr<Digit> v, std::size_t vLen)
 	{
-		return m_lastProductLength;
-	}
+		// See recursiveShortMul.
+		std::size_t prodLen(uLen + vLen);
+		assert(prodLen <= m_maxProdSize);
 
-	void SmallKaratsuba::getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin,
-		std::size_t length)
-	{
-		Memory::SafePtr<Digit> prodBufPtr(m_productBuffer.accessData(origin));
-		for (std::size_t i(0); i < length; ++i) {
-			dst[i] = prodBufPtr[i];
+		if (prodLen <= dstLen) {
+			return mulDigitsInto(dst, dstLen, true, u, uLen, v, vLen);
 		}
+
+		std::size_t cut(shortProductCut(dstLen, prodLen));
+		return putProduct(*m_scratch, dst, dstLen, true, prodLen,
+			[&](Memory::SafePtr<Digit> prod) { recursiveShortMul(prod, u, uLen, v, vLen, cut); });
 	}
 
 	// Private member: The algorithm core.
@@ -110,19 +116,9 @@ namespace SDF::Bignum::Multiplication
 			}
 
 			if (halfSize <= 2) {
-				// Use a grade school mul to finish off the base case (note we should probably tweak
-				// this to start this at larger sizes.) c.f. ClassicalSmallMul
-				for (std::size_t j(0); j < vLen; ++j) {
-					TwoDigit carry(0);
-					for (std::size_t i(0); i < uLen; ++i) {
-						TwoDigit tmp(ans[j + i] + (static_cast<TwoDigit>(u[i]) * v[j]) + carry);
-						carry = tmp / BASE;
-						tmp -= carry * BASE;
-						ans[j + i] = static_cast<Digit>(tmp);
-					}
-
-					ans[j + uLen] = carry;
-				}
+				// Use a column-wise grade school mul to finish off the base case (note we should
+				// probably tweak this to start this at larger sizes.) c.f. ClassicalSmallMul
+				Primitives::combaMul(ans, u, uLen, v, vLen);
 			} else {
 				// The next steps depend on whether the shorter operand was too small to be cut, given
 				// that we cut both at the same digit significance.
@@ -216,4 +212,126 @@ namespace SDF::Bignum::Multiplication
 			}
 		}
 	}
+
+	void SmallKaratsuba::recursiveSqr(Memory::SafePtr<Digit> ans, Memory::SafePtr<Digit> u,
+		std::size_t uLen, Memory::SafePtr<Digit> work)
+	{
+		// With u = aB^n + b, the identity becomes
+		//
+		//     (aB^n + b)^2 = a^2 B^(2n) + ((a + b)^2 - a^2 - b^2) B^n + b^2
+		//
+		// so there is only the one sum to form, and each of the three products is a square, which
+		// recurses into here and bottoms out in the classical squaring, doing about half the
+		// multiplies of a classical product.
+		std::size_t halfSize(uLen / 2);
+
+		for (std::size_t i(0); i < 2 * uLen; ++i) {
+			ans[i] = 0;
+		}
+
+		if (halfSize <= 2) {
+			Primitives::combaSqr(ans, u, uLen);
+		} else {
+			Memory::SafePtr<Digit> aPtr(u + halfSize);
+			Memory::SafePtr<Digit> bPtr(u);
+
+			std::size_t aLen(uLen - halfSize); // never less than bLen
+			std::size_t bLen(halfSize);
+
+			Memory::SafePtr<Digit> sumPtr(work); // a + b
+			Digit sumCarry(Primitives::unevenAdd(sumPtr, aPtr, aLen, bPtr, bLen, 0));
+
+			// Find (a + b)^2. If the sum carried, it is really sum + B^aLen, whose square is more
+			// by twice sum B^aLen and B^(2 aLen); the last lands in the top digit of the product,
+			// which halfSize >= 1 keeps inside it.
+			recursiveSqr(ans + halfSize, sumPtr, aLen, sumPtr + aLen);
+			if (sumCarry) {
+				std::size_t offs(halfSize + aLen);
+				Primitives::propagateAdd(ans + offs, 2 * uLen - offs, sumPtr, aLen);
+				Primitives::propagateAdd(ans + offs, 2 * uLen - offs, sumPtr, aLen);
+
+				offs += aLen;
+				Primitives::propagateCarry(ans + offs, ans + offs, 1, 2 * uLen - offs);
+			}
+
+			// Compute a^2, then add a^2 B^(2n) and subtract a^2 B^n.
+			recursiveSqr(work, aPtr, aLen, work + 2 * aLen);
+			Primitives::propagateSub(ans + halfSize, 2 * uLen - halfSize, work, 2 * aLen);
+			Primitives::propagateAdd(ans + 2 * halfSize, 2 * uLen - 2 * halfSize, work, 2 * aLen);
+
+			// Compute b^2, then add b^2 and subtract b^2 B^n.
+			recursiveSqr(work, bPtr, bLen, work + 2 * bLen);
+			Primitives::propagateAdd(ans, 2 * uLen, work, 2 * bLen);
+			Primitives::propagateSub(ans + halfSize, 2 * uLen - halfSize, work, 2 * bLen);
+		}
+	}
+
+	void SmallKaratsuba::recursiveShortMul(Memory::SafePtr<Digit> ans, Memory::SafePtr<Digit> u,
+		std::size_t uLen, Memory::SafePtr<Digit> v, std::size_t vLen, std::size_t cut)
+	{
+		// Mulders' short product. This sums all the partial products u[i] * v[j] with i + j at
+		// least cut, and some others, into the uLen + vLen digits of ans; as those left out are
+		// never negative, the result is a little short of the full product. Cutting u = aB^p + b
+		// and v = cB^q + d, with p + q no more than cut + 1 so that bd lands wholly below cut,
+		//
+		//     uv = ac B^(p+q) + ad B^p + bc B^q + bd,
+		//
+		// ac is done in full by the Karatsuba method, ad and bc are again short products, and bd
+		// is left out. With p and q picked as below, keeping the top half takes from about half
+		// to three quarters of the time of the full product.
+		std::size_t prodLen(uLen + vLen);
+		for (std::size_t i(0); i < prodLen; ++i) {
+			ans[i] = 0;
+		}
+
+		if (cut + 2 > prodLen) {
+			return; // no partial products land this high
+		}
+
+		// Digits of one factor that meet none of the other's at cut or above are not needed.
+		std::size_t uLow((cut + 1 > vLen) ? cut + 1 - vLen : 0);
+		std::size_t vLow((cut + 1 > uLen) ? cut + 1 - uLen : 0);
+		ans += uLow + vLow;
+		u += uLow;
+		uLen -= uLow;
+		v += vLow;
+		vLen -= vLow;
+		cut -= uLow + vLow;
+
+		// The Karatsuba recursion above halves the length down to 5 digits or less, so it takes
+		// about as long for any length from over 5 * 2^(k-1) to 5 * 2^k. So ac is best made the
+		// longest length one level shallower than the factors, if that leaves p + q small enough,
+		// and otherwise about 0.7 of them, which is best on average.
+		std::size_t topLen(5);
+		while (2 * topLen < std::max(uLen, vLen)) {
+			topLen *= 2;
+		}
+
+		std::size_t p((uLen > topLen) ? uLen - topLen : 0);
+		std::size_t q((vLen > topLen) ? vLen - topLen : 0);
+		if ((p + q > cut + 1) || (p == 0) || (q == 0)) {
+			p = std::min(uLen - 1, (3 * (cut + 1)) / 10);
+			q = std::min(vLen - 1, (3 * (cut + 1)) / 10);
+		}
+		if (cut == 0) {
+			auto work(m_scratch->borrow<Digit>(2 * (uLen + vLen) + 2));
+			recursiveMul(ans, u, uLen, v, vLen, work.accessData(0));
+		} else if ((uLen + vLen <= SHORT_CROSSOVER) || (p == 0) || (q == 0)) {
+			Primitives::combaMulHigh(ans, u, uLen, v, vLen, cut);
+		} else {
+			// Find ac at the top.
+			{
+				auto work(m_scratch->borrow<Digit>(2 * (uLen + vLen) + 2));
+				recursiveMul(ans + (p + q), u + p, uLen - p, v + q, vLen - q, work.accessData(0));
+			}
+
+			// Add ad B^p and bc B^q.
+			auto part(m_scratch->borrow<Digit>(std::max(uLen - p + q, p + vLen - q)));
+			recursiveShortMul(part.accessData(0), u + p, uLen - p, v, q, cut - p);
+			Primitives::propagateAdd(ans + p, uLen + vLen - p, part.accessData(0), uLen - p + q);
+
+			recursiveShortMul(part.accessData(0), u, p, v + q, vLen - q, cut - q);
+			Primitives::propagateAdd(ans + q, uLen + vLen - q, part.accessData(0), p + vLen - q);
+		}
+	}
 }
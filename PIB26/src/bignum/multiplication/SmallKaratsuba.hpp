@@ -27,7 +27,7 @@
 
 #include "../IMultiplicationStrategy.hpp"
 
-#include "../../memory/buffers/local/RAMOnly.hpp"
+#include "../../memory/buffers/local/ScratchPool.hpp"
 
 namespace SDF::Bignum::Multiplication
 {
@@ -42,22 +42,32 @@ namespace SDF::Bignum::Multiplication
 			// Function:  SmallKaratsuba
 			// Purpose:   Construct a new instance with a given maximum buffer size.
 			// Arguments: maxProdSize - The maximum multiplication size to allow.
-			SmallKaratsuba(std::size_t maxProdSize);
+			//            scratch - The pool to borrow scratch space from, shared with the other
+			//                      strategies.
+			SmallKaratsuba(std::size_t maxProdSize, Memory::Buffers::Local::ScratchPool *scratch);
 
-			void mulDigits(Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+			std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+			std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen);
+			std::size_t mulDigitsHighInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
 				std::size_t bLen);
-			void squareDigits(Memory::SafePtr<Digit> a, std::size_t aLen);
-
-			std::size_t getProductLength() const;
-
-			void getProductDigits(Memory::SafePtr<Digit> dst, std::size_t origin, std::size_t length);
 		private:
-			std::size_t m_lastProductLength;
-			Memory::Buffers::Local::RAMOnly<Digit> m_productBuffer;
-			Memory::Buffers::Local::RAMOnly<Digit> m_workBuffer;
+			// Short products with operands this long together or less are done by the classical
+			// method.
+			static const std::size_t SHORT_CROSSOVER = 32;
+
+			std::size_t m_maxProdSize;
+			Memory::Buffers::Local::ScratchPool *m_scratch;
 
 			void recursiveMul(Memory::SafePtr<Digit> ans, Memory::SafePtr<Digit> u, std::size_t uLen,
 				Memory::SafePtr<Digit> v, std::size_t vLen, Memory::SafePtr<Digit> work);
+			void recursiveSqr(Memory::SafePtr<Digit> ans, Memory::SafePtr<Digit> u, std::size_t uLen,
+				Memory::SafePtr<Digit> work);
+			void recursiveShortMul(Memory::SafePtr<Digit> ans, Memory::SafePtr<Digit> u,
+				std::size_t uLen, Memory::SafePtr<Digit> v, std::size_t vLen, std::size_t cut);
 	};
 }
 
@@ -0,0 +1,449 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      ToomCook.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ToomCook.hpp"
+
+#include "../../exceptions/exceptions.hpp"
+
+#include "../primitives/add.hpp"
+#include "../primitives/compare.hpp"
+#include "../primitives/divsm.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace SDF::Bignum::Multiplication
+{
+	// The evaluation points, as num/den, with infinity as 1/0. The values of a polynomial of degree
+	// d at num/den are scaled up by den^d, which makes them integers; at infinity that leaves the
+	// top coefficient.
+	static const std::size_t c_numPoints = 7;
+	static const TwoDigit c_pointNum[c_numPoints] = { 0, 1, 1, -1, 2, -2, 1 };
+	static const TwoDigit c_pointDen[c_numPoints] = { 1, 0, 1, 1, 1, 1, 2 };
+
+	// Function:   power
+	// Purpose:    Raise a small number to a power, taking 0^0 as 1.
+	// Parameters: x - The number.
+	//             n - The power.
+	// Returns:    x^n.
+	static TwoDigit power(TwoDigit x, std::size_t n)
+	{
+		TwoDigit rv(1);
+		for (std::size_t i(0); i < n; ++i) {
+			rv *= x;
+		}
+
+		return rv;
+	}
+
+	// Structure: Fraction
+	// Purpose:   A rational number, for working out the interpolation matrices. Kept in lowest
+	//            terms with a positive denominator.
+	struct Fraction
+	{
+			TwoDigit num;
+			TwoDigit den;
+
+			Fraction(TwoDigit n = 0, TwoDigit d = 1)
+				: num(n), den(d)
+			{
+				TwoDigit g(std::gcd(num, den));
+				num /= g;
+				den /= g;
+				if (den < 0) {
+					num = -num;
+					den = -den;
+				}
+			}
+	};
+
+	static Fraction operator-(const Fraction &a, const Fraction &b)
+	{
+		return Fraction(a.num * b.den - b.num * a.den, a.den * b.den);
+	}
+
+	static Fraction operator*(const Fraction &a, const Fraction &b)
+	{
+		return Fraction(a.num * b.num, a.den * b.den);
+	}
+
+	static Fraction operator/(const Fraction &a, const Fraction &b)
+	{
+		return Fraction(a.num * b.den, a.den * b.num);
+	}
+
+	// Function:   normalizeColumns
+	// Purpose:    Carry a string of column sums, which may be negative, out into digits.
+	// Parameters: r - A pointer into the buffer to hold the digits.
+	//             col - A pointer into the buffer holding the column sums.
+	//             len - The number of columns.
+	// Returns:    The carry out of the top, which is negative if the sum as a whole was.
+	static TwoDigit normalizeColumns(Memory::SafePtr<Digit> r, Memory::SafePtr<const TwoDigit> col,
+		std::size_t len)
+	{
+		TwoDigit carry(0);
+		for (std::size_t t(0); t < len; ++t) {
+			TwoDigit tmp(col[t] + carry);
+			carry = tmp / BASE;
+			tmp -= carry * BASE;
+			if (tmp < 0) {
+				tmp += BASE;
+				--carry;
+			}
+
+			r[t] = static_cast<Digit>(tmp);
+		}
+
+		return carry;
+	}
+
+	ToomCook::ToomCook(std::size_t pieces, IMultiplicationStrategy *baseStrategy,
+		std::size_t crossover, std::size_t maxProdSize,
+		Memory::Buffers::Local::ScratchPool *scratch)
+		: m_pieces(pieces), m_baseStrategy(baseStrategy), m_crossover(crossover),
+			m_maxProdSize(maxProdSize), m_scratch(scratch)
+	{
+		if ((m_pieces < 2) || (2 * m_pieces - 1 > c_numPoints)) {
+			throw SDF::Exceptions::Exception("Toom-Cook can only cut into 2 to 4 pieces");
+		}
+
+		// Below 2 * pieces^2 digits of product the longer factor may be too short to cut.
+		m_crossover = std::max(m_crossover, 2 * m_pieces * m_pieces);
+
+		m_balancedSplit = makeSplit(m_pieces, m_pieces);
+		m_unbalancedSplit = makeSplit(m_pieces, m_pieces - 1);
+	}
+
+	std::size_t ToomCook::mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+		std::size_t bLen)
+	{
+		if (aLen + bLen > m_maxProdSize) {
+			throw SDF::Exceptions::Exception(
+				"Requested Toom-Cook multiply of numbers that were too big :(");
+		}
+
+		std::size_t prodSize(aLen + bLen);
+		if (prodSize < m_crossover) {
+			return m_baseStrategy->mulDigitsInto(dst, dstLen, keepTop, a, aLen, b, bLen);
+		}
+
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodSize,
+			[&](Memory::SafePtr<Digit> prod) { mulRec(prod, a, aLen, b, bLen, false); });
+	}
+
+	std::size_t ToomCook::squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+		bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen)
+	{
+		if ((aLen << 1) > m_maxProdSize) {
+			throw SDF::Exceptions::Exception(
+				"Requested Toom-Cook multiply of numbers that were too big :(");
+		}
+
+		std::size_t prodSize(aLen << 1);
+		if (prodSize < m_crossover) {
+			return m_baseStrategy->squareDigitsInto(dst, dstLen, keepTop, a, aLen);
+		}
+
+		return putProduct(*m_scratch, dst, dstLen, keepTop, prodSize,
+			[&](Memory::SafePtr<Digit> prod) { mulRec(prod, a, aLen, a, aLen, true); });
+	}
+
+	// Private members.
+	ToomCook::Split ToomCook::makeSplit(std::size_t uPieces, std::size_t vPieces)
+	{
+		// The scaled product at point j is the sum over i of coefficient i times
+		// num_j^i den_j^(p - 1 - i). Invert that matrix by Gauss-Jordan elimination, exactly.
+		std::size_t p(uPieces + vPieces - 1);
+		std::vector<std::vector<Fraction>> mat(p, std::vector<Fraction>(2 * p));
+		for (std::size_t j(0); j < p; ++j) {
+			for (std::size_t i(0); i < p; ++i) {
+				mat[j][i] = Fraction(power(c_pointNum[j], i) * power(c_pointDen[j], p - 1 - i));
+			}
+
+			mat[j][p + j] = Fraction(1);
+		}
+
+		for (std::size_t col(0); col < p; ++col) {
+			std::size_t pivot(col);
+			while (mat[pivot][col].num == 0) {
+				++pivot;
+			}
+
+			std::swap(mat[col], mat[pivot]);
+
+			Fraction scale(mat[col][col]);
+			for (std::size_t c(0); c < 2 * p; ++c) {
+				mat[col][c] = mat[col][c] / scale;
+			}
+
+			for (std::size_t row(0); row < p; ++row) {
+				Fraction factor(mat[row][col]);
+				if ((row != col) && (factor.num != 0)) {
+					for (std::size_t c(0); c < 2 * p; ++c) {
+						mat[row][c] = mat[row][c] - factor * mat[col][c];
+					}
+				}
+			}
+		}
+
+		// Put each row over a common denominator.
+		Split split;
+		split.uPieces = uPieces;
+		split.vPieces = vPieces;
+		split.coeffs.resize(p);
+		split.denoms.resize(p);
+		for (std::size_t i(0); i < p; ++i) {
+			TwoDigit denom(1);
+			for (std::size_t j(0); j < p; ++j) {
+				denom = std::lcm(denom, mat[i][p + j].den);
+			}
+
+			split.denoms[i] = denom;
+			for (std::size_t j(0); j < p; ++j) {
+				split.coeffs[i].push_back(mat[i][p + j].num * (denom / mat[i][p + j].den));
+			}
+		}
+
+		return split;
+	}
+
+	void ToomCook::mulRec(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+		Memory::SafePtr<Digit> b, std::size_t bLen, bool square)
+	{
+		// Make a the longer factor.
+		if (aLen < bLen) {
+			std::swap(a, b);
+			std::swap(aLen, bLen);
+		}
+
+		if (aLen + bLen < m_crossover) {
+			baseMul(r, a, aLen, b, bLen, square);
+			return;
+		}
+
+		// Cut a into as few digits per piece as will do, and see if b fills as many pieces, or
+		// one fewer, at that size. (A square always fills them.)
+		std::size_t m(m_pieces);
+		std::size_t k((aLen + m - 1) / m);
+		if (bLen > (m - 1) * k) {
+			mulSplit(r, a, aLen, b, bLen, m_balancedSplit, k, square);
+			return;
+		}
+
+		k = std::max(k, (bLen + m - 2) / (m - 1));
+		if ((aLen > (m - 1) * k) && (bLen > (m - 2) * k)) {
+			mulSplit(r, a, aLen, b, bLen, m_unbalancedSplit, k, false);
+			return;
+		}
+
+		mulSliced(r, a, aLen, b, bLen);
+	}
+
+	void ToomCook::mulSplit(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+		Memory::SafePtr<Digit> b, std::size_t bLen, const Split &split, std::size_t k,
+		bool square)
+	{
+		// The values at the points fit in k + 1 digits, as the scaled evaluation coefficients
+		// sum to no more than 15, and so the pointwise products in 2k + 2.
+		std::size_t numPoints(split.denoms.size());
+		std::size_t evalLen(k + 1);
+		std::size_t prodLen(2 * k + 2);
+
+		// The column sums are only needed while evaluating or interpolating, not across the
+		// recursion, and never for more than prodLen columns.
+		auto scratchLease(m_scratch->borrow<Digit>(2 * evalLen + (numPoints + 1) * prodLen + 1));
+		auto colLease(m_scratch->borrow<TwoDigit>(prodLen));
+		Memory::SafePtr<Digit> scratch(scratchLease.accessData(0));
+		Memory::SafePtr<TwoDigit> col(colLease.accessData(0));
+		Memory::SafePtr<Digit> aEval(scratch);
+		Memory::SafePtr<Digit> bEval(scratch + evalLen);
+		Memory::SafePtr<Digit> prods(scratch + 2 * evalLen);
+		Memory::SafePtr<Digit> row(prods + numPoints * prodLen);
+
+		// Evaluate and multiply at each point in turn.
+		std::vector<bool> negative(numPoints);
+		for (std::size_t j(0); j < numPoints; ++j) {
+			Memory::SafePtr<Digit> aValue(aEval);
+			bool aNegative(false);
+			std::size_t aValueLen(evaluate(aValue, aEval, a, aLen, k, split.uPieces, j, col,
+				aNegative));
+
+			Memory::SafePtr<Digit> bValue(aValue);
+			bool bNegative(aNegative);
+			std::size_t bValueLen(aValueLen);
+			if (!square) {
+				bValueLen = evaluate(bValue, bEval, b, bLen, k, split.vPieces, j, col, bNegative);
+			}
+
+			negative[j] = (aNegative != bNegative);
+
+			Memory::SafePtr<Digit> prod(prods + j * prodLen);
+			std::size_t filled(0);
+			if ((aValueLen != 0) && (bValueLen != 0)) {
+				mulRec(prod, aValue, aValueLen, bValue, bValueLen, square);
+				filled = aValueLen + bValueLen;
+			}
+
+			for (std::size_t i(filled); i < prodLen; ++i) {
+				prod[i] = 0;
+			}
+		}
+
+		for (std::size_t i(0); i < aLen + bLen; ++i) {
+			r[i] = 0;
+		}
+
+		interpolate(r, aLen + bLen, prods, prodLen, negative, split, k, row, col);
+	}
+
+	void ToomCook::mulSliced(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+		Memory::SafePtr<Digit> b, std::size_t bLen)
+	{
+		// b is too short to cut up along with a, so multiply it by slices of a as long as itself
+		// and add those up.
+		auto prodLease(m_scratch->borrow<Digit>(2 * bLen));
+		Memory::SafePtr<Digit> prod(prodLease.accessData(0));
+
+		for (std::size_t i(0); i < aLen + bLen; ++i) {
+			r[i] = 0;
+		}
+
+		for (std::size_t offset(0); offset < aLen; offset += bLen) {
+			std::size_t sliceLen(std::min(bLen, aLen - offset));
+			mulRec(prod, a + offset, sliceLen, b, bLen, false);
+			Primitives::propagateAdd(r + offset, aLen + bLen - offset, prod, sliceLen + bLen);
+		}
+	}
+
+	void ToomCook::baseMul(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+		Memory::SafePtr<Digit> b, std::size_t bLen, bool square)
+	{
+		// Without keepTop the base strategy sets all aLen + bLen digits.
+		if (square) {
+			m_baseStrategy->squareDigitsInto(r, aLen + bLen, false, a, aLen);
+		} else {
+			m_baseStrategy->mulDigitsInto(r, aLen + bLen, false, a, aLen, b, bLen);
+		}
+	}
+
+	std::size_t ToomCook::evaluate(Memory::SafePtr<Digit> &value, Memory::SafePtr<Digit> dst,
+		Memory::SafePtr<Digit> a, std::size_t aLen, std::size_t k, std::size_t pieces,
+		std::size_t point, Memory::SafePtr<TwoDigit> col, bool &negative)
+	{
+		negative = false;
+
+		// At 0 and infinity the value is just the bottom or top piece, which can be used where it
+		// is.
+		if ((c_pointNum[point] == 0) || (c_pointDen[point] == 0)) {
+			std::size_t piece((c_pointNum[point] == 0) ? 0 : pieces - 1);
+			value = a + piece * k;
+			return Primitives::countSignifDigits(value, std::min(k, aLen - piece * k));
+		}
+
+		for (std::size_t t(0); t < k; ++t) {
+			col[t] = 0;
+		}
+
+		for (std::size_t i(0); i < pieces; ++i) {
+			TwoDigit coeff(power(c_pointNum[point], i) * power(c_pointDen[point], pieces - 1 - i));
+			Memory::SafePtr<Digit> piece(a + i * k);
+			std::size_t pieceLen(std::min(k, aLen - i * k));
+			for (std::size_t t(0); t < pieceLen; ++t) {
+				col[t] += coeff * piece[t];
+			}
+		}
+
+		// Take the magnitude of a negative value.
+		TwoDigit carry(normalizeColumns(dst, col, k));
+		if (carry < 0) {
+			for (std::size_t t(0); t < k; ++t) {
+				col[t] = -col[t];
+			}
+
+			carry = normalizeColumns(dst, col, k);
+			negative = true;
+		}
+
+		dst[k] = static_cast<Digit>(carry);
+
+		value = dst;
+		return Primitives::countSignifDigits(dst, k + 1);
+	}
+
+	void ToomCook::interpolate(Memory::SafePtr<Digit> r, std::size_t rLen,
+		Memory::SafePtr<Digit> prods, std::size_t prodLen, const std::vector<bool> &negative,
+		const Split &split, std::size_t k, Memory::SafePtr<Digit> row,
+		Memory::SafePtr<TwoDigit> col)
+	{
+		std::size_t numPoints(split.denoms.size());
+		for (std::size_t i(0); i < numPoints; ++i) {
+			const std::vector<TwoDigit> &coeffs(split.coeffs[i]);
+
+			std::size_t numTerms(0);
+			std::size_t lastTerm(0);
+			for (std::size_t j(0); j < numPoints; ++j) {
+				if (coeffs[j] != 0) {
+					++numTerms;
+					lastTerm = j;
+				}
+			}
+
+			// A coefficient that is just one of the pointwise products, as at 0 and infinity, can be
+			// added in from where it is. The others are sums of multiples of them, which come out
+			// to a nonnegative multiple of the coefficient, as all the coefficients of the product
+			// polynomial are nonnegative.
+			Memory::SafePtr<Digit> coeffDigits(row);
+			std::size_t coeffLen(prodLen + 1);
+			if ((numTerms == 1) && (coeffs[lastTerm] == split.denoms[i]) && !negative[lastTerm]) {
+				coeffDigits = prods + lastTerm * prodLen;
+				coeffLen = prodLen;
+			} else {
+				for (std::size_t t(0); t < prodLen; ++t) {
+					col[t] = 0;
+				}
+
+				for (std::size_t j(0); j < numPoints; ++j) {
+					if (coeffs[j] != 0) {
+						TwoDigit coeff(negative[j] ? -coeffs[j] : coeffs[j]);
+						Memory::SafePtr<Digit> prod(prods + j * prodLen);
+						for (std::size_t t(0); t < prodLen; ++t) {
+							col[t] += coeff * prod[t];
+						}
+					}
+				}
+
+				row[prodLen] = static_cast<Digit>(normalizeColumns(row, col, prodLen));
+				Primitives::divBySmall(row, row, split.denoms[i], prodLen + 1, 0);
+			}
+
+			// The coefficient goes in at B^(ik). Its digits past the end of the product are zero.
+			std::size_t offset(i * k);
+			coeffLen = std::min(Primitives::countSignifDigits(coeffDigits, coeffLen), rLen - offset);
+			if (coeffLen != 0) {
+				Primitives::propagateAdd(r + offset, rLen - offset, coeffDigits, coeffLen);
+			}
+		}
+	}
+}
@@ -0,0 +1,160 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      ToomCook.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_MULTIPLICATION_TOOMCOOK_HPP_
+#define SRC_BIGNUM_MULTIPLICATION_TOOMCOOK_HPP_
+
+#include "../IMultiplicationStrategy.hpp"
+
+#include "../../memory/buffers/local/ScratchPool.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace SDF::Bignum::Multiplication
+{
+	// Class:      ToomCook
+	// Purpose:    Performs a multiplication using the Toom-Cook method, generalizing Karatsuba's.
+	//             The factors are cut into pieces of k digits each, which are taken as the
+	//             coefficients of polynomials u(x) and v(x) with u(B^k) and v(B^k) the factors. The
+	//             product polynomial w(x) = u(x)v(x) is found by multiplying u and v at as many
+	//             points as it has coefficients, then solving for those (interpolation), and the
+	//             product is w(B^k). The points are 0, infinity, 1, -1, 2, -2 and 1/2, in that order,
+	//             as many as are needed; values at the fractional point are scaled up to integers.
+	//
+	//             Toom-3 cuts both factors into 3 pieces, which takes 5 products of a third of the
+	//             length, for O(n^log_3(5)); Toom-4 cuts them into 4, which takes 7 of a quarter,
+	//             for O(n^log_4(7)). When the shorter factor is too short to fill as many pieces
+	//             at the same k, it is cut into one fewer ("Toom-2.5" and "Toom-3.5"), and when it
+	//             is shorter still, the longer factor is sliced up and the slices multiplied by it
+	//             separately. The pointwise products are done by recursing into the method until
+	//             they are short enough to hand off to another strategy.
+	//
+	//             The interpolation is done from a matrix found at construction time, as a sum of
+	//             small multiples of the pointwise products followed by one exact division by a
+	//             small number for each coefficient. The sums are taken column by column, so that
+	//             the signs of the intermediate values need no special care.
+	// Parameters: None.
+	class ToomCook : public IMultiplicationStrategy
+	{
+		public:
+			// Function:  ToomCook
+			// Purpose:   Construct a new strategy object with a given maximum buffer size.
+			// Arguments: pieces - The number of pieces to cut the factors into: 3 or 4.
+			//            baseStrategy - The strategy to use for small and pointwise products. Must be
+			//                           able to handle products up to crossover digits long.
+			//            crossover - The product length at which to switch to Toom-Cook from the base
+			//                        strategy. Pointwise products are also handed off to the base
+			//                        strategy once they fall below this length.
+			//            maxProdSize - The maximum multiplication size to allow.
+			//            scratch - The pool to borrow scratch space from, shared with the other
+			//                      strategies.
+			ToomCook(std::size_t pieces, IMultiplicationStrategy *baseStrategy, std::size_t crossover,
+				std::size_t maxProdSize, Memory::Buffers::Local::ScratchPool *scratch);
+
+			std::size_t mulDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen, bool keepTop,
+				Memory::SafePtr<Digit> a, std::size_t aLen, Memory::SafePtr<Digit> b,
+				std::size_t bLen);
+			std::size_t squareDigitsInto(Memory::SafePtr<Digit> dst, std::size_t dstLen,
+				bool keepTop, Memory::SafePtr<Digit> a, std::size_t aLen);
+		private:
+			// Structure: Split
+			// Purpose:   The interpolation for one way of cutting the factors: coefficient i of the
+			//            product polynomial is the sum over the points j of coeffs[i][j] times the
+			//            product at point j, divided by denoms[i].
+			struct Split
+			{
+					std::size_t uPieces;
+					std::size_t vPieces;
+					std::vector<std::vector<TwoDigit>> coeffs;
+					std::vector<TwoDigit> denoms;
+			};
+
+			std::size_t m_pieces;
+			IMultiplicationStrategy *m_baseStrategy;
+			std::size_t m_crossover;
+			std::size_t m_maxProdSize;
+
+			Split m_balancedSplit;
+			Split m_unbalancedSplit;
+
+			// The scratch space for each level of recursion and for the column sums. Nothing is
+			// taken up while all the products are short enough for the base strategy.
+			Memory::Buffers::Local::ScratchPool *m_scratch;
+
+			static Split makeSplit(std::size_t uPieces, std::size_t vPieces);
+
+			void mulRec(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen, bool square);
+			void mulSplit(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen, const Split &split, std::size_t k,
+				bool square);
+			void mulSliced(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen);
+			void baseMul(Memory::SafePtr<Digit> r, Memory::SafePtr<Digit> a, std::size_t aLen,
+				Memory::SafePtr<Digit> b, std::size_t bLen, bool square);
+
+			std::size_t evaluate(Memory::SafePtr<Digit> &value, Memory::SafePtr<Digit> dst,
+				Memory::SafePtr<Digit> a, std::size_t aLen, std::size_t k, std::size_t pieces,
+				std::size_t point, Memory::SafePtr<TwoDigit> col, bool &negative);
+			void interpolate(Memory::SafePtr<Digit> r, std::size_t rLen,
+				Memory::SafePtr<Digit> prods, std::size_t prodLen, const std::vector<bool> &negative,
+				const Split &split, std::size_t k, Memory::SafePtr<Digit> row,
+				Memory::SafePtr<TwoDigit> col);
+	};
+
+	// Class:      Toom3
+	// Purpose:    Toom-Cook multiplication cutting the factors into 3 pieces (see ToomCook).
+	// Parameters: None.
+	class Toom3 : public ToomCook
+	{
+		public:
+			// Function:  Toom3
+			// Purpose:   Construct a new strategy object with a given maximum buffer size.
+			// Arguments: baseStrategy, crossover, maxProdSize, scratch - As for ToomCook.
+			Toom3(IMultiplicationStrategy *baseStrategy, std::size_t crossover,
+				std::size_t maxProdSize, Memory::Buffers::Local::ScratchPool *scratch)
+				: ToomCook(3, baseStrategy, crossover, maxProdSize, scratch)
+			{
+			}
+	};
+
+	// Class:      Toom4
+	// Purpose:    Toom-Cook multiplication cutting the factors into 4 pieces (see ToomCook).
+	// Parameters: None.
+	class Toom4 : public ToomCook
+	{
+		public:
+			// Function:  Toom4
+			// Purpose:   Construct a new strategy object with a given maximum buffer size.
+			// Arguments: baseStrategy, crossover, maxProdSize, scratch - As for ToomCook.
+			Toom4(IMultiplicationStrategy *baseStrategy, std::size_t crossover,
+				std::size_t maxProdSize, Memory::Buffers::Local::ScratchPool *scratch)
+				: ToomCook(4, baseStrategy, crossover, maxProdSize, scratch)
+			{
+			}
+	};
+}
+
+#endif /* SRC_BIGNUM_MULTIPLICATION_TOOMCOOK_HPP_ */
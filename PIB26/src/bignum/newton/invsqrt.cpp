@@ -72,16 +72,17 @@ namespace SDF::Bignum
 		ticker->printTicker();
 
 		for (std::size_t i(0); i < 2 * DIGS_PER_DIG; ++i) {
-			tmpValReduced.sqr(*this, strategy); // n.b. could have special squaring method
-			tmpValReduced.mul(aReduced, *this, strategy);
+			tmpValReduced.sqr(*this, strategy);
+			tmpValReduced.mul(aReduced, tmpValReduced, strategy);
 			tmpValReduced.subIp(three);
-			tmpValReduced.m_sign = static_cast<Sign>(-m_sign);
+			tmpValReduced.m_sign = static_cast<Sign>(-tmpValReduced.m_sign);
 			mul(*this, tmpValReduced, strategy);
 			divIp(2);
 		}
 
 		// Perform the remaining iterations.
 		do {
+			std::size_t prevPrec(prec);
 			prec <<= 1;
 			if (prec > origPrec) {
 				prec = origPrec;
@@ -89,6 +90,7 @@ namespace SDF::Bignum
 
 			aReduced = a.aliasTruncate(prec);
 			tmpValReduced = tmpVal.aliasTruncate(prec);
+			BigFloat residualReduced(tmpVal.aliasTruncate(prevPrec));
 
 			// The Newton formula is:
 			//
@@ -97,15 +99,19 @@ namespace SDF::Bignum
 			ticker->setTickerCur(prec * DIGS_PER_DIG);
 			ticker->printTicker();
 
-			// again, we can do this mul at half prec
-			tmpValReduced.sqr(*this, strategy); // n.b. could have special squaring method
+			// As with the reciprocal, we compute this instead as
+			//
+			//     x_(n+1) = x_n + x_n (1 - a x_n^2)/2
+			//
+			// where a x_n^2 agrees with 1 to about the previous precision, so only the middle of
+			// that product need be worked out, and the second multiply is at half precision. The
+			// squaring is at half precision as it is.
+			tmpValReduced.sqr(*this, strategy);
+			residualReduced.residual(aReduced, tmpValReduced, prevPrec - 1, strategy);
+			tmpValReduced.mul(*this, residualReduced, strategy);
+			tmpValReduced.divIp(2);
 			resize(prec);
-
-			tmpValReduced.mul(aReduced, tmpValReduced, strategy);
-			tmpValReduced.subIp(three);
-			tmpValReduced.m_sign = static_cast<Sign>(-tmpValReduced.m_sign);
-			mul(*this, tmpValReduced, strategy);
-			divIp(2);
+			addIp(tmpValReduced);
 		} while (prec < origPrec);
 
 		ticker->finishTicker();
@@ -150,7 +156,7 @@ namespace SDF::Bignum
 		ticker->printTicker();
 
 		for (std::size_t i(0); i < 2 * DIGS_PER_DIG; ++i) {
-			tmpValReduced.sqr(*this, strategy); // n.b. could have special squaring method
+			tmpValReduced.sqr(*this, strategy);
 			tmpValReduced.mulIp(a);
 			tmpValReduced.subIp(three);
 			tmpValReduced.m_sign = static_cast<Sign>(-tmpValReduced.m_sign);
@@ -159,7 +165,11 @@ namespace SDF::Bignum
 		}
 
 		// Perform the remaining iterations.
+		BigFloat one(2);
+		one.assign(1);
+
 		do {
+			std::size_t prevPrec(prec);
 			prec <<= 1;
 			if (prec > origPrec) {
 				prec = origPrec;
@@ -174,14 +184,23 @@ namespace SDF::Bignum
 			ticker->setTickerCur(prec * DIGS_PER_DIG);
 			ticker->printTicker();
 
-			tmpValReduced.sqr(*this, strategy); // n.b. could have special squaring method
-			resize(prec);
-
+			// As a is small, we can work out 1 - a x_n^2 in full, and as it agrees with 1 to about
+			// the previous precision, the subtraction leaves only that many digits worth keeping.
+			// Computing the iteration as
+			//
+			//     x_(n+1) = x_n + x_n (1 - a x_n^2)/2
+			//
+			// then makes the second multiply half precision.
+			tmpValReduced.sqr(*this, strategy);
 			tmpValReduced.mulIp(a);
-			tmpValReduced.subIp(three);
+			tmpValReduced.subIp(one);
 			tmpValReduced.m_sign = static_cast<Sign>(-tmpValReduced.m_sign);
-			mul(*this, tmpValReduced, strategy);
-			divIp(2);
+
+			BigFloat residualReduced(tmpValReduced.aliasTruncate(prevPrec));
+			tmpValReduced.mul(*this, residualReduced, strategy);
+			tmpValReduced.divIp(2);
+			resize(prec);
+			addIp(tmpValReduced);
 		} while (prec < origPrec);
 
 		ticker->finishTicker();
@@ -71,6 +71,7 @@ namespace SDF::Bignum
 
 		// Perform the remaining iterations.
 		do {
+			std::size_t prevPrec(prec);
 			prec <<= 1;
 			if (prec > origPrec) {
 				prec = origPrec;
@@ -78,6 +79,7 @@ namespace SDF::Bignum
 
 			aReduced = a.aliasTruncate(prec);
 			tmpValReduced = tmpVal.aliasTruncate(prec);
+			BigFloat residualReduced(tmpVal.aliasTruncate(prevPrec));
 
 			// The Newton formula is:
 			//
@@ -88,16 +90,16 @@ namespace SDF::Bignum
 
 			// We can make this computation more efficient by computing it as instead
 			//
-			//     x_(n+1) = 2 x_n - a (x_n^2)
+			//     x_(n+1) = x_n + x_n (1 - a x_n).
 			//
-			// where the squaring can then be done with half precision inputs, in addition to that
-			// squarings are easier with some multiplication algorithms.
-			tmpValReduced.sqr(*this, strategy); // does mul at previous prec
+			// As x_n is good to the previous precision, a x_n agrees with 1 to about that many
+			// digits, so only the middle of that product need be worked out, with a wrapped
+			// multiply about half the length of the full one. And the residual 1 - a x_n need only
+			// be good to the previous precision too, so the second multiply is at half precision.
+			residualReduced.residual(aReduced, *this, prevPrec - 1, strategy);
+			tmpValReduced.mul(*this, residualReduced, strategy);
 			resize(prec); // upgrade to full prec
-
-			tmpValReduced.mul(aReduced, tmpValReduced, strategy);
-			mulIp(2);
-			subIp(tmpValReduced);
+			addIp(tmpValReduced);
 		} while (prec < origPrec);
 
 		ticker->finishTicker();
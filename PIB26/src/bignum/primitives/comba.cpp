@@ -0,0 +1,117 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      comba.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "comba.hpp"
+
+#include <algorithm>
+
+namespace SDF::Bignum::Primitives
+{
+	// A partial product is below BASE^2 < 2^38, so a column can take 2^24 of them, even doubled,
+	// in a TwoDigit before it must be carried out. Only absurdly long operands reach that.
+	static const std::size_t c_maxColumnTerms = std::size_t(1) << 24;
+
+	void combaMul(Memory::SafePtr<Digit> r, Memory::SafePtr<const Digit> a, std::size_t aLen,
+		Memory::SafePtr<const Digit> b, std::size_t bLen)
+	{
+		combaMulHigh(r, a, aLen, b, bLen, 0);
+	}
+
+	void combaMulHigh(Memory::SafePtr<Digit> r, Memory::SafePtr<const Digit> a, std::size_t aLen,
+		Memory::SafePtr<const Digit> b, std::size_t bLen, std::size_t from)
+	{
+		std::size_t low(std::min(from, aLen + bLen - 1));
+		for (std::size_t k(0); k < low; ++k) {
+			r[k] = 0;
+		}
+
+		TwoDigit carry(0);
+		for (std::size_t k(low); k + 1 < aLen + bLen; ++k) {
+			// Column k holds a[i] * b[k - i] for all the i in range of both operands.
+			std::size_t iBegin((k + 1 > bLen) ? k + 1 - bLen : 0);
+			std::size_t iEnd(std::min(k + 1, aLen));
+
+			TwoDigit acc(carry);
+			TwoDigit high(0);
+			for (std::size_t i0(iBegin); i0 < iEnd; i0 += c_maxColumnTerms) {
+				std::size_t i1(std::min(iEnd, i0 + c_maxColumnTerms));
+				for (std::size_t i(i0); i < i1; ++i) {
+					acc += static_cast<TwoDigit>(a[i]) * b[k - i];
+				}
+
+				TwoDigit q(acc / BASE);
+				high += q;
+				acc -= q * BASE;
+			}
+
+			r[k] = static_cast<Digit>(acc);
+			carry = high;
+		}
+
+		// The top carry is always below BASE, as even the full product fits in aLen + bLen digits.
+		r[aLen + bLen - 1] = static_cast<Digit>(carry);
+	}
+
+	void combaSqr(Memory::SafePtr<Digit> r, Memory::SafePtr<const Digit> a, std::size_t aLen)
+	{
+		TwoDigit carry(0);
+		for (std::size_t k(0); k + 1 < 2 * aLen; ++k) {
+			// Column k holds twice a[i] * a[k - i] for i < k - i, plus a[k/2]^2 if k is even.
+			std::size_t iBegin((k + 1 > aLen) ? k + 1 - aLen : 0);
+			std::size_t iEnd((k + 1) / 2);
+
+			TwoDigit acc(carry);
+			TwoDigit high(0);
+			if ((k & 1) == 0) {
+				acc += static_cast<TwoDigit>(a[k / 2]) * a[k / 2];
+			}
+
+			for (std::size_t i0(iBegin); i0 < iEnd; i0 += c_maxColumnTerms) {
+				std::size_t i1(std::min(iEnd, i0 + c_maxColumnTerms));
+				TwoDigit cross(0);
+				for (std::size_t i(i0); i < i1; ++i) {
+					cross += static_cast<TwoDigit>(a[i]) * a[k - i];
+				}
+
+				acc += 2 * cross;
+
+				TwoDigit q(acc / BASE);
+				high += q;
+				acc -= q * BASE;
+			}
+
+			// The diagonal-only columns have had no chance to carry yet.
+			if (acc >= BASE) {
+				TwoDigit q(acc / BASE);
+				high += q;
+				acc -= q * BASE;
+			}
+
+			r[k] = static_cast<Digit>(acc);
+			carry = high;
+		}
+
+		r[2 * aLen - 1] = static_cast<Digit>(carry);
+	}
+}
@@ -0,0 +1,79 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      comba.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_BIGNUM_PRIMITIVES_COMBA_HPP_
+#define SRC_BIGNUM_PRIMITIVES_COMBA_HPP_
+
+#include "../../memory/SafePtr.hpp"
+
+#include "../defs.hpp"
+
+#include <cstddef>
+
+namespace SDF::Bignum::Primitives
+{
+	// Function:  combaMul
+	// Purpose:   Multiply two digit strings by the column-wise (Comba) method: each digit of the
+	//            product is found by summing all the partial products that land on it before
+	//            carrying, so there is one division by BASE per product digit instead of one per
+	//            partial product.
+	// Arguments: r - A pointer into the buffer to hold the product, of aLen + bLen digits. It
+	//                must not overlap either operand.
+	//            a - A pointer into a buffer holding the first operand.
+	//            aLen - The number of digits in "a".
+	//            b - A pointer into a buffer holding the second operand.
+	//            bLen - The number of digits in "b".
+	// Returns:   None.
+	void combaMul(Memory::SafePtr<Digit> r, Memory::SafePtr<const Digit> a, std::size_t aLen,
+		Memory::SafePtr<const Digit> b, std::size_t bLen);
+
+	// Function:  combaMulHigh
+	// Purpose:   Multiply two digit strings as above, but summing only the columns from a given
+	//            one up, leaving out the carry into it from those below (a "short product"). The
+	//            result is then short of the product by less than the columns left out add up to.
+	// Arguments: r - A pointer into the buffer to hold the product, of aLen + bLen digits. The
+	//                digits below column "from" are set to zero. It must not overlap either
+	//                operand.
+	//            a - A pointer into a buffer holding the first operand.
+	//            aLen - The number of digits in "a".
+	//            b - A pointer into a buffer holding the second operand.
+	//            bLen - The number of digits in "b".
+	//            from - The lowest column to sum.
+	// Returns:   None.
+	void combaMulHigh(Memory::SafePtr<Digit> r, Memory::SafePtr<const Digit> a, std::size_t aLen,
+		Memory::SafePtr<const Digit> b, std::size_t bLen, std::size_t from);
+
+	// Function:  combaSqr
+	// Purpose:   Square a digit string by the column-wise method, as above. Each partial product
+	//            a[i] * a[j] with i != j turns up twice in its column, so it is only formed once
+	//            and doubled, which is about half the multiplications.
+	// Arguments: r - A pointer into the buffer to hold the square, of 2 * aLen digits. It must
+	//                not overlap the operand.
+	//            a - A pointer into a buffer holding the operand.
+	//            aLen - The number of digits in "a".
+	// Returns:   None.
+	void combaSqr(Memory::SafePtr<Digit> r, Memory::SafePtr<const Digit> a, std::size_t aLen);
+}
+
+#endif /* SRC_BIGNUM_PRIMITIVES_COMBA_HPP_ */
@@ -24,6 +24,8 @@
 
 #include "compare.hpp"
 
+#include <functional>
+
 namespace SDF::Bignum::Primitives
 {
 	std::size_t countSignifDigits(Memory::SafePtr<const Digit> r, std::size_t len)
@@ -90,4 +92,21 @@ namespace SDF::Bignum::Primitives
 
 		return 0;
 	}
+
+	bool overlaps(Memory::SafePtr<const Digit> a, std::size_t aLen, Memory::SafePtr<const Digit> b,
+		std::size_t bLen)
+	{
+		// Compare the raw addresses, as the regions need not be in the same buffer.
+		std::less<const Digit *> before;
+		const Digit *aPtr(a.operator->());
+		const Digit *bPtr(b.operator->());
+
+		return (aLen != 0) && (bLen != 0) && before(aPtr, bPtr + bLen) && before(bPtr, aPtr + aLen);
+	}
+
+	bool sameDigits(Memory::SafePtr<const Digit> a, std::size_t aLen,
+		Memory::SafePtr<const Digit> b, std::size_t bLen)
+	{
+		return (aLen == bLen) && (a.operator->() == b.operator->());
+	}
 }
@@ -78,6 +78,28 @@ namespace SDF::Bignum::Primitives {
 	//             0 iff a == b
 	//            -1 iff a < b.
 	int revCompare(Memory::SafePtr<const Digit> a, Memory::SafePtr<const Digit> b, std::size_t len);
+
+	// Function:  overlaps
+	// Purpose:   Check whether two buffer regions share any digits. They may be in different
+	//            buffers.
+	// Arguments: a - A pointer to the first region.
+	//            aLen - The length of the first region.
+	//            b - A pointer to the second region.
+	//            bLen - The length of the second region.
+	// Returns:   Whether they overlap.
+	bool overlaps(Memory::SafePtr<const Digit> a, std::size_t aLen, Memory::SafePtr<const Digit> b,
+		std::size_t bLen);
+
+	// Function:  sameDigits
+	// Purpose:   Check whether two buffer regions are the very same digits, as those of a number
+	//            and an alias of it are. They may be in different buffers.
+	// Arguments: a - A pointer to the first region.
+	//            aLen - The length of the first region.
+	//            b - A pointer to the second region.
+	//            bLen - The length of the second region.
+	// Returns:   Whether they are.
+	bool sameDigits(Memory::SafePtr<const Digit> a, std::size_t aLen,
+		Memory::SafePtr<const Digit> b, std::size_t bLen);
 }
 
 #endif /* SRC_BIGNUM_PRIMITIVES_COMPARE_HPP_ */
@@ -0,0 +1,177 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      ScratchPool.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_MEMORY_BUFFERS_LOCAL_SCRATCHPOOL_HPP_
+#define SRC_MEMORY_BUFFERS_LOCAL_SCRATCHPOOL_HPP_
+
+#include "../../ILocalBuffer.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace SDF::Memory::Buffers::Local
+{
+	// Class:      ScratchPool
+	// Purpose:    Hands out scratch buffers for the length of a call, taking them back afterwards
+	//             to hand out again, so that code that needs scratch space need not keep its own
+	//             buffers between calls (which would stop it being called from several threads at
+	//             once) nor allocate them afresh each time. One pool is meant to be shared by all
+	//             the multiplication strategies, so that what a multiply at one size gave back
+	//             serves the next at another.
+	//
+	//             Blocks come in size classes, four to each doubling, so a block is at most a
+	//             quarter again as big as asked for, and a free block of the class asked for, or
+	//             of one of the next few up, is handed out again. Free blocks are only kept while
+	//             all the blocks held, lent out or free, come to no more than the most ever lent
+	//             out at once: to make room for a new block past that, free ones are let go,
+	//             biggest first. So the pool never holds much more than the largest set of buffers
+	//             in use at one time. It may be used from several threads at once.
+	// Parameters: None.
+	class ScratchPool
+	{
+		public:
+			// Structure: Stats
+			// Purpose:   How much the pool has been used.
+			struct Stats
+			{
+					std::size_t inUseBytes; // lent out now
+					std::size_t peakInUseBytes; // most lent out at once
+					std::size_t heldBytes; // allocated now, lent out or free
+					std::size_t peakHeldBytes; // most allocated at once
+					std::size_t borrows; // buffers lent out
+					std::size_t allocations; // of those, the ones that needed a new block
+			};
+
+			// Class:      Lease
+			// Purpose:    A buffer borrowed from the pool, given back when the lease goes away. Its
+			//             contents are not initialized.
+			// Parameters: T - The type of elements held in the buffer.
+			template<class T>
+			class Lease : public ILocalBuffer<T>
+			{
+				public:
+					Lease(Lease &&other);
+					~Lease();
+
+					Lease(const Lease &) = delete;
+					Lease &operator=(const Lease &) = delete;
+					Lease &operator=(Lease &&) = delete;
+
+					std::size_t getSize() const;
+
+					SafePtr<T> accessData(std::size_t idx);
+					SafePtr<const T> accessData(std::size_t idx) const;
+				private:
+					friend class ScratchPool;
+
+					ScratchPool *m_pool;
+					void *m_block;
+					std::size_t m_sizeClass;
+					std::size_t m_size;
+					T *m_data;
+
+					Lease(ScratchPool *pool, void *block, std::size_t sizeClass,
+						std::size_t size);
+			};
+
+			ScratchPool();
+			~ScratchPool();
+
+			ScratchPool(const ScratchPool &) = delete;
+			ScratchPool &operator=(const ScratchPool &) = delete;
+
+			// Function:   borrow
+			// Purpose:    Borrow a buffer.
+			// Parameters: size - The size of the buffer in elements.
+			// Returns:    The lease on it. It must not outlive the pool.
+			template<class T>
+			Lease<T> borrow(std::size_t size);
+
+			// Function:   release
+			// Purpose:    Let go of all the free blocks. Those lent out are let go when returned.
+			// Parameters: None.
+			// Returns:    None.
+			void release();
+
+			// Function:   getStats
+			// Purpose:    Get how much the pool has been used.
+			// Parameters: None.
+			// Returns:    The usage.
+			Stats getStats() const;
+		private:
+			static constexpr std::size_t ALIGNMENT = 64; // a cache line, and an AVX-512 vector
+
+			// How many size classes up from the one asked for a free block may be taken from:
+			// one doubling's worth.
+			static constexpr std::size_t REUSE_CLASSES = 4;
+
+			mutable std::mutex m_mutex;
+			std::vector<std::vector<void *>> m_freeBlocks; // by size class
+			Stats m_stats;
+
+			// Function:   getSizeClass
+			// Purpose:    Get the size class a request falls in.
+			// Parameters: bytes - The size in bytes asked for.
+			// Returns:    The smallest size class whose blocks hold that many bytes.
+			static std::size_t getSizeClass(std::size_t bytes);
+
+			// Function:   getClassBytes
+			// Purpose:    Get the size of the blocks of a size class.
+			// Parameters: sizeClass - The size class.
+			// Returns:    The size in bytes.
+			static std::size_t getClassBytes(std::size_t sizeClass);
+
+			// Function:   take
+			// Purpose:    Take a block from the free lists, or allocate a new one.
+			// Parameters: bytes - The least size in bytes the block must have.
+			//             sizeClass - Receives the size class of the block got.
+			// Returns:    The block.
+			void *take(std::size_t bytes, std::size_t &sizeClass);
+
+			// Function:   give
+			// Purpose:    Put a block back on the free lists.
+			// Parameters: block - The block.
+			//             sizeClass - Its size class.
+			// Returns:    None.
+			void give(void *block, std::size_t sizeClass);
+
+			// Function:   evict
+			// Purpose:    Let go of free blocks, biggest first, until a given number of bytes is
+			//             held or there are no more. The mutex must be held.
+			// Parameters: heldBytes - The most to hold.
+			// Returns:    None.
+			void evict(std::size_t heldBytes);
+
+			// Function:   freeBlock
+			// Purpose:    Deallocate a block.
+			// Parameters: block - The block.
+			// Returns:    None.
+			static void freeBlock(void *block);
+	};
+}
+
+#include "ScratchPool.tpp"
+
+#endif /* SRC_MEMORY_BUFFERS_LOCAL_SCRATCHPOOL_HPP_ */
@@ -0,0 +1,216 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      ScratchPool.tpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_MEMORY_BUFFERS_LOCAL_SCRATCHPOOL_TPP_
+#define SRC_MEMORY_BUFFERS_LOCAL_SCRATCHPOOL_TPP_
+
+#include "ScratchPool.hpp"
+
+#include "../../SafePtr.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+namespace SDF::Memory::Buffers::Local
+{
+	template<class T>
+	ScratchPool::Lease<T>::Lease(ScratchPool *pool, void *block, std::size_t sizeClass,
+		std::size_t size)
+		: m_pool(pool), m_block(block), m_sizeClass(sizeClass), m_size(size),
+		  m_data(reinterpret_cast<T*>(block))
+	{
+	}
+
+	template<class T>
+	ScratchPool::Lease<T>::Lease(Lease &&other)
+		: m_pool(other.m_pool), m_block(other.m_block), m_sizeClass(other.m_sizeClass),
+		  m_size(other.m_size), m_data(other.m_data)
+	{
+		other.m_block = nullptr;
+		other.m_size = 0;
+		other.m_data = nullptr;
+	}
+
+	template<class T>
+	ScratchPool::Lease<T>::~Lease()
+	{
+		if (m_block != nullptr) {
+			m_pool->give(m_block, m_sizeClass);
+		}
+	}
+
+	template<class T>
+	std::size_t ScratchPool::Lease<T>::getSize() const
+	{
+		return m_size;
+	}
+
+	template<class T>
+	SafePtr<T> ScratchPool::Lease<T>::accessData(std::size_t idx)
+	{
+#ifndef NDEBUG
+		return SafePtr<T>(m_data, m_data + m_size, m_data + idx);
+#else
+		return SafePtr<T>(m_data + idx);
+#endif // !NDEBUG
+	}
+
+	template<class T>
+	SafePtr<const T> ScratchPool::Lease<T>::accessData(std::size_t idx) const
+	{
+#ifndef NDEBUG
+		return SafePtr<const T>(m_data, m_data + m_size, m_data + idx);
+#else
+		return SafePtr<const T>(m_data + idx);
+#endif // !NDEBUG
+	}
+
+	inline ScratchPool::ScratchPool()
+		: m_stats { 0, 0, 0, 0, 0, 0 }
+	{
+	}
+
+	inline ScratchPool::~ScratchPool()
+	{
+		release();
+	}
+
+	template<class T>
+	ScratchPool::Lease<T> ScratchPool::borrow(std::size_t size)
+	{
+		static_assert(alignof(T) <= ALIGNMENT, "ScratchPool: type too strictly aligned");
+
+		std::size_t sizeClass;
+		void *block(take(size * sizeof(T), sizeClass));
+
+		return Lease<T>(this, block, sizeClass, size);
+	}
+
+	inline void ScratchPool::release()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		evict(0);
+	}
+
+	inline ScratchPool::Stats ScratchPool::getStats() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_stats;
+	}
+
+	// Private members.
+	inline std::size_t ScratchPool::getSizeClass(std::size_t bytes)
+	{
+		// Sizes are counted in cache lines. Up to 4 lines, each size is a class; past that, the
+		// classes between 4g and 8g lines go in steps of g, so there are four to each doubling.
+		std::size_t lines(std::max<std::size_t>((bytes + ALIGNMENT - 1) / ALIGNMENT, 1));
+		if (lines <= 4) {
+			return lines - 1;
+		}
+
+		std::size_t octave(2);
+		while ((std::size_t(8) << (octave - 2)) < lines) {
+			++octave;
+		}
+
+		std::size_t step(std::size_t(1) << (octave - 2));
+		return 4 + (4 * (octave - 2)) + (((lines + step - 1) / step) - 5);
+	}
+
+	inline std::size_t ScratchPool::getClassBytes(std::size_t sizeClass)
+	{
+		if (sizeClass < 4) {
+			return (sizeClass + 1) * ALIGNMENT;
+		}
+
+		std::size_t octave(2 + ((sizeClass - 4) / 4));
+		std::size_t steps(5 + ((sizeClass - 4) % 4));
+
+		return (steps << (octave - 2)) * ALIGNMENT;
+	}
+
+	inline void *ScratchPool::take(std::size_t bytes, std::size_t &sizeClass)
+	{
+		sizeClass = getSizeClass(bytes);
+		std::size_t blockBytes(getClassBytes(sizeClass));
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_stats.borrows;
+
+		std::size_t lastClass(std::min(sizeClass + REUSE_CLASSES, m_freeBlocks.size()));
+		for (std::size_t c(sizeClass); c < lastClass; ++c) {
+			if (!m_freeBlocks[c].empty()) {
+				void *block(m_freeBlocks[c].back());
+				m_freeBlocks[c].pop_back();
+
+				sizeClass = c;
+				m_stats.inUseBytes += getClassBytes(c);
+				m_stats.peakInUseBytes = std::max(m_stats.peakInUseBytes, m_stats.inUseBytes);
+				return block;
+			}
+		}
+
+		// Make room for the new block within the most ever lent out at once, counting this one.
+		m_stats.inUseBytes += blockBytes;
+		m_stats.peakInUseBytes = std::max(m_stats.peakInUseBytes, m_stats.inUseBytes);
+		evict(m_stats.peakInUseBytes - blockBytes);
+
+		void *block(::operator new(blockBytes, std::align_val_t(ALIGNMENT)));
+		++m_stats.allocations;
+		m_stats.heldBytes += blockBytes;
+		m_stats.peakHeldBytes = std::max(m_stats.peakHeldBytes, m_stats.heldBytes);
+
+		return block;
+	}
+
+	inline void ScratchPool::give(void *block, std::size_t sizeClass)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_freeBlocks.size() <= sizeClass) {
+			m_freeBlocks.resize(sizeClass + 1);
+		}
+
+		m_freeBlocks[sizeClass].push_back(block);
+		m_stats.inUseBytes -= getClassBytes(sizeClass);
+	}
+
+	inline void ScratchPool::evict(std::size_t heldBytes)
+	{
+		for (std::size_t c(m_freeBlocks.size()); (c-- > 0) && (m_stats.heldBytes > heldBytes);) {
+			while (!m_freeBlocks[c].empty() && (m_stats.heldBytes > heldBytes)) {
+				freeBlock(m_freeBlocks[c].back());
+				m_freeBlocks[c].pop_back();
+				m_stats.heldBytes -= getClassBytes(c);
+			}
+		}
+	}
+
+	inline void ScratchPool::freeBlock(void *block)
+	{
+		::operator delete(block, std::align_val_t(ALIGNMENT));
+	}
+}
+
+#endif /* SRC_MEMORY_BUFFERS_LOCAL_SCRATCHPOOL_TPP_ */
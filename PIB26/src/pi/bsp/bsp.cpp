@@ -24,10 +24,13 @@
 
 #include "bsp.hpp"
 
+#include "../../bignum/PreparedOperand.hpp"
+
 #include "../../memory/buffers/local/RAMOnly.hpp"
 
 #include "../../util/DotsTicker.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 namespace SDF::Pi::BSP
@@ -132,11 +135,19 @@ namespace SDF::Pi::BSP
 			//std::cout << "QQ est: " << estimateQPrec(m, b) << " act: " << Rout.Q->getDgsUsed() << std::endl;
 			//std::cout << "RR est: " << estimateRPrec(m, b) << " act: " << Rout.R->getDgsUsed() << std::endl;
 
-			m_tmpBigInt->mul(*Rout.P, *Lout.R, *m_multiplicationStrategy);
-			out.P->mul(*Lout.P, *Rout.Q, *m_multiplicationStrategy);
+			// Lout.R and Rout.Q each go into two products, so prepare them once for both. The
+			// products into m_tmpBigInt must come first, as out.P overlaps Rout.P.
+			std::unique_ptr<PreparedOperand> preparedR(Lout.R->prepare(*m_multiplicationStrategy,
+				std::max(Rout.P->getDgsUsed(), Rout.R->getDgsUsed())));
+			m_tmpBigInt->mul(*Rout.P, *Lout.R, *preparedR, *m_multiplicationStrategy);
+			out.R->mul(*Lout.R, *Rout.R, *preparedR, *m_multiplicationStrategy);
+			preparedR.reset();
+
+			std::unique_ptr<PreparedOperand> preparedQ(Rout.Q->prepare(*m_multiplicationStrategy,
+				std::max(Lout.P->getDgsUsed(), Lout.Q->getDgsUsed())));
+			out.P->mul(*Lout.P, *Rout.Q, *preparedQ, *m_multiplicationStrategy);
 			out.P->addIp(*m_tmpBigInt);
-			out.Q->mul(*Lout.Q, *Rout.Q, *m_multiplicationStrategy);
-			out.R->mul(*Lout.R, *Rout.R, *m_multiplicationStrategy);
+			out.Q->mul(*Lout.Q, *Rout.Q, *preparedQ, *m_multiplicationStrategy);
 		}
 
 		//std::cout << "P(" << a << ", " << b << ") = " << out.P->print() << std::endl;
@@ -181,11 +192,18 @@ namespace SDF::Pi::BSP
 			ticker.printTicker();
 
 			BSP::SmallOutput out(BSP::smallCompute(pWorkPtr, qWorkPtr, rWorkPtr, aCur, bCur, &ticker));
-			P.mul(P, *out.Q, *m_multiplicationStrategy);
-			m_tmpBigFloat->mul(R, *out.P, *m_multiplicationStrategy);
+			// R and out.Q each go into two products, so prepare them once for both.
+			std::unique_ptr<PreparedOperand> preparedR(R.prepare(*m_multiplicationStrategy,
+				std::max(out.P->getDgsUsed(), out.R->getDgsUsed())));
+			m_tmpBigFloat->mul(R, *out.P, *preparedR, *m_multiplicationStrategy);
+			R.mul(R, *out.R, *preparedR, *m_multiplicationStrategy);
+			preparedR.reset();
+
+			std::unique_ptr<PreparedOperand> preparedQ(out.Q->prepare(*m_multiplicationStrategy,
+				BigFloat::getBufferSize(std::max(P.getPrecision(), Q.getPrecision()))));
+			P.mul(P, *out.Q, *preparedQ, *m_multiplicationStrategy);
 			P.addIp(*m_tmpBigFloat);
-			Q.mul(Q, *out.Q, *m_multiplicationStrategy);
-			R.mul(R, *out.R, *m_multiplicationStrategy);
+			Q.mul(Q, *out.Q, *preparedQ, *m_multiplicationStrategy);
 
 			ticker.finishTicker();
 		}
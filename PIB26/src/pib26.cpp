@@ -25,8 +25,12 @@
 #include "bignum/multiplication/ClassicalSmallMul.hpp"
 #include "bignum/multiplication/SmallKaratsuba.hpp"
 #include "bignum/multiplication/FFT.hpp"
-#include "bignum/multiplication/FlexMul3.hpp"
+#include "bignum/multiplication/NTT.hpp"
+#include "bignum/multiplication/SSA.hpp"
 #include "bignum/multiplication/FlexMul2.hpp"
+#include "bignum/multiplication/FlexMulN.hpp"
+#include "bignum/multiplication/FlexTuner.hpp"
+#include "bignum/multiplication/ToomCook.hpp"
 
 #include "bignum/BigFloat.hpp"
 #include "bignum/BigInt.hpp"
@@ -34,6 +38,9 @@
 #include "pi/bsp/bsp.hpp"
 #include "pi/bsp/chudnovsky.hpp"
 
+#include "memory/buffers/local/ScratchPool.hpp"
+
+#include "util/ThreadPool.hpp"
 #include "util/timer.hpp"
 #include "util/userInput.hpp"
 
@@ -42,6 +49,8 @@
 #include <iostream>
 #include <iomanip>
 #include <memory>
+#include <string>
+#include <thread>
 #include <time.h>
 
 // Function:  main
@@ -57,18 +66,32 @@ int main(int argc, char **argv)
 		std::cout << "PIB26 version 0.0.2" << std::endl;
 		std::cout << std::endl;
 
+		// "--calibrate" times the multiplication methods again even if there is a profile for them.
+		bool wantCalibrate(false);
+		for (int arg(1); arg < argc; ++arg) {
+			if (std::string(argv[arg]) == "--calibrate") {
+				wantCalibrate = true;
+			}
+		}
+
 		std::size_t numDigits = Util::getUserNumericInput("Enter number of digits to compute", 100,
 			64000000);
 		std::cout << std::endl;
 
-		/*
-		 bool wantParallel = Util::getUserYNInput("Do you want to use parallel processing");
-		 int numThreads;
-		 if(wantParallel) {
-		 numThreads = Util::getUserNumericInput("Enter number of threads to use", 1, 4);
-		 }
-		 std::cout << std::endl;
-		 */
+		std::cout << "Large multiplication methods:" << std::endl;
+		std::cout << "   1. Complex FFT" << std::endl;
+		std::cout << "   2. Number-theoretic transform (NTT)" << std::endl;
+		std::cout << "   3. Schonhage-Strassen, over complex FFT (slower; for testing)" << std::endl;
+		int largeMethod = Util::getUserNumericInput("Select large multiplication method", 1, 3);
+		std::cout << std::endl;
+
+		bool wantParallel = Util::getUserYNInput("Do you want to use parallel processing");
+		int numThreads(1);
+		if(wantParallel) {
+			int maxThreads(std::max(1u, std::thread::hardware_concurrency()));
+			numThreads = Util::getUserNumericInput("Enter number of threads to use", 1, maxThreads);
+		}
+		std::cout << std::endl;
 
 		struct timespec startTime, endTime;
 
@@ -76,12 +99,77 @@ int main(int argc, char **argv)
 
 		std::cout << "Allocating memory..." << std::endl;
 
-		Bignum::Multiplication::ClassicalSmallMul smallStrategy(1024);
-		Bignum::Multiplication::SmallKaratsuba medStrategy(16384);
-		Bignum::Multiplication::FFT largeStrategy(
-			std::max<std::size_t>(16384, 2 * numDigits / Bignum::DIGS_PER_DIG) + 16);
-		Bignum::Multiplication::FlexMul3 flexStrategy(&smallStrategy, &medStrategy, &largeStrategy,
-			8, 56);
+		Util::ThreadPool threadPool(numThreads);
+
+		// All the strategies borrow their scratch space from the one pool, so it only takes up
+		// what the largest multiply going needs.
+		Memory::Buffers::Local::ScratchPool scratchPool;
+
+		Bignum::Multiplication::ClassicalSmallMul smallStrategy(1024, &scratchPool);
+		Bignum::Multiplication::SmallKaratsuba medStrategy(16384, &scratchPool);
+		std::size_t maxProdSize(std::max<std::size_t>(16384, 2 * numDigits / Bignum::DIGS_PER_DIG) + 16);
+		std::unique_ptr<Bignum::IMultiplicationStrategy> baseStrategy;
+		std::unique_ptr<Bignum::IMultiplicationStrategy> largeStrategy;
+		Bignum::Multiplication::FFT *fftStrategy(nullptr);
+		if (largeMethod == 2) {
+			largeStrategy = std::make_unique<Bignum::Multiplication::NTT>(maxProdSize, &scratchPool);
+		} else if (largeMethod == 3) {
+			// SSA::DEFAULT_CROSSOVER is beyond the longest product we allow, which would leave SSA
+			// handing everything to the FFT, so SSA takes over from 2^16 digits of product (a pi
+			// of about 130,000 digits) instead. It is slower than the FFT alone there, but this is
+			// what lets it be run and checked at all. The FFT only ever sees products below the
+			// crossover.
+			const std::size_t ssaCrossover(65536);
+			std::unique_ptr<Bignum::Multiplication::FFT> fft(
+				std::make_unique<Bignum::Multiplication::FFT>(std::min(maxProdSize, ssaCrossover),
+					&threadPool, &scratchPool));
+			fftStrategy = fft.get();
+			baseStrategy = std::move(fft);
+			largeStrategy = std::make_unique<Bignum::Multiplication::SSA>(baseStrategy.get(),
+				ssaCrossover, maxProdSize, &scratchPool);
+		} else {
+			std::unique_ptr<Bignum::Multiplication::FFT> fft(
+				std::make_unique<Bignum::Multiplication::FFT>(maxProdSize, &threadPool,
+					&scratchPool));
+			fftStrategy = fft.get();
+			largeStrategy = std::move(fft);
+		}
+
+		// The Toom-Cook tiers hand off to Karatsuba, and Toom-4 to Toom-3, at fixed lengths of
+		// their own; it is only where the flex strategy switches between the tiers that is tuned.
+		Bignum::Multiplication::FlexMul2 karatsubaStrategy(&smallStrategy, &medStrategy, 8);
+		Bignum::Multiplication::Toom3 toom3Strategy(&karatsubaStrategy, 384, maxProdSize,
+			&scratchPool);
+		Bignum::Multiplication::Toom4 toom4Strategy(&toom3Strategy, 4096, maxProdSize,
+			&scratchPool);
+
+		// Find where to switch between the tiers on this machine, from the profile saved by an
+		// earlier run if there is one for it, or else by timing them now. The defaults, should
+		// neither be had, hand everything from 56 digits on to the transform, as that measured
+		// faster than all the others on the machines tried.
+		const char *largeName((largeMethod == 2) ? "ntt" : ((largeMethod == 3) ? "ssa" : "fft"));
+		Bignum::Multiplication::FlexTuner tuner(Bignum::Multiplication::FlexTuner::PROFILE_FILE, {
+			{ "classical", &smallStrategy, 1024 }, { "karatsuba", &medStrategy, 16384 },
+			{ "toom3", &toom3Strategy, maxProdSize }, { "toom4", &toom4Strategy, maxProdSize },
+			{ largeName, largeStrategy.get(), maxProdSize } }, numThreads);
+		std::vector<std::size_t> overrideLens { 8, 56, 56, 56 };
+		if (wantCalibrate || !tuner.getOverrideLens(maxProdSize, overrideLens)) {
+			std::cout << "Timing the multiplication methods..." << std::endl;
+			overrideLens = tuner.calibrate(maxProdSize);
+
+			// The timing is not part of the computation.
+			clock_gettime(CLOCK_REALTIME, &startTime);
+		}
+
+		std::cout << "Multiplication crossovers (product lengths):";
+		for (std::size_t len : overrideLens) {
+			std::cout << " " << len;
+		}
+
+		std::cout << std::endl;
+
+		Bignum::Multiplication::FlexMulN flexStrategy( { &smallStrategy, &medStrategy,
+			&toom3Strategy, &toom4Strategy, largeStrategy.get() }, overrideLens);
 		Pi::BSP::Chudnovsky chudnovsky(&flexStrategy);
 
 		std::cout << "Done." << std::endl;
@@ -98,6 +186,49 @@ int main(int argc, char **argv)
 		std::cout << "Total computation time: " << Util::timeDiffMillis(endTime, startTime) << " ms."
 			<< std::endl;
 
+		// Report how much scratch space the multiplications took.
+		Memory::Buffers::Local::ScratchPool::Stats scratchStats(scratchPool.getStats());
+		std::cout << "Multiplication scratch: peak " << (scratchStats.peakInUseBytes + 1023) / 1024
+			<< " KB in use, " << (scratchStats.peakHeldBytes + 1023) / 1024 << " KB held; "
+			<< scratchStats.allocations << " of " << scratchStats.borrows
+			<< " buffers newly allocated." << std::endl;
+
+		if (fftStrategy != nullptr) {
+			// Report the FFT round-off error for each size of product, by digits per element.
+			std::cout << std::endl;
+			std::cout << "FFT round-off error (products: largest error at 2/3/4 digits per element):"
+				<< std::endl;
+			for (std::size_t k(0); k < Bignum::Multiplication::FFT::NUM_SIZE_CLASSES; ++k) {
+				Bignum::Multiplication::FFT::RoundOffStats stats(
+					fftStrategy->getRoundOffStats(k));
+				std::size_t products(0);
+				for (std::size_t smalls(0); smalls <= Bignum::DIGS_PER_DIG; ++smalls) {
+					products += stats.products[smalls];
+				}
+
+				if (products == 0) {
+					continue;
+				}
+
+				std::cout << "   " << std::setw(10) << (std::size_t(1) << k) << "+ Digits: "
+					<< std::setw(6) << products << " products:";
+				for (std::size_t smalls(2); smalls <= Bignum::DIGS_PER_DIG; ++smalls) {
+					std::cout << "  ";
+					if (stats.products[smalls] != 0) {
+						std::cout << std::fixed << std::setprecision(4) << stats.maxError[smalls];
+					} else {
+						std::cout << "  -   ";
+					}
+				}
+
+				if (stats.retries != 0) {
+					std::cout << "  (" << stats.retries << " redone)";
+				}
+
+				std::cout << std::endl;
+			}
+		}
+
 		return 0;
 	} catch (std::exception &e) {
 		std::cout << "ERROR: " << e.what() << ". This error was not handled anywhere else. Aborting."
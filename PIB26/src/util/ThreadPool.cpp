@@ -0,0 +1,180 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      ThreadPool.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ThreadPool.hpp"
+
+namespace SDF::Util {
+	namespace {
+		// The number of the pool thread we are on; 0 for any thread outside the pool.
+		thread_local std::size_t t_thread(0);
+	}
+
+	ThreadPool::ThreadPool(std::size_t numThreads)
+		: m_numThreads((numThreads < 1) ? 1 : numThreads), m_stopping(false)
+	{
+		for (std::size_t thread(1); thread < m_numThreads; ++thread) {
+			m_workers.emplace_back(&ThreadPool::workerLoop, this, thread);
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+
+		m_workAvailable.notify_all();
+		for (std::thread &worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	std::size_t ThreadPool::getNumThreads() const {
+		return m_numThreads;
+	}
+
+	void ThreadPool::parallelFor(std::size_t count,
+		const std::function<void(std::size_t, std::size_t)> &task)
+	{
+		if (count == 0) {
+			return;
+		}
+
+		if (m_workers.empty() || (count == 1)) {
+			for (std::size_t idx(0); idx < count; ++idx) {
+				task(idx, t_thread);
+			}
+
+			return;
+		}
+
+		Job job { &task, count, 0, 0, nullptr };
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_jobs.push_back(&job);
+		std::size_t idx(job.next++);
+		lock.unlock();
+		m_workAvailable.notify_all();
+
+		runIndices(job, idx, t_thread);
+
+		lock.lock();
+		m_jobs.remove(&job);
+		m_jobFinished.wait(lock, [&job] { return job.done == job.count; });
+		lock.unlock();
+
+		if (job.error) {
+			std::rethrow_exception(job.error);
+		}
+	}
+
+	void ThreadPool::parallelForRange(std::size_t len, std::size_t grain,
+		const std::function<void(std::size_t, std::size_t, std::size_t)> &task)
+	{
+		if (grain == 0) {
+			grain = 1;
+		}
+
+		// A few chunks per thread evens out the load.
+		std::size_t numGrains((len + grain - 1) / grain);
+		std::size_t numChunks(4 * m_numThreads);
+		if (numChunks > numGrains) {
+			numChunks = numGrains;
+		}
+
+		if (numChunks <= 1) {
+			if (len != 0) {
+				task(0, len, t_thread);
+			}
+
+			return;
+		}
+
+		std::size_t chunkLen(((numGrains + numChunks - 1) / numChunks) * grain);
+		numChunks = (len + chunkLen - 1) / chunkLen;
+		parallelFor(numChunks, [&](std::size_t chunk, std::size_t thread) {
+			std::size_t begin(chunk * chunkLen);
+			std::size_t end((begin + chunkLen < len) ? begin + chunkLen : len);
+			task(begin, end, thread);
+		});
+	}
+
+	void ThreadPool::workerLoop(std::size_t thread) {
+		t_thread = thread;
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;) {
+			Job *job(nullptr);
+			std::size_t idx(0);
+			m_workAvailable.wait(lock, [&] {
+				if (m_stopping) {
+					return true;
+				}
+
+				for (Job *candidate : m_jobs) {
+					if (candidate->next < candidate->count) {
+						job = candidate;
+						idx = job->next++;
+						return true;
+					}
+				}
+
+				return false;
+			});
+
+			if (job == nullptr) {
+				return; // stopping
+			}
+
+			lock.unlock();
+			runIndices(*job, idx, thread);
+			lock.lock();
+		}
+	}
+
+	void ThreadPool::runIndices(Job &job, std::size_t idx, std::size_t thread) {
+		bool claimed(idx < job.count);
+		while (claimed) {
+			std::exception_ptr error;
+			try {
+				(*job.task)(idx, thread);
+			} catch (...) {
+				error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (error && !job.error) {
+				job.error = error;
+			}
+
+			if (++job.done == job.count) {
+				m_jobFinished.notify_all();
+			}
+
+			// Once the lock is released, the job must not be touched unless we hold an index.
+			idx = job.next++;
+			claimed = (idx < job.count);
+		}
+	}
+}
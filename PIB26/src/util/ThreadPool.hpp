@@ -0,0 +1,117 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      ThreadPool.hpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SRC_UTIL_THREADPOOL_HPP_
+#define SRC_UTIL_THREADPOOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SDF::Util {
+	// Class:   ThreadPool
+	// Purpose: Provides a fixed pool of worker threads to run loops in parallel on. The thread
+	//          calling into the pool works on the loop too, so a pool of one thread has no workers
+	//          and runs everything directly. Loops may be nested: a task can run a parallel loop of
+	//          its own, which any idle workers will then help with.
+	class ThreadPool {
+		public:
+			// Function:  ThreadPool
+			// Purpose:   Construct a new pool and start its workers.
+			// Arguments: numThreads - The total number of threads to run loops on, counting the
+			//                         calling thread.
+			ThreadPool(std::size_t numThreads);
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool &) = delete;
+			ThreadPool &operator=(const ThreadPool &) = delete;
+
+			// Function:   getNumThreads
+			// Purpose:    Get the number of threads loops are run on.
+			// Parameters: None.
+			// Returns:    The number of threads, counting the calling thread.
+			std::size_t getNumThreads() const;
+
+			// Function:   parallelFor
+			// Purpose:    Run a task for each index in a range, in parallel, and wait for all of
+			//             them to finish. If any of them throws, the first exception is rethrown
+			//             here once the rest are done.
+			// Parameters: count - The number of indices, 0 to count - 1.
+			//             task - The task. It receives the index and the number, less than
+			//                    getNumThreads(), of the thread running it, for use as a slot in
+			//                    per-thread scratch space.
+			// Returns:    None.
+			void parallelFor(std::size_t count,
+				const std::function<void(std::size_t, std::size_t)> &task);
+
+			// Function:   parallelForRange
+			// Purpose:    Split a range into chunks and run a task on each chunk, in parallel.
+			// Parameters: len - The length of the range, 0 to len - 1.
+			//             grain - Chunks begin on a multiple of this, and are no shorter than it.
+			//             task - The task. It receives the beginning and end of its chunk and the
+			//                    number of the thread running it, as with parallelFor.
+			// Returns:    None.
+			void parallelForRange(std::size_t len, std::size_t grain,
+				const std::function<void(std::size_t, std::size_t, std::size_t)> &task);
+		private:
+			// A loop in progress.
+			struct Job {
+				const std::function<void(std::size_t, std::size_t)> *task;
+				std::size_t count;
+				// The rest are guarded by m_mutex.
+				std::size_t next; // next index to claim
+				std::size_t done; // indices finished
+				std::exception_ptr error; // first exception thrown
+			};
+
+			std::size_t m_numThreads;
+			std::vector<std::thread> m_workers;
+
+			std::mutex m_mutex;
+			std::condition_variable m_workAvailable;
+			std::condition_variable m_jobFinished;
+			std::list<Job *> m_jobs; // jobs that may still have indices to claim
+			bool m_stopping;
+
+			void workerLoop(std::size_t thread);
+
+			// Function:   runIndices
+			// Purpose:    Run an index claimed from a job, then claim and run more until there are
+			//             none left. Once the last index finishes, the job may go away at any
+			//             moment, so each claim is made under the same lock as the finish before
+			//             it.
+			// Parameters: job - The job.
+			//             idx - The index already claimed.
+			//             thread - The number of the thread doing this.
+			// Returns:    None.
+			void runIndices(Job &job, std::size_t idx, std::size_t thread);
+	};
+}
+
+#endif /* SRC_UTIL_THREADPOOL_HPP_ */
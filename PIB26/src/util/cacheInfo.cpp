@@ -0,0 +1,118 @@
+/*
+ * PIB26 version 0.0.2
+ * (C) 2020-2021 Shimrra Shai.
+ * 
+ * File:      cacheInfo.cpp
+ * Timestamp: Oct 17, 2026
+ *
+ */
+
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cacheInfo.hpp"
+
+#include <fstream>
+#include <string>
+
+namespace SDF::Util {
+	namespace {
+		// Defaults for when sysfs is unavailable, sized for a modest desktop CPU.
+		static const std::size_t c_defaultL1 = 32768;
+		static const std::size_t c_defaultL2 = 262144;
+		static const std::size_t c_defaultL3 = 4194304;
+		static const std::size_t c_defaultLineSize = 64;
+
+		// Function:   readSysfsValue
+		// Purpose:    Read the first token of a sysfs file.
+		// Parameters: path - The file to read.
+		//             value - Receives the token.
+		// Returns:    Whether the file could be read.
+		bool readSysfsValue(const std::string &path, std::string &value) {
+			std::ifstream file(path);
+			return static_cast<bool>(file >> value);
+		}
+
+		// Function:   parseSize
+		// Purpose:    Parse a sysfs cache size such as "48K" or "2048K" into bytes.
+		// Parameters: text - The text to parse.
+		// Returns:    The size in bytes, or 0 if it could not be parsed.
+		std::size_t parseSize(const std::string &text) {
+			std::size_t size(0);
+			std::size_t i(0);
+			while ((i < text.size()) && (text[i] >= '0') && (text[i] <= '9')) {
+				size = size * 10 + (text[i] - '0');
+				++i;
+			}
+
+			if (i < text.size()) {
+				switch (text[i]) {
+					case 'K': size <<= 10; break;
+					case 'M': size <<= 20; break;
+					case 'G': size <<= 30; break;
+					default: break;
+				}
+			}
+
+			return size;
+		}
+
+		CacheSizes detectCacheSizes() {
+			CacheSizes sizes { 0, 0, 0, 0 };
+
+			for (int index = 0; ; ++index) {
+				std::string dir("/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index)
+					+ "/");
+				std::string level, type, size, lineSize;
+				if (!readSysfsValue(dir + "level", level)) {
+					break;
+				}
+
+				if (!readSysfsValue(dir + "type", type) || !readSysfsValue(dir + "size", size)) {
+					continue;
+				}
+
+				// Instruction caches are no use to us.
+				if (type == "Instruction") {
+					continue;
+				}
+
+				if (readSysfsValue(dir + "coherency_line_size", lineSize)) {
+					sizes.lineSize = parseSize(lineSize);
+				}
+
+				if (level == "1") {
+					sizes.l1 = parseSize(size);
+				} else if (level == "2") {
+					sizes.l2 = parseSize(size);
+				} else if (level == "3") {
+					sizes.l3 = parseSize(size);
+				}
+			}
+
+			if (sizes.l1 == 0) sizes.l1 = c_defaultL1;
+			if (sizes.l2 == 0) sizes.l2 = c_defaultL2;
+			if (sizes.l3 == 0) sizes.l3 = (sizes.l2 > c_defaultL3) ? sizes.l2 : c_defaultL3;
+			if (sizes.lineSize == 0) sizes.lineSize = c_defaultLineSize;
+
+			return sizes;
+		}
+	}
+
+	const CacheSizes &getCacheSizes() {
+		static const CacheSizes sizes(detectCacheSizes());
+		return sizes;
+	}
+}
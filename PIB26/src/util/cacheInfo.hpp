@@ -2,8 +2,8 @@
  * PIB26 version 0.0.2
  * (C) 2020-2021 Shimrra Shai.
  * 
- * File:      genOmegaTable.hpp
- * Timestamp: Mar 28, 2021
+ * File:      cacheInfo.hpp
+ * Timestamp: Oct 17, 2026
  *
  */
 
@@ -21,23 +21,29 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
-#ifndef SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_GENOMEGATABLE_HPP_
-#define SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_GENOMEGATABLE_HPP_
 
-#include "../../../../memory/ILocalBuffer.hpp"
-
-#include "Cplex.hpp"
+#ifndef SRC_UTIL_CACHEINFO_HPP_
+#define SRC_UTIL_CACHEINFO_HPP_
 
 #include <cstddef>
-#include <memory>
 
-namespace SDF::Bignum::Multiplication::Fft::Complex {
-	// Function:   genOmegaTable
-	// Purpose:    Generate the complex roots of unity (omega) table for FFT sizes up to a given
-	//             size.
-	// Parameters: length - The length of table to generate.
-	// Returns:    The newly-generated omega table.
-	std::unique_ptr<Memory::ILocalBuffer<Cplex>> genOmegaTable(std::size_t length);
+namespace SDF::Util {
+	// Struct:  CacheSizes
+	// Purpose: Holds the sizes, in bytes, of the CPU data caches.
+	struct CacheSizes {
+		std::size_t l1;
+		std::size_t l2;
+		std::size_t l3;
+		std::size_t lineSize;
+	};
+
+	// Function:   getCacheSizes
+	// Purpose:    Get the cache sizes of the CPU we are running on. These are read from sysfs the
+	//             first time this is called; any level that can't be read gets a conservative
+	//             default.
+	// Parameters: None.
+	// Returns:    The cache sizes.
+	const CacheSizes &getCacheSizes();
 }
 
-#endif /* SRC_BIGNUM_MULTIPLICATION_FFT_COMPLEX_GENOMEGATABLE_HPP_ */
+#endif /* SRC_UTIL_CACHEINFO_HPP_ */